@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+// Minimal benchmark harness for bottle_bench (results are written as JSON)
+
+class BenchState {
+private:
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point startTime{};
+    double elapsed = 0.0;
+    bool timing = false;
+    bool manual = false;
+
+public:
+    uint64_t iterations = 1;       // body must run its loop this many times
+    uint64_t itemsPerIteration = 0;
+    uint64_t bytesPerIteration = 0;
+    std::string skipReason{};
+
+    // Optional: call around measured part when benchmark has setup / teardown
+    void begin() { manual = true; timing = true; startTime = Clock::now(); }
+    void end() {
+        if (timing){
+            elapsed += std::chrono::duration<double>(Clock::now() - startTime).count();
+            timing = false;
+        }
+    }
+
+    void skip(const std::string& reason) { skipReason = reason; }
+
+    // used by runner
+    void reset() { elapsed = 0.0; timing = false; manual = false; }
+    bool manualTiming() const { return manual; }
+    double seconds() const { return elapsed; }
+};
+
+using BenchFunction = std::function<void(BenchState& state)>;
+
+struct BenchCase {
+    std::string name;
+    BenchFunction function;
+};
+
+std::vector<BenchCase>& benchRegistry();
+
+struct BenchRegistration {
+    BenchRegistration(const char* name, BenchFunction function){
+        benchRegistry().push_back({name, function});
+    }
+};
+
+#define BOTTLE_BENCH(name) \
+    static void bench_##name(BenchState& state); \
+    static BenchRegistration registration_##name{#name, bench_##name}; \
+    static void bench_##name(BenchState& state)
+
+// keeps compiler from removing benchmarked work
+template<typename T>
+inline void doNotOptimize(T const& value){
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
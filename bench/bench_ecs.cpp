@@ -0,0 +1,194 @@
+#include "bench.hpp"
+#include "../src/animation/animationBehaviour.hpp"
+#include "../src/ecs/SparseSet.hpp"
+#include <memory>
+#include <cmath>
+
+// Part iteration as Behaviours do it: vector of Part pointers
+struct TransformPart {
+    float position[3];
+    float velocity[3];
+};
+
+BOTTLE_BENCH(part_iteration_10k){
+    std::vector<std::unique_ptr<TransformPart>> storage{};
+    std::vector<TransformPart*> components{};
+    for (int i = 0; i < 10000; i++){
+        storage.push_back(std::make_unique<TransformPart>(TransformPart{{0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f}}));
+        components.push_back(storage.back().get());
+    }
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (TransformPart* part : components){
+            for (int k = 0; k < 3; k++){
+                part->position[k] += part->velocity[k] * 0.016f;
+            }
+        }
+        doNotOptimize(components.front()->position[0]);
+    }
+    state.end();
+    state.itemsPerIteration = components.size();
+}
+
+// Same update over packed sparse set storage
+BOTTLE_BENCH(sparse_set_iteration_10k){
+    CreatureRegistry<> creatures{};
+    SparseSet<TransformPart> parts{};
+    for (int i = 0; i < 10000; i++){
+        parts.add(creatures.create(), TransformPart{{0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f}});
+    }
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (TransformPart& part : parts){
+            for (int k = 0; k < 3; k++){
+                part.position[k] += part.velocity[k] * 0.016f;
+            }
+        }
+        doNotOptimize(parts.data()[0].position[0]);
+    }
+    state.end();
+    state.itemsPerIteration = parts.size();
+}
+
+BOTTLE_BENCH(sparse_set_lookup_10k){
+    CreatureRegistry<> creatures{};
+    SparseSet<TransformPart> parts{};
+    std::vector<Creature> handles{};
+    for (int i = 0; i < 10000; i++){
+        handles.push_back(creatures.create());
+        parts.add(handles.back(), TransformPart{});
+    }
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (Creature creature : handles){
+            doNotOptimize(parts.get(creature));
+        }
+    }
+    state.end();
+    state.itemsPerIteration = handles.size();
+}
+
+BOTTLE_BENCH(sparse_set_add_remove_10k){
+    CreatureRegistry<> creatures{};
+    SparseSet<TransformPart> parts{};
+    std::vector<Creature> handles{};
+    for (int i = 0; i < 10000; i++){
+        handles.push_back(creatures.create());
+    }
+    parts.reserve(handles.size());
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (Creature creature : handles){
+            parts.add(creature, TransformPart{});
+        }
+        for (Creature creature : handles){
+            parts.remove(creature);
+        }
+    }
+    state.end();
+    state.itemsPerIteration = handles.size() * 2;
+}
+
+// Derived data of mostly static scene: 1% of Parts modified per frame, reader visits changed ones
+BOTTLE_BENCH(sparse_set_changed_100k){
+    CreatureRegistry<> creatures{};
+    SparseSet<TransformPart> parts{};
+    std::vector<Creature> handles{};
+    for (int i = 0; i < 100000; i++){
+        handles.push_back(creatures.create());
+        parts.add(handles.back(), TransformPart{{0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f}});
+    }
+    std::vector<float> derived(parts.size(), 0.0f);
+    ChangeTick lastRun = parts.advanceTick();
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (size_t i = it % 100; i < handles.size(); i += 100){
+            parts.modify(handles[i])->position[0] += 1.0f;
+        }
+        ChangeTick since = lastRun;
+        lastRun = parts.advanceTick();
+        parts.forEachChanged(since, [&](uint32_t slot){
+            const TransformPart& part = parts.data()[slot];
+            derived[slot] = part.position[0] + part.position[1] + part.position[2];
+        });
+        doNotOptimize(derived[0]);
+    }
+    state.end();
+    state.itemsPerIteration = parts.size();
+}
+
+// Creatures destroyed without removing their Part, handles recycled and added again
+// (correctness: tests/test_ecs.cpp)
+BOTTLE_BENCH(sparse_set_recycle_10k){
+    CreatureRegistry<> creatures{};
+    SparseSet<TransformPart> parts{};
+    std::vector<Creature> handles{};
+    for (int i = 0; i < 10000; i++){
+        handles.push_back(creatures.create());
+        parts.add(handles.back(), TransformPart{});
+    }
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (Creature& creature : handles){
+            creatures.destroy(creature);
+            creature = creatures.create();
+            parts.add(creature, TransformPart{});
+        }
+    }
+    state.end();
+    state.itemsPerIteration = handles.size();
+}
+
+static void makeAnimation(Skeleton& skeleton, AnimationClip& clip, uint32_t joints){
+    skeleton.jointCount = joints;
+    skeleton.parents.resize(joints);
+    skeleton.inverseBind.assign(joints * 16, 0.0f);
+    for (uint32_t j = 0; j < joints; j++){
+        skeleton.parents[j] = static_cast<int16_t>(j) - 1;
+        for (int k = 0; k < 4; k++){
+            skeleton.inverseBind[j * 16 + k * 5] = 1.0f;
+        }
+    }
+
+    clip = AnimationClip(joints, 30, 30.0f);
+    for (uint32_t f = 0; f < clip.frameCount; f++){
+        float* frame = clip.frame(f);
+        for (uint32_t j = 0; j < joints; j++){
+            float angle = 0.05f * f;
+            frame[TY * clip.stride + j] = 1.0f;
+            frame[RZ * clip.stride + j] = std::sin(angle * 0.5f);
+            frame[RW * clip.stride + j] = std::cos(angle * 0.5f);
+            frame[SX * clip.stride + j] = frame[SY * clip.stride + j] = frame[SZ * clip.stride + j] = 1.0f;
+        }
+    }
+}
+
+BOTTLE_BENCH(animation_behaviour_update_1k_64_joints){
+    Skeleton skeleton{};
+    AnimationClip clip{};
+    makeAnimation(skeleton, clip, 64);
+
+    JobPool jobs{};
+    AnimationBehaviour behaviour{&jobs};
+    std::vector<std::unique_ptr<AnimationPart>> parts{};
+    for (int i = 0; i < 1000; i++){
+        parts.push_back(std::make_unique<AnimationPart>(&skeleton, &clip));
+        parts.back()->clips[1] = &clip;
+        parts.back()->blend = 0.5f;
+        behaviour.add(parts.back().get());
+    }
+    behaviour.setDeltaTime(1.0f / 60.0f);
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        behaviour.update();
+    }
+    state.end();
+    state.itemsPerIteration = parts.size();
+}
@@ -0,0 +1,101 @@
+#include "bench.hpp"
+#include "../src/event/eventBehavior.hpp"
+
+BOTTLE_BENCH(event_emit_8_callbacks){
+    Event event{};
+    uint64_t counter = 0;
+    for (int i = 0; i < 8; i++){
+        event.add([&counter]{ counter++; });
+    }
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        event.emit();
+    }
+    state.end();
+    doNotOptimize(counter);
+    state.itemsPerIteration = 8;
+}
+
+BOTTLE_BENCH(event_subscribe_1k){
+    uint64_t counter = 0;
+    for (uint64_t it = 0; it < state.iterations; it++){
+        EventBehaviour events{};
+        events.register_event("resize");
+        for (int i = 0; i < 1000; i++){
+            events.subscribe("resize", [&counter]{ counter++; });
+        }
+        doNotOptimize(events);
+    }
+    state.itemsPerIteration = 1000;
+}
+
+// 1000 mouse motions, 200 resizes and 4096 Part changes (1024 distinct) per frame, coalesced to 1 + 1 + 1024 deliveries
+BOTTLE_BENCH(event_coalesce_frame){
+    EventBehaviour events{};
+    events.register_event("mouse_motion", EventCoalesce::ACCUMULATE, EventPriority::HIGH);
+    events.register_event("resize", EventCoalesce::KEEP_LATEST, EventPriority::HIGH);
+    events.register_event("part_changed", EventCoalesce::DEDUPE_KEY, EventPriority::LOW);
+
+    float motion = 0.0f;
+    uint32_t rebuilds = 0;
+    uint64_t changed = 0;
+    events.subscribe("mouse_motion", [&motion](const EventArgs& args){ motion += args.values[0]; });
+    events.subscribe("resize", [&rebuilds]{ rebuilds++; });
+    events.subscribe("part_changed", [&changed](const EventArgs& args){ changed += args.key; });
+
+    const EventTrigger mouseMotion = "mouse_motion";
+    const EventTrigger resize = "resize";
+    const EventTrigger partChanged = "part_changed";
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        EventArgs args{};
+        for (uint32_t i = 0; i < 1000; i++){
+            args.values[0] = 1.0f;
+            events.enqueue(mouseMotion, args);
+        }
+        for (uint32_t i = 0; i < 200; i++){
+            args.values[0] = float(800 + i);
+            args.values[1] = 600.0f;
+            events.enqueue(resize, args);
+        }
+        for (uint32_t i = 0; i < 4096; i++){
+            args.key = i & 1023;
+            events.enqueue(partChanged, args);
+        }
+        events.dispatch();
+    }
+    state.end();
+    doNotOptimize(motion);
+    doNotOptimize(changed);
+    state.itemsPerIteration = 1000 + 200 + 4096;
+}
+
+// Subscribers enqueue follow-up events into same and other bands, delivered by next dispatch
+// (correctness: tests/test_event.cpp)
+BOTTLE_BENCH(event_enqueue_during_dispatch){
+    EventBehaviour events{};
+    events.register_event("input", EventCoalesce::NONE, EventPriority::HIGH);
+    events.register_event("follow_up", EventCoalesce::NONE, EventPriority::LOW);
+    events.register_event("echo", EventCoalesce::NONE, EventPriority::HIGH);
+
+    const EventTrigger input = "input";
+    const EventTrigger followUp = "follow_up";
+    const EventTrigger echo = "echo";
+    uint32_t delivered = 0;
+    events.subscribe(input, [&events, &followUp, &echo]{
+        events.enqueue(followUp);
+        events.enqueue(echo);
+    });
+    events.subscribe(followUp, [&delivered]{ delivered++; });
+    events.subscribe(echo, [&delivered]{ delivered++; });
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        events.enqueue(input);
+        events.dispatch();
+    }
+    state.end();
+    doNotOptimize(delivered);
+    state.itemsPerIteration = 3;
+}
@@ -0,0 +1,195 @@
+#include "bench.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <ctime>
+#include <cstring>
+#include <exception>
+
+#ifndef BOTTLE_GIT_COMMIT
+#define BOTTLE_GIT_COMMIT "unknown"
+#endif
+
+std::vector<BenchCase>& benchRegistry(){
+    static std::vector<BenchCase> registry{};
+    return registry;
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerIteration = 0.0; // median of repetitions
+    double minNs = 0.0;
+    double maxNs = 0.0;
+    double itemsPerSecond = 0.0;
+    double bytesPerSecond = 0.0;
+    std::string skipped{};
+    std::string error{};        // bench threw, no measurement
+};
+
+// Engine code logs a lot to std::cout, keep it out of measurements
+class QuietScope {
+private:
+    std::ostringstream sink;
+    std::streambuf* previous;
+public:
+    QuietScope() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietScope() { std::cout.rdbuf(previous); }
+};
+
+static double runOnce(const BenchCase& bench, BenchState& state, uint64_t iterations){
+    state.reset();
+    state.iterations = iterations;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        QuietScope quiet{};
+        bench.function(state);
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    return state.manualTiming() ? state.seconds() : std::chrono::duration<double>(stop - start).count();
+}
+
+static BenchResult runBench(const BenchCase& bench, double minTime, uint32_t repetitions){
+    BenchResult result{};
+    result.name = bench.name;
+
+    BenchState state{};
+
+    // Calibration: grow iterations until one run takes minTime
+    uint64_t iterations = 1;
+    double seconds = runOnce(bench, state, iterations);
+    if (!state.skipReason.empty()){
+        result.skipped = state.skipReason;
+        return result;
+    }
+    while (seconds < minTime && iterations < (1ull << 40)){
+        double scale = seconds > 0.0 ? std::min(10.0, std::max(2.0, minTime / seconds * 1.2)) : 10.0;
+        iterations = static_cast<uint64_t>(iterations * scale);
+        seconds = runOnce(bench, state, iterations);
+    }
+
+    std::vector<double> samples{};
+    for (uint32_t i = 0; i < repetitions; i++){
+        samples.push_back(runOnce(bench, state, iterations) * 1e9 / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    result.iterations = iterations;
+    result.nsPerIteration = samples[samples.size() / 2];
+    result.minNs = samples.front();
+    result.maxNs = samples.back();
+    if (state.itemsPerIteration){
+        result.itemsPerSecond = state.itemsPerIteration * 1e9 / result.nsPerIteration;
+    }
+    if (state.bytesPerIteration){
+        result.bytesPerSecond = state.bytesPerIteration * 1e9 / result.nsPerIteration;
+    }
+    return result;
+}
+
+static std::string escape(const std::string& text){
+    std::string out{};
+    for (char c : text){
+        if (c == '"' || c == '\\'){
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+static void writeJson(const std::string& path, const std::vector<BenchResult>& results){
+    std::ofstream file{path};
+    if (!file){
+        std::cerr << "Failed to open " << path << std::endl;
+        return;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    file << "{\n";
+    file << "  \"commit\": \"" << BOTTLE_GIT_COMMIT << "\",\n";
+    file << "  \"timestamp\": \"" << timestamp << "\",\n";
+    file << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++){
+        const BenchResult& r = results[i];
+        file << "    {\"name\": \"" << escape(r.name) << "\"";
+        if (!r.error.empty()){
+            file << ", \"error\": \"" << escape(r.error) << "\"}";
+        } else if (!r.skipped.empty()){
+            file << ", \"skipped\": \"" << escape(r.skipped) << "\"}";
+        } else {
+            file << ", \"iterations\": " << r.iterations
+                 << ", \"ns_per_iter\": " << r.nsPerIteration
+                 << ", \"min_ns\": " << r.minNs
+                 << ", \"max_ns\": " << r.maxNs
+                 << ", \"items_per_second\": " << r.itemsPerSecond
+                 << ", \"bytes_per_second\": " << r.bytesPerSecond << "}";
+        }
+        file << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+}
+
+int main(int argc, char** argv){
+    std::string filter{};
+    std::string jsonPath = "bench_output.json";
+    double minTime = 0.2;
+    uint32_t repetitions = 5;
+
+    for (int i = 1; i < argc; i++){
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc){
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc){
+            jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc){
+            minTime = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc){
+            repetitions = std::max(1, atoi(argv[++i]));
+        } else {
+            std::cout << "usage: bottle_bench [--filter text] [--json path] [--min-time seconds] [--repetitions n]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<BenchCase> cases = benchRegistry();
+    std::sort(cases.begin(), cases.end(), [](const BenchCase& a, const BenchCase& b){ return a.name < b.name; });
+
+    std::vector<BenchResult> results{};
+    for (const BenchCase& bench : cases){
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos){
+            continue;
+        }
+
+        // one failing bench (e.g. no device) must not end the whole run
+        BenchResult result{};
+        try {
+            result = runBench(bench, minTime, repetitions);
+        } catch (std::exception& e) {
+            result = BenchResult{};
+            result.name = bench.name;
+            result.error = e.what();
+        }
+        if (!result.error.empty()){
+            std::cout << bench.name << ": failed (" << result.error << ")" << std::endl;
+        } else if (!result.skipped.empty()){
+            std::cout << bench.name << ": skipped (" << result.skipped << ")" << std::endl;
+        } else {
+            std::cout << bench.name << ": " << result.nsPerIteration << " ns/iter";
+            if (result.itemsPerSecond > 0.0){
+                std::cout << ", " << result.itemsPerSecond / 1e6 << " M items/s";
+            }
+            std::cout << " (" << result.iterations << " iterations)" << std::endl;
+        }
+        results.push_back(result);
+    }
+
+    writeJson(jsonPath, results);
+    std::cout << "Results written to " << jsonPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "bench.hpp"
+#include <cstdlib>
+#include <vector>
+#include <list>
+#include "../src/memory/src/arena.hpp"
+#include "../src/memory/src/pool.hpp"
+
+BOTTLE_BENCH(heap_alloc_free_64B){
+    for (uint64_t it = 0; it < state.iterations; it++){
+        void* p = malloc(64);
+        doNotOptimize(p);
+        free(p);
+    }
+    state.itemsPerIteration = 1;
+}
+
+// frame-like pattern: many small allocations of mixed size, freed together
+BOTTLE_BENCH(heap_alloc_frame_1k_mixed){
+    std::vector<void*> pointers(1000);
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (size_t i = 0; i < pointers.size(); i++){
+            pointers[i] = malloc(16 + (i * 37) % 512);
+        }
+        doNotOptimize(pointers.data());
+        for (void* p : pointers){
+            free(p);
+        }
+    }
+    state.itemsPerIteration = pointers.size();
+}
+
+// same pattern from frame arena, released by one reset
+BOTTLE_BENCH(frame_arena_alloc_frame_1k_mixed){
+    FrameAllocator frames{2};
+    std::vector<void*> pointers(1000);
+    for (uint64_t it = 0; it < state.iterations; it++){
+        frames.beginFrame(static_cast<uint32_t>(it));
+        for (size_t i = 0; i < pointers.size(); i++){
+            pointers[i] = frames.allocate(16 + (i * 37) % 512);
+        }
+        doNotOptimize(pointers.data());
+    }
+    state.itemsPerIteration = pointers.size();
+}
+
+BOTTLE_BENCH(object_pool_create_destroy_64B){
+    struct Object { uint64_t data[8]; };
+    ObjectPool<Object> pool{};
+    pool.reserve(1);
+    for (uint64_t it = 0; it < state.iterations; it++){
+        Object* object = pool.create();
+        doNotOptimize(object);
+        pool.destroy(object);
+    }
+    state.itemsPerIteration = 1;
+}
+
+BOTTLE_BENCH(pmr_list_push_1k_pool){
+    PoolResource resource{64, 1024};
+    for (uint64_t it = 0; it < state.iterations; it++){
+        std::pmr::list<uint64_t> list{&resource};
+        for (uint64_t i = 0; i < 1000; i++){
+            list.push_back(i);
+        }
+        doNotOptimize(list.back());
+    }
+    state.itemsPerIteration = 1000;
+}
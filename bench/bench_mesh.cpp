@@ -0,0 +1,54 @@
+#include "bench.hpp"
+#include "../src/graphics/src/mesh/meshconvert.hpp"
+#include "../src/graphics/src/mesh/meshoptimizer.hpp"
+#include "../src/graphics/src/mesh/meshsimplify.hpp"
+#include <cmath>
+
+static MeshSource gridMesh(uint32_t size){
+    MeshSource source{};
+    for (uint32_t y = 0; y < size; y++){
+        for (uint32_t x = 0; x < size; x++){
+            source.positions.insert(source.positions.end(), {float(x), float(y), 0.0f});
+        }
+    }
+    for (uint32_t y = 0; y + 1 < size; y++){
+        for (uint32_t x = 0; x + 1 < size; x++){
+            uint32_t a = y * size + x;
+            source.indices.insert(source.indices.end(), {a, a + 1, a + size + 1, a, a + size + 1, a + size});
+        }
+    }
+    return source;
+}
+
+BOTTLE_BENCH(mesh_vertex_cache_optimize_64k_tris){
+    MeshSource source = gridMesh(182);
+    for (uint64_t it = 0; it < state.iterations; it++){
+        std::vector<uint32_t> indices = source.indices;
+        optimizeVertexCache(indices, source.positions.size() / 3);
+        doNotOptimize(indices.data());
+    }
+    state.itemsPerIteration = source.indices.size() / 3;
+}
+
+BOTTLE_BENCH(mesh_convert_64k_tris){
+    MeshSource source = gridMesh(182);
+    for (uint64_t it = 0; it < state.iterations; it++){
+        MeshData mesh = convertMesh(source);
+        doNotOptimize(mesh.vertices.data());
+    }
+    state.itemsPerIteration = source.indices.size() / 3;
+}
+
+// Wavy grid, so every collapse has a cost; a quarter of the triangles are kept
+BOTTLE_BENCH(mesh_simplify_64k_tris){
+    MeshSource source = gridMesh(182);
+    for (size_t i = 0; i < source.positions.size(); i += 3){
+        source.positions[i + 2] = std::sin(source.positions[i] * 0.1f) * std::cos(source.positions[i + 1] * 0.1f) * 3.0f;
+    }
+    for (uint64_t it = 0; it < state.iterations; it++){
+        float error = 0.0f;
+        std::vector<uint32_t> indices = simplifyMesh(source.indices, source.positions, source.indices.size() / 4, 1e30f, &error);
+        doNotOptimize(indices.data());
+    }
+    state.itemsPerIteration = source.indices.size() / 3;
+}
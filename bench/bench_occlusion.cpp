@@ -0,0 +1,145 @@
+#include "bench.hpp"
+#include "headlessrender.hpp"
+#include "../src/occlusion/occlusionBehaviour.hpp"
+#include "../src/graphics/src/mesh/mesh.hpp"
+#include "../src/graphics/src/mesh/meshconvert.hpp"
+#include <iostream>
+#include <cstdio>
+#include <stdexcept>
+#include <cmath>
+
+#define OCCLUSION_BENCH_GRID 256u
+#define OCCLUSION_BENCH_COUNT (OCCLUSION_BENCH_GRID * OCCLUSION_BENCH_GRID)
+// second frame already culls with visibility of first one
+#define OCCLUSION_BENCH_WARMUP 4
+
+static void writeCube(const std::string& path){
+    MeshSource source{};
+    for (uint32_t i = 0; i < 8; i++){
+        source.positions.insert(source.positions.end(), {(i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f});
+    }
+    source.indices = {
+        0, 2, 1, 1, 2, 3,   4, 5, 6, 5, 7, 6,   0, 1, 4, 1, 5, 4,
+        2, 6, 3, 3, 6, 7,   0, 4, 2, 2, 4, 6,   1, 3, 5, 3, 7, 5
+    };
+    writeMeshFile(path, convertMesh(source));
+}
+
+// Unit sphere, 8192 triangles at full detail
+static void writeSphere(const std::string& path, uint32_t levels){
+    const uint32_t rings = 64, segments = 64;
+    MeshSource source{};
+    for (uint32_t ring = 0; ring <= rings; ring++){
+        float theta = 3.14159265f * static_cast<float>(ring) / rings;
+        for (uint32_t segment = 0; segment < segments; segment++){
+            float phi = 6.2831853f * static_cast<float>(segment) / segments;
+            source.positions.insert(source.positions.end(), {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+        }
+    }
+    for (uint32_t ring = 0; ring < rings; ring++){
+        for (uint32_t segment = 0; segment < segments; segment++){
+            uint32_t a = ring * segments + segment;
+            uint32_t b = ring * segments + (segment + 1) % segments;
+            source.indices.insert(source.indices.end(), {a, b, b + segments, a, b + segments, a + segments});
+        }
+    }
+    MeshLodOptions options{};
+    options.levels = levels;
+    writeMeshFile(path, convertMesh(source, options));
+}
+
+// Wall right in front of camera hides most of a 256x256 grid of spheres behind it
+static void occlusionFrames(BenchState& state, uint32_t levels){
+    Render* render = headlessRender();
+    if (render == nullptr){
+        state.skip(headlessRenderError());
+        return;
+    }
+
+    std::string cubePath = "bench_occlusion_cube.bmesh";
+    std::string spherePath = "bench_occlusion_sphere.bmesh";
+    writeCube(cubePath);
+    writeSphere(spherePath, levels);
+    Mesh cube{render, cubePath};
+    Mesh sphere{render, spherePath};
+    std::remove(cubePath.c_str());
+    std::remove(spherePath.c_str());
+
+    CreatureRegistry<> creatures{};
+    OcclusionBehaviour occlusion{&creatures};
+    OcclusionCuller culler{render, OCCLUSION_BENCH_COUNT + 1};
+    occlusion.setCuller(&culler);
+    uint16_t wallMesh = culler.addMesh(&cube);
+    uint16_t mesh = culler.addMesh(&sphere);
+
+    OcclusionPart wall{};
+    wall.mesh = wallMesh;
+    wall.model[0] = 12.0f;
+    wall.model[5] = 6.0f;
+    wall.model[7] = 1.0f;
+    wall.model[11] = -8.0f;
+    occlusion.add(creatures.create(), wall);
+    for (uint32_t i = 0; i < OCCLUSION_BENCH_COUNT; i++){
+        OcclusionPart part{};
+        part.mesh = mesh;
+        part.model[3] = (static_cast<float>(i % OCCLUSION_BENCH_GRID) - OCCLUSION_BENCH_GRID / 2.0f) * 2.0f;
+        part.model[11] = -20.0f - static_cast<float>(i / OCCLUSION_BENCH_GRID) * 2.0f;
+        occlusion.add(creatures.create(), part);
+    }
+
+    // camera at (0, 1, 0) looking down -z, 90 degree vertical field of view
+    float view[16]{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, -1, 0, 1};
+    float projection[16]{0.75f, 0, 0, 0, 0, -1, 0, 0, 0, 0, -1.0001f, -1, 0, 0, -0.10001f, 0};
+    occlusion.setView(view, projection);
+
+    VkFenceCreateInfo fenceCreateInfo{};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence;
+    if (vkCreateFence(render->device, &fenceCreateInfo, nullptr, &fence) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create bench fence");
+    }
+
+    RenderCommandBuffer commands{};
+    auto frame = [&](){
+        commands.clear();
+        occlusion.submit(commands);
+        render->recordCommandBuffer(render->commandBuffers[0], 0, commands);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &render->commandBuffers[0];
+        vkQueueSubmit(render->graphicsQueue, 1, &submitInfo, fence);
+        vkWaitForFences(render->device, 1, &fence, VK_TRUE, UINT64_MAX);
+        vkResetFences(render->device, 1, &fence);
+    };
+
+    for (uint32_t i = 0; i < OCCLUSION_BENCH_WARMUP; i++){
+        frame();
+    }
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        frame();
+    }
+    state.end();
+
+    // std::cout is silenced while benchmarks run
+    OcclusionStats stats = occlusion.stats();
+    std::cerr << "\tobjects " << stats.objects << ", frustum culled " << stats.frustumCulled << ", occluded " << stats.occluded
+              << ", drawn early " << stats.drawnEarly << ", drawn late " << stats.drawnLate << ", triangles " << stats.triangles << std::endl;
+
+    state.itemsPerIteration = OCCLUSION_BENCH_COUNT + 1;
+    vkDestroyFence(render->device, fence, nullptr);
+    cube.cleanup();
+    sphere.cleanup();
+}
+
+BOTTLE_BENCH(vulkan_occlusion_cull_64k){
+    occlusionFrames(state, 1);
+}
+
+// Same scene, spheres with 6 levels of detail
+BOTTLE_BENCH(vulkan_occlusion_lod_64k){
+    occlusionFrames(state, 6);
+}
@@ -0,0 +1,90 @@
+#include "bench.hpp"
+#include "headlessrender.hpp"
+#include "../src/particle/particleBehaviour.hpp"
+#include <stdexcept>
+
+#define PARTICLE_BENCH_COUNT 1000000u
+#define PARTICLE_BENCH_EMITTERS 256u
+#define PARTICLE_BENCH_DT (1.0f / 60.0f)
+// frames until emission and deaths are balanced (longest lifetime)
+#define PARTICLE_BENCH_WARMUP 150
+
+// Emitters on a grid, together they keep about 1M particles alive (rate * mean lifetime)
+static void makeEmitters(CreatureRegistry<>& creatures, ParticleBehaviour& particles){
+    for (uint32_t i = 0; i < PARTICLE_BENCH_EMITTERS; i++){
+        EmitterPart emitter{};
+        emitter.position[0] = static_cast<float>(i % 16) - 8.0f;
+        emitter.position[2] = static_cast<float>(i / 16) - 8.0f;
+        emitter.radius = 0.25f;
+        emitter.velocity[1] = 2.0f;
+        emitter.spread = 1.0f;
+        emitter.lifetime[0] = 1.5f;
+        emitter.lifetime[1] = 2.5f;
+        emitter.drag = 0.1f;
+        emitter.rate = static_cast<float>(PARTICLE_BENCH_COUNT / PARTICLE_BENCH_EMITTERS) / 2.0f;
+        particles.add(creatures.create(), emitter);
+    }
+
+    // camera at (0, 5, 20) looking down -z, 90 degree vertical field of view
+    float view[16]{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, -5, -20, 1};
+    float projection[16]{0.75f, 0, 0, 0, 0, -1, 0, 0, 0, 0, -1.0001f, -1, 0, 0, -0.10001f, 0};
+    particles.setView(view, projection);
+}
+
+// Full frame: emitter commands, GPU emit / simulate / (sort) / draw of about 1M particles
+static void particleFrames(BenchState& state, ParticleBlend blend){
+    Render* render = headlessRender();
+    if (render == nullptr){
+        state.skip(headlessRenderError());
+        return;
+    }
+
+    CreatureRegistry<> creatures{};
+    ParticleBehaviour particles{&creatures};
+    ParticleSystem system{render, PARTICLE_BENCH_COUNT + PARTICLE_BENCH_COUNT / 4, blend};
+    particles.setRenderer(&system);
+    makeEmitters(creatures, particles);
+
+    VkFenceCreateInfo fenceCreateInfo{};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence;
+    if (vkCreateFence(render->device, &fenceCreateInfo, nullptr, &fence) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create bench fence");
+    }
+
+    RenderCommandBuffer commands{};
+    auto frame = [&](){
+        commands.clear();
+        particles.submit(commands, PARTICLE_BENCH_DT);
+        render->recordCommandBuffer(render->commandBuffers[0], 0, commands);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &render->commandBuffers[0];
+        vkQueueSubmit(render->graphicsQueue, 1, &submitInfo, fence);
+        vkWaitForFences(render->device, 1, &fence, VK_TRUE, UINT64_MAX);
+        vkResetFences(render->device, 1, &fence);
+    };
+
+    for (uint32_t i = 0; i < PARTICLE_BENCH_WARMUP; i++){
+        frame();
+    }
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        frame();
+    }
+    state.end();
+
+    state.itemsPerIteration = PARTICLE_BENCH_COUNT;
+    vkDestroyFence(render->device, fence, nullptr);
+}
+
+BOTTLE_BENCH(vulkan_particles_1m){
+    particleFrames(state, ParticleBlend::ADDITIVE);
+}
+
+BOTTLE_BENCH(vulkan_particles_sorted_1m){
+    particleFrames(state, ParticleBlend::ALPHA);
+}
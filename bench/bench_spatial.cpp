@@ -0,0 +1,160 @@
+#include "bench.hpp"
+#include "../src/spatial/spatialBehaviour.hpp"
+#include "../src/graphics/renderBehaviour.hpp"
+#include <random>
+#include <memory>
+
+// Creatures spread in a 2 km cube, camera frustum sees a few percent of them
+struct SpatialScene {
+    CreatureRegistry<> creatures{};
+    std::vector<Creature> handles{};
+    std::vector<Aabb> bounds{};
+    std::unique_ptr<SpatialBehaviour> spatial{};
+};
+
+static JobPool& benchJobs(){
+    static JobPool jobs{};
+    return jobs;
+}
+
+static Aabb randomBox(std::mt19937& random){
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    Aabb box{};
+    for (int k = 0; k < 3; k++){
+        box.min[k] = position(random);
+        box.max[k] = box.min[k] + 2.0f;
+    }
+    return box;
+}
+
+static void makeScene(SpatialScene& scene, uint32_t count){
+    std::mt19937 random{42};
+    scene.spatial = std::make_unique<SpatialBehaviour>(&benchJobs());
+    for (uint32_t i = 0; i < count; i++){
+        scene.handles.push_back(scene.creatures.create());
+        scene.bounds.push_back(randomBox(random));
+        scene.spatial->add(scene.handles.back(), scene.bounds.back());
+    }
+    scene.spatial->update();
+}
+
+// 90 degree perspective at origin looking down -z, 1 km far plane
+static Frustum benchFrustum(){
+    const float n = 0.1f, f = 1000.0f;
+    float projection[16]{
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, f / (n - f), -1.0f,
+        0.0f, 0.0f, n * f / (n - f), 0.0f
+    };
+    return Frustum::fromMatrix(projection);
+}
+
+static void frustumQuery(BenchState& state, uint32_t count){
+    SpatialScene scene{};
+    makeScene(scene, count);
+    Frustum frustum = benchFrustum();
+    std::pmr::vector<Creature> visible{};
+    visible.reserve(count);
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        visible.clear();
+        scene.spatial->queryFrustum(frustum, visible);
+        doNotOptimize(visible.data());
+    }
+    state.end();
+    state.itemsPerIteration = count;
+}
+
+// Baseline: every creature tested, what draw list did without spatial index
+static void frustumBruteForce(BenchState& state, uint32_t count){
+    SpatialScene scene{};
+    makeScene(scene, count);
+    Frustum frustum = benchFrustum();
+    std::pmr::vector<Creature> visible{};
+    visible.reserve(count);
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        visible.clear();
+        for (uint32_t i = 0; i < count; i++){
+            if (testFrustum(scene.bounds[i], frustum) != Containment::OUTSIDE){
+                visible.push_back(scene.handles[i]);
+            }
+        }
+        doNotOptimize(visible.data());
+    }
+    state.end();
+    state.itemsPerIteration = count;
+}
+
+// 1% of creatures move a little each frame
+static void refitMoving(BenchState& state, uint32_t count){
+    SpatialScene scene{};
+    makeScene(scene, count);
+    uint32_t moving = count / 100;
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        float offset = (it & 1) ? 0.5f : -0.5f;
+        for (uint32_t i = 0; i < moving; i++){
+            uint32_t index = i * 100;
+            for (int k = 0; k < 3; k++){
+                scene.bounds[index].min[k] += offset;
+                scene.bounds[index].max[k] += offset;
+            }
+            scene.spatial->move(scene.handles[index], scene.bounds[index]);
+        }
+        scene.spatial->update();
+    }
+    state.end();
+    state.itemsPerIteration = moving;
+}
+
+static void rebuild(BenchState& state, uint32_t count){
+    SpatialScene scene{};
+    makeScene(scene, count);
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        scene.spatial->rebuild();
+    }
+    state.end();
+    state.itemsPerIteration = count;
+}
+
+// RenderBehaviour draw list through spatial index; parts are only looked up, never drawn
+static void drawList(BenchState& state, uint32_t count){
+    SpatialScene scene{};
+    makeScene(scene, count);
+    RenderBehaviour render{&scene.creatures};
+    render.init();
+    for (Creature creature : scene.handles){
+        render.add(creature, nullptr);
+    }
+    render.setSpatial(scene.spatial.get());
+    Frustum frustum = benchFrustum();
+    std::pmr::vector<DrawItem> items{};
+    items.reserve(count);
+
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        items.clear();
+        render.buildDrawList(frustum, items);
+        doNotOptimize(items.data());
+    }
+    state.end();
+    state.itemsPerIteration = count;
+}
+
+BOTTLE_BENCH(spatial_frustum_query_100k){ frustumQuery(state, 100000); }
+BOTTLE_BENCH(spatial_frustum_query_1m){ frustumQuery(state, 1000000); }
+BOTTLE_BENCH(spatial_frustum_brute_force_100k){ frustumBruteForce(state, 100000); }
+BOTTLE_BENCH(spatial_frustum_brute_force_1m){ frustumBruteForce(state, 1000000); }
+BOTTLE_BENCH(spatial_refit_1pct_100k){ refitMoving(state, 100000); }
+BOTTLE_BENCH(spatial_refit_1pct_1m){ refitMoving(state, 1000000); }
+BOTTLE_BENCH(spatial_rebuild_100k){ rebuild(state, 100000); }
+BOTTLE_BENCH(spatial_rebuild_1m){ rebuild(state, 1000000); }
+BOTTLE_BENCH(spatial_draw_list_100k){ drawList(state, 100000); }
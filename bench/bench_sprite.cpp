@@ -0,0 +1,125 @@
+#include "bench.hpp"
+#include "headlessrender.hpp"
+#include "../src/sprite/spriteBehaviour.hpp"
+#include "../src/sprite/src/spriterenderer.hpp"
+#include <random>
+#include <stdexcept>
+
+#define SPRITE_BENCH_COUNT 1000000u
+
+static JobPool& benchJobs(){
+    static JobPool jobs{};
+    return jobs;
+}
+
+// Small sprites over a 800x600 view: 16 textures, 8 layers, one in eight additive
+static SpritePart randomSprite(std::mt19937& random){
+    std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+    uint32_t bits = random();
+
+    SpritePart sprite{};
+    sprite.position[0] = position(random);
+    sprite.position[1] = position(random) * 0.75f;
+    sprite.size[0] = 4.0f;
+    sprite.size[1] = 4.0f;
+    sprite.rotation = angle(random);
+    sprite.color = bits | 0x80000000u;
+    sprite.texture = static_cast<uint16_t>(bits & 15);
+    sprite.layer = static_cast<uint8_t>((bits >> 4) & 7);
+    sprite.blend = (bits >> 8) % 8 == 0 ? SpriteBlend::ADDITIVE : SpriteBlend::ALPHA;
+    return sprite;
+}
+
+static void makeSprites(CreatureRegistry<>& creatures, SpriteBehaviour& sprites, std::vector<Creature>& handles){
+    std::mt19937 random{42};
+    handles.resize(SPRITE_BENCH_COUNT);
+    for (auto& creature : handles){
+        creature = creatures.create();
+        sprites.add(creature, randomSprite(random));
+    }
+}
+
+// Every sprite moves each frame; sort keys stay, so parts are already in draw order
+static void spritePack(BenchState& state, bool resort){
+    CreatureRegistry<> creatures{};
+    SpriteBehaviour sprites{&creatures, &benchJobs()};
+    std::vector<Creature> handles{};
+    makeSprites(creatures, sprites, handles);
+    std::vector<SpriteInstance> instances(SPRITE_BENCH_COUNT);
+    sprites.pack(instances.data());
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (auto& creature : handles){
+            sprites.get(creature)->position[0] += 0.5f;
+        }
+        if (resort){
+            // layer change of a single sprite is enough to re-sort all of them
+            sprites.get(handles[it % SPRITE_BENCH_COUNT])->layer ^= 1;
+        }
+        const std::vector<SpriteBatch>& batches = sprites.pack(instances.data());
+        doNotOptimize(batches.data());
+    }
+    state.end();
+
+    state.itemsPerIteration = SPRITE_BENCH_COUNT;
+    state.bytesPerIteration = SPRITE_BENCH_COUNT * sizeof(SpriteInstance);
+}
+
+BOTTLE_BENCH(sprite_pack_1m){
+    spritePack(state, false);
+}
+
+BOTTLE_BENCH(sprite_sort_pack_1m){
+    spritePack(state, true);
+}
+
+// Full frame: pack into mapped instance buffer, record batches, GPU draws 1M sprites
+BOTTLE_BENCH(vulkan_sprite_frame_1m){
+    Render* render = headlessRender();
+    if (render == nullptr){
+        state.skip(headlessRenderError());
+        return;
+    }
+
+    CreatureRegistry<> creatures{};
+    SpriteBehaviour sprites{&creatures, &benchJobs()};
+    SpriteRenderer renderer{render, SPRITE_BENCH_COUNT};
+    sprites.setRenderer(&renderer);
+    sprites.setView(0.0f, 0.0f, 1.0f);
+
+    std::vector<Creature> handles{};
+    makeSprites(creatures, sprites, handles);
+
+    VkFenceCreateInfo fenceCreateInfo{};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence;
+    if (vkCreateFence(render->device, &fenceCreateInfo, nullptr, &fence) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create bench fence");
+    }
+
+    RenderCommandBuffer commands{};
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        for (auto& creature : handles){
+            sprites.get(creature)->position[0] += 0.5f;
+        }
+
+        commands.clear();
+        sprites.submit(commands);
+        render->recordCommandBuffer(render->commandBuffers[0], 0, commands);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &render->commandBuffers[0];
+        vkQueueSubmit(render->graphicsQueue, 1, &submitInfo, fence);
+        vkWaitForFences(render->device, 1, &fence, VK_TRUE, UINT64_MAX);
+        vkResetFences(render->device, 1, &fence);
+    }
+    state.end();
+
+    state.itemsPerIteration = SPRITE_BENCH_COUNT;
+    vkDestroyFence(render->device, fence, nullptr);
+}
@@ -0,0 +1,84 @@
+#include "bench.hpp"
+#include "../src/job/src/task.hpp"
+#include "../src/job/src/fileread.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static JobPool& benchJobs(){
+    static JobPool jobs{};
+    return jobs;
+}
+
+static Task<uint32_t> hashOnWorker(JobPool& jobs, uint32_t seed){
+    co_await resumeOn(jobs);
+    uint32_t hash = seed;
+    for (uint32_t i = 0; i < 64; i++){
+        hash = hash * 2654435761u + i;
+    }
+    co_return hash;
+}
+
+static Task<void> awaitHash(JobPool& jobs, uint32_t seed, uint32_t* result){
+    *result = co_await hashOnWorker(jobs, seed);
+}
+
+// 10k tasks hopping to workers and back through awaiting parent: scheduling overhead per task
+BOTTLE_BENCH(task_spawn_10k){
+    JobPool& jobs = benchJobs();
+    std::vector<uint32_t> results(10000);
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        TaskScope scope{};
+        for (uint32_t i = 0; i < results.size(); i++){
+            scope.spawn(awaitHash(jobs, i, &results[i]));
+        }
+        scope.wait();
+        doNotOptimize(results.data());
+    }
+    state.end();
+    state.itemsPerIteration = results.size();
+}
+
+// 256 asset files of 64 KiB read concurrently while calling thread drains a resume queue like a loading frame
+BOTTLE_BENCH(task_load_files_256){
+    JobPool& jobs = benchJobs();
+    const uint32_t fileCount = 256;
+    const size_t fileSize = 64 * 1024;
+    std::vector<std::string> paths{};
+    std::string contents(fileSize, 'x');
+    for (uint32_t i = 0; i < fileCount; i++){
+        paths.push_back("bench_task_asset_" + std::to_string(i) + ".bin");
+        std::ofstream file{paths.back(), std::ios::binary};
+        file << contents;
+    }
+
+    ResumeQueue mainThread{};
+    uint64_t loaded = 0;
+    auto load = [&](const std::string& path) -> Task<void> {
+        std::vector<char> data = co_await readFileAsync(jobs, path);
+        co_await resumeOn(mainThread);
+        loaded += data.size();
+    };
+
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        TaskScope scope{};
+        for (const std::string& path : paths){
+            scope.spawn(load(path));
+        }
+        while (scope.pending() > 0){
+            mainThread.drain(0.001);
+        }
+        scope.rethrow();
+    }
+    state.end();
+    doNotOptimize(loaded);
+    state.itemsPerIteration = fileCount;
+    state.bytesPerIteration = fileCount * fileSize;
+
+    for (const std::string& path : paths){
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,104 @@
+#include "bench.hpp"
+#include "headlessrender.hpp"
+#include "../src/graphics/src/pipeline/pipelinecreate.hpp"
+#include <cstdio>
+
+// GPU cases run on a software device so numbers are comparable between machines.
+// Without one they are reported as skipped.
+
+#define REQUIRE_RENDER(render) \
+    Render* render = headlessRender(); \
+    if (render == nullptr){ \
+        state.skip(headlessRenderError()); \
+        return; \
+    }
+
+BOTTLE_BENCH(vulkan_command_buffer_record){
+    REQUIRE_RENDER(render);
+
+    RenderCommandBuffer commands{};
+    for (uint64_t it = 0; it < state.iterations; it++){
+        render->recordCommandBuffer(render->commandBuffers[0], 0, commands);
+    }
+}
+
+BOTTLE_BENCH(vulkan_shader_load){
+    REQUIRE_RENDER(render);
+
+    for (uint64_t it = 0; it < state.iterations; it++){
+        Shader shader{render, "shaders/shader.vert.spv", ShaderType::VERTEX};
+        doNotOptimize(shader.shadermodule);
+        shader.cleanup();
+    }
+}
+
+static void pipelineCreate(BenchState& state, Render* render, bool useCache){
+    std::vector<Shader> shaders{
+        Shader(render, "shaders/shader.vert.spv", ShaderType::VERTEX),
+        Shader(render, "shaders/shader.frag.spv", ShaderType::FRAGMENT)
+    };
+    PipelineCreate create{render, shaders, render->renderpass};
+
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    if (useCache){
+        VkPipelineCacheCreateInfo cacheCreateInfo{};
+        cacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        vkCreatePipelineCache(render->device, &cacheCreateInfo, nullptr, &cache);
+
+        // warm up, so iterations measure cache hits
+        VkPipeline pipeline;
+        create.createPipeline(&pipeline, cache);
+        vkDestroyPipeline(render->device, pipeline, nullptr);
+    }
+
+    for (uint64_t it = 0; it < state.iterations; it++){
+        VkPipeline pipeline;
+        create.createPipeline(&pipeline, cache);
+        vkDestroyPipeline(render->device, pipeline, nullptr);
+    }
+
+    if (cache != VK_NULL_HANDLE){
+        vkDestroyPipelineCache(render->device, cache, nullptr);
+    }
+}
+
+BOTTLE_BENCH(vulkan_pipeline_create_no_cache){
+    REQUIRE_RENDER(render);
+    pipelineCreate(state, render, false);
+}
+
+BOTTLE_BENCH(vulkan_pipeline_create_cache){
+    REQUIRE_RENDER(render);
+    pipelineCreate(state, render, true);
+}
+
+// Startup cost per device: full query against lookup in capabilities cache
+BOTTLE_BENCH(vulkan_device_capabilities_query){
+    REQUIRE_RENDER(render);
+
+    for (uint64_t it = 0; it < state.iterations; it++){
+        DeviceCapabilities capabilities = queryDeviceCapabilities(render->physicalDevice);
+        doNotOptimize(&capabilities);
+    }
+}
+
+BOTTLE_BENCH(vulkan_device_capabilities_cache){
+    REQUIRE_RENDER(render);
+
+    const char* path = "bench_device_capabilities.cache";
+    {
+        DeviceCapabilitiesCache cache{path};
+        cache.store(render->capabilities);
+        cache.save();
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(render->physicalDevice, &properties);
+
+    for (uint64_t it = 0; it < state.iterations; it++){
+        DeviceCapabilitiesCache cache{path};
+        const DeviceCapabilities* capabilities = cache.find(properties);
+        doNotOptimize(capabilities);
+    }
+    std::remove(path);
+}
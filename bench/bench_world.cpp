@@ -0,0 +1,56 @@
+#include "bench.hpp"
+#include "../src/world/src/snapshot.hpp"
+#include <cstdio>
+#include <fstream>
+
+struct SnapshotAsset {
+    uint32_t id;
+};
+
+struct SnapshotTransformPart {
+    float position[3];
+    float rotation[4];
+    const SnapshotAsset* mesh;
+};
+
+// 100k creatures with one Part each, 2 shared assets: map + fixup + bulk copy
+BOTTLE_BENCH(world_snapshot_load_100k){
+    const char* assetPath = "bench_snapshot_asset.bin";
+    const char* worldPath = "bench_snapshot.bworld";
+    {
+        std::ofstream asset{assetPath, std::ios::binary};
+        asset << "mesh data";
+    }
+
+    SnapshotAsset assets[2]{{1}, {2}};
+    CreatureRegistry<> creatures{};
+    SparseSet<SnapshotTransformPart> parts{};
+    for (uint32_t i = 0; i < 100000; i++){
+        parts.add(creatures.create(), SnapshotTransformPart{{float(i), 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, &assets[i % 2]});
+    }
+
+    SnapshotWriter writer{};
+    writer.resource(&assets[0], SnapshotResourceType::CUSTOM, assetPath);
+    writer.resource(&assets[1], SnapshotResourceType::CUSTOM, assetPath);
+    writer.creatures(creatures);
+    writer.parts(1, parts, {offsetof(SnapshotTransformPart, mesh)});
+    writer.write(worldPath);
+
+    SnapshotAsset loaded{0};
+    state.begin();
+    for (uint64_t it = 0; it < state.iterations; it++){
+        WorldSnapshot snapshot{worldPath};
+        snapshot.resolve([&](SnapshotResourceType, const std::string&, uint64_t){ return static_cast<void*>(&loaded); });
+
+        CreatureRegistry<> loadedCreatures{};
+        SparseSet<SnapshotTransformPart> loadedParts{};
+        snapshot.creatures(loadedCreatures);
+        snapshot.parts(1, loadedParts);
+        doNotOptimize(loadedParts.data());
+    }
+    state.end();
+    state.itemsPerIteration = parts.size();
+
+    std::remove(worldPath);
+    std::remove(assetPath);
+}
@@ -0,0 +1,245 @@
+#include "headlessrender.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+static std::string errorMessage{};
+
+const std::string& headlessRenderError(){
+    return errorMessage;
+}
+
+class HeadlessRender : public Render {
+public:
+    VkImage colorImage = VK_NULL_HANDLE;
+    VkDeviceMemory colorMemory = VK_NULL_HANDLE;
+
+    HeadlessRender() : Render(nullptr) {}
+
+    ~HeadlessRender(){
+        if (device != VK_NULL_HANDLE){
+            vkDeviceWaitIdle(device);
+            if (pipelineCreate){
+                delete pipelineCreate;
+                pipelineCreate = nullptr;
+            }
+            // views and framebuffers must go before the image they point to
+            for (auto framebuffer : framebuffers){
+                vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+            framebuffers.clear();
+            for (auto imageView : swapchainImageViews){
+                vkDestroyImageView(device, imageView, nullptr);
+            }
+            swapchainImageViews.clear();
+            swapchainImages.clear();
+            vkDestroyImage(device, colorImage, nullptr);
+            vkFreeMemory(device, colorMemory, nullptr);
+        }
+    }
+
+    void init(){
+        createHeadlessInstance();
+        pickSoftwareDevice();
+        createHeadlessDevice();
+        createOffscreenTarget();
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = graphicsQueueFamilyIndex;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create command pool");
+        }
+
+        createGraphicsPipeline();
+
+        commandBuffers.resize(1);
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS){
+            throw std::runtime_error("Failed to allocate command buffers");
+        }
+    }
+
+    void createHeadlessInstance(){
+        VkApplicationInfo appinfo{};
+        appinfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appinfo.apiVersion = VK_API_VERSION_1_3;
+        appinfo.pEngineName = "Bottle Graphics Engine";
+        appinfo.pApplicationName = "bottle_bench";
+
+        VkInstanceCreateInfo instanceCreateInfo{};
+        instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instanceCreateInfo.pApplicationInfo = &appinfo;
+
+        if (vkCreateInstance(&instanceCreateInfo, nullptr, &instance) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create VkInstance");
+        }
+    }
+
+    void pickSoftwareDevice(){
+        const char* deviceEnv = std::getenv("BOTTLE_BENCH_DEVICE");
+        bool anyDevice = deviceEnv != nullptr && strcmp(deviceEnv, "any") == 0;
+
+        uint32_t devicesCount = 0;
+        vkEnumeratePhysicalDevices(instance, &devicesCount, nullptr);
+        std::vector<VkPhysicalDevice> physicalDevices{devicesCount};
+        vkEnumeratePhysicalDevices(instance, &devicesCount, physicalDevices.data());
+
+        for (VkPhysicalDevice candidate : physicalDevices){
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(candidate, &properties);
+            if (anyDevice || properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU){
+                physicalDevice = candidate;
+                capabilities = queryDeviceCapabilities(candidate);
+                std::cerr << "bench device: " << properties.deviceName << std::endl;
+                return;
+            }
+        }
+
+        throw std::runtime_error("no software Vulkan device (install lavapipe or set BOTTLE_BENCH_DEVICE=any)");
+    }
+
+    void createHeadlessDevice(){
+        uint32_t queueFamilyPropertiesCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties{queueFamilyPropertiesCount};
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, queueFamilyProperties.data());
+
+        bool found = false;
+        for (uint32_t i = 0; i < queueFamilyPropertiesCount; i++){
+            if (queueFamilyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT){
+                graphicsQueueFamilyIndex = i;
+                presentQueueFamilyIndex = i;
+                found = true;
+                break;
+            }
+        }
+        if (!found){
+            throw std::runtime_error("no graphics queue");
+        }
+
+        float priority = 1.0f;
+        VkDeviceQueueCreateInfo queueCreateInfo{};
+        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueCreateInfo.queueFamilyIndex = graphicsQueueFamilyIndex;
+        queueCreateInfo.queueCount = 1;
+        queueCreateInfo.pQueuePriorities = &priority;
+
+        VkDeviceCreateInfo deviceCreateInfo{};
+        deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceCreateInfo.queueCreateInfoCount = 1;
+        deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+
+        if (vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create logical device");
+        }
+        vkGetDeviceQueue(device, graphicsQueueFamilyIndex, 0, &graphicsQueue);
+        presentQueue = graphicsQueue;
+
+        // no optional features or extensions are enabled on bench device
+        capabilities.timelineSemaphore = false;
+        capabilities.descriptorIndexing = false;
+        capabilities.synchronization2 = false;
+        capabilities.dynamicRendering = false;
+        capabilities.presentWait = false;
+        capabilities.memoryBudget = false;
+        capabilities.samplerAnisotropy = false;
+        capabilities.multiDrawIndirect = false;
+        capabilities.drawIndirectFirstInstance = false;
+        capabilities.pipelineStatisticsQuery = false;
+    }
+
+    void createOffscreenTarget(){
+        format.format = VK_FORMAT_R8G8B8A8_UNORM;
+        format.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+        extent = {WIDTH, HEIGHT};
+
+        VkImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageCreateInfo.format = format.format;
+        imageCreateInfo.extent = {extent.width, extent.height, 1};
+        imageCreateInfo.mipLevels = 1;
+        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        if (vkCreateImage(device, &imageCreateInfo, nullptr, &colorImage) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create offscreen image");
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(device, colorImage, &memoryRequirements);
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = memoryRequirements.size;
+        allocateInfo.memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        vkAllocateMemory(device, &allocateInfo, nullptr, &colorMemory);
+        vkBindImageMemory(device, colorImage, colorMemory, 0);
+
+        swapchainImages = {colorImage};
+        swapchainImageViews.resize(1);
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = colorImage;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = format.format;
+        viewCreateInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        if (vkCreateImageView(device, &viewCreateInfo, nullptr, &swapchainImageViews[0]) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create offscreen image view");
+        }
+
+        // Same attachment as Render::createRenderPass, but ends in a layout that needs no swapchain
+        VkAttachmentDescription colorAttachmentDescription{};
+        colorAttachmentDescription.format = format.format;
+        colorAttachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachmentDescription.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkAttachmentReference colorAttachmentReference{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+        VkSubpassDescription subpassDescription{};
+        subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpassDescription.colorAttachmentCount = 1;
+        subpassDescription.pColorAttachments = &colorAttachmentReference;
+
+        VkRenderPassCreateInfo renderpassCreateInfo{};
+        renderpassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderpassCreateInfo.attachmentCount = 1;
+        renderpassCreateInfo.pAttachments = &colorAttachmentDescription;
+        renderpassCreateInfo.subpassCount = 1;
+        renderpassCreateInfo.pSubpasses = &subpassDescription;
+        if (vkCreateRenderPass(device, &renderpassCreateInfo, nullptr, &renderpass) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create render pass");
+        }
+
+        createFramebuffers();
+    }
+};
+
+Render* headlessRender(){
+    static std::unique_ptr<HeadlessRender> render{};
+    static bool attempted = false;
+
+    if (!attempted){
+        attempted = true;
+        try {
+            auto created = std::make_unique<HeadlessRender>();
+            created->init();
+            render = std::move(created);
+        } catch (std::runtime_error& e) {
+            errorMessage = e.what();
+        }
+    }
+    return render.get();
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "../src/graphics/src/render.hpp"
+
+// Render without window / swapchain for GPU benchmarks: one offscreen color target,
+// device is a software (CPU) Vulkan implementation unless BOTTLE_BENCH_DEVICE=any.
+// Returns nullptr when no suitable device exists; reason is stored in headlessRenderError().
+Render* headlessRender();
+const std::string& headlessRenderError();
@@ -0,0 +1,29 @@
+#version 450
+
+// Vertex layout of .bmesh files (see src/graphics/src/mesh/meshformat.hpp)
+layout(location = 0) in vec4 inPosition; // unorm16, relative to mesh bounds
+layout(location = 1) in vec2 inNormal;   // snorm16, octahedral encoded
+layout(location = 2) in vec2 inUV;       // half float
+
+layout(push_constant) uniform MeshQuantization {
+    vec4 offset;
+    vec4 scale;
+} quantization;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec2 outUV;
+
+vec3 octDecode(vec2 e){
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0){
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+void main(){
+    vec3 position = quantization.offset.xyz + inPosition.xyz * quantization.scale.xyz;
+    gl_Position = vec4(position, 1.0);
+    outNormal = octDecode(inNormal);
+    outUV = inUV;
+}
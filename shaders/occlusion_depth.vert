@@ -0,0 +1,30 @@
+#version 450
+
+// Depth only draw of culled objects (see src/occlusion/src/occlusionculler.hpp)
+layout(location = 0) in vec4 inPosition; // unorm16, relative to mesh bounds
+
+struct Object {
+    vec4 model[3];      // rows of 3x4 transform
+    vec3 boundsMin;
+    uint mesh;
+    vec3 boundsMax;
+    uint padding;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Objects {
+    Object objects[];
+};
+
+layout(push_constant) uniform Constants {
+    mat4 viewProjection;
+    vec4 offset;
+    vec4 scale;
+    uint objectBase;
+} constants;
+
+void main(){
+    Object object = objects[constants.objectBase + gl_InstanceIndex];
+    vec4 position = vec4(constants.offset.xyz + inPosition.xyz * constants.scale.xyz, 1.0);
+    vec3 world = vec3(dot(object.model[0], position), dot(object.model[1], position), dot(object.model[2], position));
+    gl_Position = constants.viewProjection * vec4(world, 1.0);
+}
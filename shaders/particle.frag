@@ -0,0 +1,12 @@
+#version 450
+
+// Soft round particle
+layout(location = 0) in vec2 inCorner;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main(){
+    float falloff = 1.0 - smoothstep(0.5, 1.0, length(inCorner));
+    outColor = vec4(inColor.rgb, inColor.a * falloff);
+}
@@ -0,0 +1,55 @@
+#version 450
+
+// Camera facing quad per alive particle, drawn as 4 vertex strip (see src/particle/src/particlesystem.hpp)
+layout(constant_id = 0) const bool SORTED = false;
+
+struct SortEntry {
+    float key;
+    uint index;
+};
+
+layout(std140, set = 0, binding = 0) uniform Frame {
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec4 cameraRight;
+    vec4 cameraUp;
+    vec4 gravity;
+    uint emitterCount;
+    uint totalEmit;
+    uint seed;
+    uint capacity;
+} frame;
+
+layout(std430, set = 0, binding = 2) readonly buffer Positions { vec4 items[]; } positions;   // xyz, age
+layout(std430, set = 0, binding = 3) readonly buffer Velocities { vec4 items[]; } velocities; // xyz, lifetime
+layout(std430, set = 0, binding = 4) readonly buffer Appearance { uvec4 items[]; } appearance;
+layout(std430, set = 0, binding = 6) readonly buffer Alive { uint indices[]; } alive;
+layout(std430, set = 0, binding = 8) readonly buffer Sort { SortEntry entries[]; } sort;
+
+layout(push_constant) uniform Pass {
+    uint list;
+    uint k;
+    uint j;
+    uint flip;
+} pass;
+
+layout(location = 0) out vec2 outCorner;
+layout(location = 1) out vec4 outColor;
+
+void main(){
+    uint instance = gl_InstanceIndex;
+    uint particle = SORTED ? sort.entries[instance].index : alive.indices[pass.list * frame.capacity + instance];
+
+    vec4 position = positions.items[particle];
+    uvec4 look = appearance.items[particle];
+    float t = clamp(position.w / velocities.items[particle].w, 0.0, 1.0);
+    vec2 sizes = unpackHalf2x16(look.z);
+    float size = mix(sizes.x, sizes.y, t);
+
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1) * 2.0 - 1.0;
+    vec3 world = position.xyz + (frame.cameraRight.xyz * corner.x + frame.cameraUp.xyz * corner.y) * (size * 0.5);
+
+    gl_Position = frame.viewProjection * vec4(world, 1.0);
+    outCorner = corner;
+    outColor = mix(unpackUnorm4x8(look.x), unpackUnorm4x8(look.y), t);
+}
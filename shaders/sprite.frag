@@ -0,0 +1,15 @@
+#version 450
+
+// One texture per draw: batches are split by texture and each binds its own set,
+// so no sampler array indexing (no dynamic indexing feature needed)
+layout(set = 0, binding = 0) uniform sampler2D spriteTexture;
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) flat in uint inTexture;
+
+layout(location = 0) out vec4 outColor;
+
+void main(){
+    outColor = texture(spriteTexture, inUV) * inColor;
+}
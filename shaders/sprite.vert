@@ -0,0 +1,33 @@
+#version 450
+
+// Instance layout of SpriteInstance (see src/sprite/src/spritebatch.hpp), drawn as 4 vertex strip
+layout(location = 0) in vec2 inPosition;  // center
+layout(location = 1) in vec2 inSize;
+layout(location = 2) in vec4 inUV;        // unorm16, min xy, max xy
+layout(location = 3) in vec4 inColor;     // unorm8
+layout(location = 4) in float inRotation; // snorm16, angle / pi
+layout(location = 5) in uint inTexture;
+
+layout(push_constant) uniform SpriteView {
+    vec2 offset;
+    vec2 scale;
+} view;
+
+layout(location = 0) out vec2 outUV;
+layout(location = 1) out vec4 outColor;
+layout(location = 2) flat out uint outTexture;
+
+void main(){
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+    vec2 local = (corner - 0.5) * inSize;
+
+    float angle = inRotation * 3.14159265;
+    float s = sin(angle);
+    float c = cos(angle);
+    vec2 world = inPosition + vec2(local.x * c - local.y * s, local.x * s + local.y * c);
+
+    gl_Position = vec4((world + view.offset) * view.scale, 0.0, 1.0);
+    outUV = mix(inUV.xy, inUV.zw, vec2(corner.x, 1.0 - corner.y));
+    outColor = inColor;
+    outTexture = inTexture;
+}
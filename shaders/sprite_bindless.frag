@@ -0,0 +1,16 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Texture index differs between instances of one draw (descriptor indexing)
+layout(constant_id = 0) const uint TEXTURE_COUNT = 1024;
+layout(set = 0, binding = 0) uniform sampler2D textures[TEXTURE_COUNT];
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) flat in uint inTexture;
+
+layout(location = 0) out vec4 outColor;
+
+void main(){
+    outColor = texture(textures[nonuniformEXT(inTexture)], inUV) * inColor;
+}
@@ -0,0 +1,80 @@
+#include "animationBehaviour.hpp"
+#include "src/gpuskinning.hpp"
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include "../memory/src/allocationtracker.hpp"
+
+// creatures per job
+#define ANIMATION_BATCH_SIZE 32
+
+AnimationPart::AnimationPart(const Skeleton* skeleton, const AnimationClip* clip)
+    : skeleton(skeleton), pose(skeleton->jointCount), blendPose(skeleton->jointCount) {
+    if (clip->stride != pose.stride){
+        throw std::runtime_error("Animation clip does not match skeleton joint count");
+    }
+    clips[0] = clip;
+    model.resize(skeleton->jointCount * 16);
+    palette.resize(skeleton->jointCount * 12);
+}
+
+void AnimationBehaviour::init(){
+    std::cout << "Animation: " << animationSimdPath() << " kernels, " << jobs->threadCount() << " worker threads" << std::endl;
+}
+
+void AnimationBehaviour::add(AnimationPart* component){
+    components.push_back(component);
+}
+
+// Looping clips keep time inside clip, so float precision does not run out in long sessions
+static float advanceTime(float time, float delta, const AnimationClip& clip, bool loop){
+    time += delta;
+    float duration = clip.duration();
+    if (loop && duration > 0.0f){
+        time = std::fmod(time, duration);
+        if (time < 0.0f){
+            time += duration;
+        }
+    }
+    return time;
+}
+
+void AnimationBehaviour::evaluate(AnimationPart* part, float deltaTime){
+    part->time[0] = advanceTime(part->time[0], deltaTime * part->speed, *part->clips[0], part->loop);
+    sampleClip(*part->clips[0], part->time[0], part->loop, part->pose);
+
+    if (part->clips[1] != nullptr && part->blend > 0.0f){
+        part->time[1] = advanceTime(part->time[1], deltaTime * part->speed, *part->clips[1], part->loop);
+        sampleClip(*part->clips[1], part->time[1], part->loop, part->blendPose);
+        blendPoses(part->pose, part->blendPose, part->blend, part->pose);
+    }
+
+    localToModel(*part->skeleton, part->pose, part->model.data());
+    skinningMatrices(*part->skeleton, part->model.data(), part->palette.data());
+}
+
+void AnimationBehaviour::update(){
+    MemoryTagScope tag{MemoryTag::ANIMATION};
+    float dt = deltaTime;
+    // kernels throw on mismatched clips, check here so it does not happen on a worker thread
+    for (AnimationPart* part : components){
+        for (const AnimationClip* clip : part->clips){
+            if (clip != nullptr && clip->stride != part->pose.stride){
+                throw std::runtime_error("Animation clip does not match skeleton joint count");
+            }
+        }
+    }
+    jobs->parallelFor(static_cast<uint32_t>(components.size()), ANIMATION_BATCH_SIZE, [this, dt](uint32_t begin, uint32_t end){
+        for (uint32_t i = begin; i < end; i++){
+            evaluate(components[i], dt);
+        }
+    });
+}
+
+void AnimationBehaviour::submit(RenderCommandBuffer& commands){
+    if (gpuSkinning == nullptr){
+        return;
+    }
+    MemoryTagScope tag{MemoryTag::ANIMATION};
+    commands.push(SKINNING_COMMAND, SkinningCommand{gpuSkinning->stage()});
+}
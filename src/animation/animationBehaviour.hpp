@@ -0,0 +1,52 @@
+#pragma once
+
+#include <System.hpp>
+#include <vector>
+#include "src/skeleton.hpp"
+#include "src/kernels.hpp"
+#include "../job/src/jobpool.hpp"
+#include "../graphics/src/commandstream.hpp"
+
+// forward declaration
+class GpuSkinning;
+
+class AnimationPart {
+public:
+    const Skeleton* skeleton;
+    const AnimationClip* clips[2]{};   // clips[1] is optional blend target
+    float time[2]{};                   // playback time of each clip
+    float blend = 0.0f;                // weight of clips[1]
+    float speed = 1.0f;
+    bool loop = true;
+
+    Pose pose;                         // blended local pose
+    Pose blendPose;                    // scratch for clips[1]
+    std::vector<float> model{};        // model space 4x4 per joint
+    std::vector<float> palette{};      // skinning 3x4 per joint
+
+    AnimationPart(const Skeleton* skeleton, const AnimationClip* clip);
+};
+
+class AnimationBehaviour : public System<AnimationPart> {
+private:
+    std::vector<AnimationPart*> components;
+    JobPool* jobs;
+    GpuSkinning* gpuSkinning = nullptr;
+    float deltaTime = 0.0f;
+
+    static void evaluate(AnimationPart* part, float deltaTime);
+
+public:
+    AnimationBehaviour(JobPool* jobs) : jobs(jobs) {}
+
+    void init();
+    void update();
+    void add(AnimationPart* component);
+
+    void setDeltaTime(float seconds) { deltaTime = seconds; }
+
+    // Palettes are skinned by compute shader instead of on CPU; parts are registered with GpuSkinning::add
+    void setGpuSkinning(GpuSkinning* skinning) { gpuSkinning = skinning; }
+    // Game thread, once per rendered frame after update(): stages palettes, pushes skinning command
+    void submit(RenderCommandBuffer& commands);
+};
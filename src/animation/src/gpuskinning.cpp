@@ -0,0 +1,216 @@
+#include "gpuskinning.hpp"
+#include "../animationBehaviour.hpp"
+#include "../../graphics/src/render.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+
+#define SKINNING_GROUP_SIZE 64
+
+struct SkinningParams {
+    uint32_t vertexCount;
+    uint32_t paletteOffset;
+};
+
+GpuSkinning::GpuSkinning(Render* render, uint32_t maxJoints, uint32_t maxMeshes){
+    std::cout << "Creating GPU skinning" << std::endl;
+
+    _render = render;
+    paletteCapacity = maxJoints;
+
+    // Descriptor set layout: palette, input vertices, output vertices
+    VkDescriptorSetLayoutBinding bindings[3]{};
+    for (uint32_t i = 0; i < 3; i++){
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.bindingCount = 3;
+    layoutCreateInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(render->device, &layoutCreateInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create skinning descriptor set layout");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 3 * maxMeshes * MAX_FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo{};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.maxSets = maxMeshes * MAX_FRAMES_IN_FLIGHT;
+    poolCreateInfo.poolSizeCount = 1;
+    poolCreateInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(render->device, &poolCreateInfo, nullptr, &descriptorPool) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create skinning descriptor pool");
+    }
+
+    createPipeline();
+
+    // Palettes (3 rows of vec4 per joint)
+    VkDeviceSize paletteSize = VkDeviceSize(maxJoints) * 12 * sizeof(float);
+    paletteBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    paletteMemories.resize(MAX_FRAMES_IN_FLIGHT);
+    paletteMapped.resize(MAX_FRAMES_IN_FLIGHT);
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        render->createBuffer(paletteSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                             &paletteBuffers[i], &paletteMemories[i]);
+        void* mapped;
+        vkMapMemory(render->device, paletteMemories[i], 0, paletteSize, 0, &mapped);
+        paletteMapped[i] = static_cast<float*>(mapped);
+    }
+
+    staged[0].resize(size_t(maxJoints) * 12);
+    staged[1].resize(size_t(maxJoints) * 12);
+
+    render->registerPrePassCommand(SKINNING_COMMAND, [this](VkCommandBuffer commandBuffer, const void* payload){
+        SkinningCommand command;
+        memcpy(&command, payload, sizeof(command));
+        upload(_render->currentFrame, command.staging);
+        dispatch(commandBuffer, _render->currentFrame);
+    });
+
+    std::cout << "GPU skinning created successfully" << std::endl << std::endl;
+}
+
+void GpuSkinning::createPipeline(){
+    Shader shader{_render, "shaders/skinning.comp.spv", ShaderType::COMPUTE};
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(SkinningParams);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(_render->device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create skinning pipeline layout");
+    }
+
+    VkComputePipelineCreateInfo pipelineCreateInfo{};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCreateInfo.stage.stage = shader.bits;
+    pipelineCreateInfo.stage.module = shader.shadermodule;
+    pipelineCreateInfo.stage.pName = "main";
+    pipelineCreateInfo.layout = pipelineLayout;
+
+    VkResult result = vkCreateComputePipelines(_render->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline);
+    shader.cleanup();
+    if (result != VK_SUCCESS){
+        throw std::runtime_error("Failed to create skinning pipeline");
+    }
+}
+
+GpuSkinning::~GpuSkinning(){
+    VkDevice device = _render->device;
+
+    _render->prePassHandlers.erase(SKINNING_COMMAND);
+
+    for (uint32_t i = 0; i < paletteBuffers.size(); i++){
+        vkUnmapMemory(device, paletteMemories[i]);
+        vkDestroyBuffer(device, paletteBuffers[i], nullptr);
+        vkFreeMemory(device, paletteMemories[i], nullptr);
+    }
+
+    vkDestroyPipeline(device, pipeline, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+}
+
+void GpuSkinning::add(AnimationPart* part, VkBuffer inputBuffer, VkBuffer outputBuffer, uint32_t vertexCount){
+    uint32_t jointCount = part->skeleton->jointCount;
+    if (paletteUsed + jointCount > paletteCapacity){
+        throw std::runtime_error("GPU skinning palette is full");
+    }
+
+    SkinnedMesh mesh{};
+    mesh.part = part;
+    mesh.inputBuffer = inputBuffer;
+    mesh.outputBuffer = outputBuffer;
+    mesh.vertexCount = vertexCount;
+    mesh.paletteOffset = paletteUsed;
+    paletteUsed += jointCount;
+
+    // One set per frame in flight, each points to that frame's palette
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
+    mesh.descriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = descriptorPool;
+    allocateInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    allocateInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(_render->device, &allocateInfo, mesh.descriptorSets.data()) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate skinning descriptor sets");
+    }
+
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; frame++){
+        VkDescriptorBufferInfo bufferInfos[3]{};
+        bufferInfos[0] = {paletteBuffers[frame], 0, VK_WHOLE_SIZE};
+        bufferInfos[1] = {inputBuffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[2] = {outputBuffer, 0, VK_WHOLE_SIZE};
+
+        VkWriteDescriptorSet writes[3]{};
+        for (uint32_t i = 0; i < 3; i++){
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = mesh.descriptorSets[frame];
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets(_render->device, 3, writes, 0, nullptr);
+    }
+
+    meshes.push_back(std::move(mesh));
+}
+
+// Command stream has at most one buffer replayed while the next is written, so two copies never collide
+uint32_t GpuSkinning::stage(){
+    uint32_t staging = stagingIndex;
+    stagingIndex ^= 1;
+    float* palette = staged[staging].data();
+    for (auto& mesh : meshes){
+        memcpy(palette + mesh.paletteOffset * 12, mesh.part->palette.data(), mesh.part->palette.size() * sizeof(float));
+    }
+    return staging;
+}
+
+void GpuSkinning::upload(uint32_t frame, uint32_t staging){
+    memcpy(paletteMapped[frame], staged[staging].data(), size_t(paletteUsed) * 12 * sizeof(float));
+}
+
+void GpuSkinning::dispatch(VkCommandBuffer commandBuffer, uint32_t frame){
+    if (meshes.empty()){
+        return;
+    }
+
+    // previous frame may still read output buffers as vertex input
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+    for (auto& mesh : meshes){
+        SkinningParams params{mesh.vertexCount, mesh.paletteOffset};
+        _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &mesh.descriptorSets[frame], 0, nullptr);
+        vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        _render->stats.dispatch(commandBuffer, (mesh.vertexCount + SKINNING_GROUP_SIZE - 1) / SKINNING_GROUP_SIZE, 1, 1);
+    }
+
+    // skinned vertices -> vertex input
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
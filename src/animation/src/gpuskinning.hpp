@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+// Render command type of SkinningCommand
+#define SKINNING_COMMAND 0x0400
+
+// forward declaration
+class Render;
+class AnimationPart;
+
+// Vertex layout consumed by shaders/skinning.comp
+struct SkinnedVertex {
+    float position[3];
+    uint32_t joints;   // 4 x uint8 joint indices
+    float normal[3];
+    uint32_t weights;  // 4 x unorm8 weights
+};
+
+// Game thread -> render thread: palettes staged for this frame
+struct SkinningCommand {
+    uint32_t staging;
+};
+
+// Optional compute shader skinning: palettes are written by AnimationBehaviour,
+// vertices are skinned on GPU into outputBuffer (usable as vertex buffer).
+// AnimationBehaviour::submit stages palettes on game thread; SKINNING_COMMAND copies them into
+// frame slot's palette buffer and dispatches before render pass.
+class GpuSkinning {
+private:
+    struct SkinnedMesh {
+        AnimationPart* part;
+        VkBuffer inputBuffer;
+        VkBuffer outputBuffer;
+        uint32_t vertexCount;
+        uint32_t paletteOffset; // in joints
+        std::vector<VkDescriptorSet> descriptorSets; // per frame in flight
+    };
+
+    Render* _render;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+
+    // Joint palettes of all meshes, one persistently mapped buffer per frame in flight
+    std::vector<VkBuffer> paletteBuffers{};
+    std::vector<VkDeviceMemory> paletteMemories{};
+    std::vector<float*> paletteMapped{};
+    uint32_t paletteCapacity = 0; // joints
+    uint32_t paletteUsed = 0;
+
+    // game thread copies, one per command buffer of RenderCommandStream (written / replayed)
+    std::vector<float> staged[2]{};
+    uint32_t stagingIndex = 0;
+
+    std::vector<SkinnedMesh> meshes{};
+
+    void createPipeline();
+
+public:
+    GpuSkinning(Render* render, uint32_t maxJoints = 65536, uint32_t maxMeshes = 4096);
+    ~GpuSkinning();
+
+    // inputBuffer holds SkinnedVertex[vertexCount], outputBuffer receives vec4 position + vec4 normal per vertex
+    void add(AnimationPart* part, VkBuffer inputBuffer, VkBuffer outputBuffer, uint32_t vertexCount);
+
+    // Game thread, after AnimationBehaviour::update: copies palettes, returns staging for SkinningCommand
+    uint32_t stage();
+
+    // Render thread: copies staged palettes into given frame in flight
+    void upload(uint32_t frame, uint32_t staging);
+
+    // Records skinning dispatches and barrier for vertex input
+    void dispatch(VkCommandBuffer commandBuffer, uint32_t frame);
+};
@@ -0,0 +1,208 @@
+#include "kernels.hpp"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// Small wrappers, so blend kernel is written once for every instruction set
+#if defined(__AVX2__)
+struct SimdFloat {
+    static constexpr uint32_t width = 8;
+    __m256 v;
+    static SimdFloat load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static SimdFloat set(float x) { return {_mm256_set1_ps(x)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+    friend SimdFloat operator+(SimdFloat a, SimdFloat b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend SimdFloat operator-(SimdFloat a, SimdFloat b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend SimdFloat operator*(SimdFloat a, SimdFloat b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    // -1 where x < 0, else 1
+    static SimdFloat sign(SimdFloat x) { return {_mm256_or_ps(_mm256_and_ps(x.v, _mm256_set1_ps(-0.0f)), _mm256_set1_ps(1.0f))}; }
+    // 1 / sqrt(x), refined with one Newton-Raphson step
+    static SimdFloat rsqrt(SimdFloat x) {
+        __m256 r = _mm256_rsqrt_ps(x.v);
+        __m256 half = _mm256_mul_ps(_mm256_set1_ps(0.5f), x.v);
+        return {_mm256_mul_ps(r, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(half, _mm256_mul_ps(r, r))))};
+    }
+};
+static const char* simdPath = "avx2";
+#elif defined(__SSE2__) || defined(_M_X64)
+struct SimdFloat {
+    static constexpr uint32_t width = 4;
+    __m128 v;
+    static SimdFloat load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static SimdFloat set(float x) { return {_mm_set1_ps(x)}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    friend SimdFloat operator+(SimdFloat a, SimdFloat b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend SimdFloat operator-(SimdFloat a, SimdFloat b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend SimdFloat operator*(SimdFloat a, SimdFloat b) { return {_mm_mul_ps(a.v, b.v)}; }
+    static SimdFloat sign(SimdFloat x) { return {_mm_or_ps(_mm_and_ps(x.v, _mm_set1_ps(-0.0f)), _mm_set1_ps(1.0f))}; }
+    static SimdFloat rsqrt(SimdFloat x) {
+        __m128 r = _mm_rsqrt_ps(x.v);
+        __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), x.v);
+        return {_mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(r, r))))};
+    }
+};
+static const char* simdPath = "sse2";
+#else
+struct SimdFloat {
+    static constexpr uint32_t width = 1;
+    float v;
+    static SimdFloat load(const float* p) { return {*p}; }
+    static SimdFloat set(float x) { return {x}; }
+    void store(float* p) const { *p = v; }
+    friend SimdFloat operator+(SimdFloat a, SimdFloat b) { return {a.v + b.v}; }
+    friend SimdFloat operator-(SimdFloat a, SimdFloat b) { return {a.v - b.v}; }
+    friend SimdFloat operator*(SimdFloat a, SimdFloat b) { return {a.v * b.v}; }
+    static SimdFloat sign(SimdFloat x) { return {x.v < 0.0f ? -1.0f : 1.0f}; }
+    static SimdFloat rsqrt(SimdFloat x) { return {1.0f / std::sqrt(x.v)}; }
+};
+static const char* simdPath = "scalar";
+#endif
+
+static_assert(ANIMATION_SIMD_WIDTH % SimdFloat::width == 0, "Pose padding must be multiple of SIMD width");
+
+const char* animationSimdPath(){
+    return simdPath;
+}
+
+void blendChannels(const float* a, const float* b, float weight, float* out, uint32_t stride){
+    const SimdFloat w = SimdFloat::set(weight);
+
+    for (uint32_t j = 0; j < stride; j += SimdFloat::width){
+        // translation and scale: a + (b - a) * w
+        for (int c : {TX, TY, TZ, SX, SY, SZ}){
+            SimdFloat va = SimdFloat::load(a + c * stride + j);
+            SimdFloat vb = SimdFloat::load(b + c * stride + j);
+            (va + (vb - va) * w).store(out + c * stride + j);
+        }
+
+        // rotation: shortest path nlerp
+        SimdFloat ax = SimdFloat::load(a + RX * stride + j);
+        SimdFloat ay = SimdFloat::load(a + RY * stride + j);
+        SimdFloat az = SimdFloat::load(a + RZ * stride + j);
+        SimdFloat aw = SimdFloat::load(a + RW * stride + j);
+        SimdFloat bx = SimdFloat::load(b + RX * stride + j);
+        SimdFloat by = SimdFloat::load(b + RY * stride + j);
+        SimdFloat bz = SimdFloat::load(b + RZ * stride + j);
+        SimdFloat bw = SimdFloat::load(b + RW * stride + j);
+
+        SimdFloat s = SimdFloat::sign(ax * bx + ay * by + az * bz + aw * bw);
+        SimdFloat x = ax + (bx * s - ax) * w;
+        SimdFloat y = ay + (by * s - ay) * w;
+        SimdFloat z = az + (bz * s - az) * w;
+        SimdFloat q = aw + (bw * s - aw) * w;
+
+        // padding lanes are zero quaternions, keep them finite
+        SimdFloat inverseLength = SimdFloat::rsqrt(x * x + y * y + z * z + q * q + SimdFloat::set(1e-30f));
+        (x * inverseLength).store(out + RX * stride + j);
+        (y * inverseLength).store(out + RY * stride + j);
+        (z * inverseLength).store(out + RZ * stride + j);
+        (q * inverseLength).store(out + RW * stride + j);
+    }
+}
+
+void sampleClip(const AnimationClip& clip, float time, bool loop, Pose& out){
+    if (clip.frameCount == 0){
+        return;
+    }
+    // frames are copied / blended whole, pose must have same channel layout
+    if (clip.stride != out.stride){
+        throw std::runtime_error("Animation clip does not match pose joint count");
+    }
+
+    float duration = clip.duration();
+    if (loop && duration > 0.0f){
+        time = std::fmod(time, duration);
+        if (time < 0.0f){
+            time += duration;
+        }
+    }
+
+    float position = time * clip.sampleRate;
+    if (position <= 0.0f || clip.frameCount == 1){
+        memcpy(out.data.data(), clip.frame(0), sizeof(float) * CHANNEL_COUNT * clip.stride);
+        return;
+    }
+    if (position >= clip.frameCount - 1){
+        memcpy(out.data.data(), clip.frame(clip.frameCount - 1), sizeof(float) * CHANNEL_COUNT * clip.stride);
+        return;
+    }
+
+    uint32_t frame = static_cast<uint32_t>(position);
+    blendChannels(clip.frame(frame), clip.frame(frame + 1), position - frame, out.data.data(), clip.stride);
+}
+
+void blendPoses(const Pose& a, const Pose& b, float weight, Pose& out){
+    if (a.stride != b.stride || a.stride != out.stride){
+        throw std::runtime_error("Blended poses have different joint counts");
+    }
+    blendChannels(a.data.data(), b.data.data(), weight, out.data.data(), a.stride);
+}
+
+static void multiply(const float* a, const float* b, float* out){
+    float result[16];
+    for (int column = 0; column < 4; column++){
+        for (int row = 0; row < 4; row++){
+            result[column * 4 + row] =
+                a[0 * 4 + row] * b[column * 4 + 0] +
+                a[1 * 4 + row] * b[column * 4 + 1] +
+                a[2 * 4 + row] * b[column * 4 + 2] +
+                a[3 * 4 + row] * b[column * 4 + 3];
+        }
+    }
+    memcpy(out, result, sizeof(result));
+}
+
+void localToModel(const Skeleton& skeleton, const Pose& pose, float* model){
+    const float* tx = pose.channel(TX); const float* ty = pose.channel(TY); const float* tz = pose.channel(TZ);
+    const float* rx = pose.channel(RX); const float* ry = pose.channel(RY); const float* rz = pose.channel(RZ); const float* rw = pose.channel(RW);
+    const float* sx = pose.channel(SX); const float* sy = pose.channel(SY); const float* sz = pose.channel(SZ);
+
+    for (uint32_t j = 0; j < skeleton.jointCount; j++){
+        float x = rx[j], y = ry[j], z = rz[j], w = rw[j];
+        float* m = model + j * 16;
+
+        // TRS matrix, column major
+        m[0]  = (1.0f - 2.0f * (y * y + z * z)) * sx[j];
+        m[1]  = (2.0f * (x * y + z * w)) * sx[j];
+        m[2]  = (2.0f * (x * z - y * w)) * sx[j];
+        m[3]  = 0.0f;
+        m[4]  = (2.0f * (x * y - z * w)) * sy[j];
+        m[5]  = (1.0f - 2.0f * (x * x + z * z)) * sy[j];
+        m[6]  = (2.0f * (y * z + x * w)) * sy[j];
+        m[7]  = 0.0f;
+        m[8]  = (2.0f * (x * z + y * w)) * sz[j];
+        m[9]  = (2.0f * (y * z - x * w)) * sz[j];
+        m[10] = (1.0f - 2.0f * (x * x + y * y)) * sz[j];
+        m[11] = 0.0f;
+        m[12] = tx[j];
+        m[13] = ty[j];
+        m[14] = tz[j];
+        m[15] = 1.0f;
+
+        int16_t parent = skeleton.parents[j];
+        if (parent >= 0){
+            multiply(model + parent * 16, m, m);
+        }
+    }
+}
+
+void skinningMatrices(const Skeleton& skeleton, const float* model, float* palette){
+    float skin[16];
+    for (uint32_t j = 0; j < skeleton.jointCount; j++){
+        multiply(model + j * 16, skeleton.inverseBind.data() + j * 16, skin);
+
+        // transpose upper 3 rows -> row major 3x4
+        float* p = palette + j * 12;
+        for (int row = 0; row < 3; row++){
+            for (int column = 0; column < 4; column++){
+                p[row * 4 + column] = skin[column * 4 + row];
+            }
+        }
+    }
+}
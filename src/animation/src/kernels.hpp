@@ -0,0 +1,22 @@
+#pragma once
+
+#include "skeleton.hpp"
+
+// Blends two channel blocks (Pose layout, same stride):
+// translation / scale are lerped, rotations are nlerped along the shortest path
+void blendChannels(const float* a, const float* b, float weight, float* out, uint32_t stride);
+
+// Samples clip at time (seconds) into pose
+void sampleClip(const AnimationClip& clip, float time, bool loop, Pose& out);
+
+// out = a * (1 - weight) + b * weight
+void blendPoses(const Pose& a, const Pose& b, float weight, Pose& out);
+
+// Local pose -> model space 4x4 column major matrices (hierarchy walk)
+void localToModel(const Skeleton& skeleton, const Pose& pose, float* model);
+
+// model * inverseBind, stored as 3x4 row major matrices (GPU skinning palette)
+void skinningMatrices(const Skeleton& skeleton, const float* model, float* palette);
+
+// Name of SIMD path compiled in (for logs and benchmarks)
+const char* animationSimdPath();
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Joint channels, stored as separate float streams (SoA)
+enum AnimationChannel {
+    TX, TY, TZ,     // translation
+    RX, RY, RZ, RW, // rotation quaternion
+    SX, SY, SZ,     // scale
+    CHANNEL_COUNT
+};
+
+// Streams are padded so SIMD kernels never need a scalar tail
+#define ANIMATION_SIMD_WIDTH 8
+
+inline uint32_t paddedJointCount(uint32_t jointCount){
+    return (jointCount + ANIMATION_SIMD_WIDTH - 1) / ANIMATION_SIMD_WIDTH * ANIMATION_SIMD_WIDTH;
+}
+
+struct Skeleton {
+    uint32_t jointCount = 0;
+    std::vector<int16_t> parents{};     // parent joint, -1 for root, parents[i] < i
+    std::vector<float> inverseBind{};   // 4x4 column major matrix per joint
+};
+
+// Local joint transforms: channel c of joint j is data[c * stride + j]
+struct Pose {
+    uint32_t jointCount = 0;
+    uint32_t stride = 0;
+    std::vector<float> data{};
+
+    Pose() = default;
+    Pose(uint32_t jointCount) : jointCount(jointCount), stride(paddedJointCount(jointCount)), data(stride * CHANNEL_COUNT, 0.0f) {}
+
+    float* channel(AnimationChannel c) { return data.data() + c * stride; }
+    const float* channel(AnimationChannel c) const { return data.data() + c * stride; }
+};
+
+// Uniformly sampled clip: frame f is a Pose sized block at data[f * CHANNEL_COUNT * stride]
+struct AnimationClip {
+    uint32_t jointCount = 0;
+    uint32_t stride = 0;
+    uint32_t frameCount = 0;
+    float sampleRate = 30.0f;
+    std::vector<float> data{};
+
+    AnimationClip() = default;
+    AnimationClip(uint32_t jointCount, uint32_t frameCount, float sampleRate)
+        : jointCount(jointCount), stride(paddedJointCount(jointCount)), frameCount(frameCount), sampleRate(sampleRate),
+          data(static_cast<size_t>(stride) * CHANNEL_COUNT * frameCount, 0.0f) {}
+
+    float duration() const { return frameCount > 1 ? (frameCount - 1) / sampleRate : 0.0f; }
+    float* frame(uint32_t f) { return data.data() + static_cast<size_t>(f) * CHANNEL_COUNT * stride; }
+    const float* frame(uint32_t f) const { return data.data() + static_cast<size_t>(f) * CHANNEL_COUNT * stride; }
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <limits>
+#include <type_traits>
+
+// Creature = generational handle: slot index + generation of that slot.
+// Destroying a creature bumps the slot generation, so old handles fail one compare.
+// Value 0 (index 0, generation 0) is never handed out and means "no creature".
+template<typename Storage, unsigned IndexBits>
+struct GenerationalHandle {
+    static_assert(std::is_unsigned<Storage>::value, "Handle storage must be unsigned");
+    static_assert(IndexBits > 0 && IndexBits < sizeof(Storage) * 8, "Handle needs index and generation bits");
+
+    static constexpr unsigned indexBits = IndexBits;
+    static constexpr unsigned generationBits = sizeof(Storage) * 8 - IndexBits;
+    static constexpr Storage indexMask = (Storage(1) << IndexBits) - 1;
+    static constexpr Storage generationMask = Storage(~Storage(0)) >> IndexBits;
+    static constexpr uint32_t maxIndex = static_cast<uint32_t>(indexMask);
+
+    Storage value = 0;
+
+    GenerationalHandle() = default;
+    constexpr GenerationalHandle(uint32_t index, Storage generation)
+        : value((Storage(generation & generationMask) << IndexBits) | (Storage(index) & indexMask)) {}
+
+    constexpr uint32_t index() const { return static_cast<uint32_t>(value & indexMask); }
+    constexpr Storage generation() const { return value >> IndexBits; }
+    constexpr bool valid() const { return value != 0; }
+    explicit constexpr operator bool() const { return valid(); }
+
+    friend constexpr bool operator==(GenerationalHandle a, GenerationalHandle b) { return a.value == b.value; }
+    friend constexpr bool operator!=(GenerationalHandle a, GenerationalHandle b) { return a.value != b.value; }
+};
+
+using Creature = GenerationalHandle<uint32_t, 20>;   // 1M creatures, 4096 generations per slot
+using Creature64 = GenerationalHandle<uint64_t, 32>; // 4G creatures, 4G generations per slot
+
+// Hands out and recycles creature handles (free list of destroyed slots)
+template<typename Handle = Creature>
+class CreatureRegistry {
+private:
+    using Storage = decltype(Handle::value);
+
+    static constexpr uint32_t END = std::numeric_limits<uint32_t>::max();
+
+    std::vector<Storage> generations{};   // current generation per slot
+    std::vector<uint32_t> nextFree{};     // free list link per slot
+    uint32_t freeHead = END;
+    uint32_t aliveCount = 0;
+
+public:
+    CreatureRegistry(){
+        // slot 0 with generation 0 is the null handle, start it at generation 1
+        generations.push_back(1);
+        nextFree.push_back(END);
+        freeHead = 0;
+    }
+
+    Handle create(){
+        uint32_t index;
+        if (freeHead != END){
+            index = freeHead;
+            freeHead = nextFree[index];
+        } else {
+            index = static_cast<uint32_t>(generations.size());
+            if (index > Handle::maxIndex){
+                return Handle{};
+            }
+            generations.push_back(0);
+            nextFree.push_back(END);
+        }
+        aliveCount++;
+        return Handle{index, generations[index]};
+    }
+
+    void destroy(Handle creature){
+        if (!alive(creature)){
+            return;
+        }
+        uint32_t index = creature.index();
+        Storage generation = (generations[index] + 1) & Handle::generationMask;
+        // slot 0 must never wrap back to generation 0
+        generations[index] = (index == 0 && generation == 0) ? 1 : generation;
+        nextFree[index] = freeHead;
+        freeHead = index;
+        aliveCount--;
+    }
+
+    // One bounds check and one compare, cheap enough for release builds
+    bool alive(Handle creature) const {
+        uint32_t index = creature.index();
+        return creature.valid() && index < generations.size() && generations[index] == creature.generation();
+    }
+
+    uint32_t size() const { return aliveCount; }
+
+    // Raw slot arrays, for binary snapshots
+    uint32_t slotCount() const { return static_cast<uint32_t>(generations.size()); }
+    const Storage* generationData() const { return generations.data(); }
+    const uint32_t* freeLinkData() const { return nextFree.data(); }
+    uint32_t freeListHead() const { return freeHead; }
+
+    void restore(const Storage* slotGenerations, const uint32_t* freeLinks, uint32_t slots, uint32_t head, uint32_t alive){
+        generations.assign(slotGenerations, slotGenerations + slots);
+        nextFree.assign(freeLinks, freeLinks + slots);
+        freeHead = head;
+        aliveCount = alive;
+    }
+};
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include "Creature.hpp"
+
+// Parts per change chunk: readers skip chunks with nothing newer than their last run
+#define PART_CHUNK_SIZE 64u
+
+// Stamp of a change, advanced by readers (usually once per frame). Wraps around;
+// compare with tickNewer(), ticks more than 2^31 apart are not ordered correctly.
+using ChangeTick = uint32_t;
+
+inline bool tickNewer(ChangeTick tick, ChangeTick since){
+    return static_cast<int32_t>(tick - since) > 0;
+}
+
+// Creature -> Part storage. Parts are packed in dense arrays (iteration is a linear scan),
+// sparse array maps creature index to dense slot. Add, remove and lookup are O(1);
+// remove moves last Part into the hole, so order is not kept.
+//
+// Change detection: every Part carries tick of its last add / modify and tick it was added at,
+// every PART_CHUNK_SIZE slots the newest of them. Writers go through modify() (or markChanged()),
+// a reader keeps tick of its last run and visits only what changed since:
+//
+//   ChangeTick since = lastRun;
+//   lastRun = parts.advanceTick();
+//   parts.forEachChanged(since, [&](uint32_t slot){ ... parts.data()[slot] ... });
+//
+// Slots move on remove, reorder, assign and clear; structureChangedSince() tells a reader
+// that keeps data per slot to rebuild it. Removed creatures are kept only with trackRemovals().
+template<typename T, typename Handle = Creature>
+class SparseSet {
+private:
+    static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> sparse{};   // creature index -> dense slot or EMPTY
+    std::vector<Handle> creatures{};  // dense slot -> owner (with generation, for stale checks)
+    std::vector<T> parts{};           // dense slot -> Part
+
+    std::vector<ChangeTick> changedTicks{};   // dense slot -> last add / modify
+    std::vector<ChangeTick> addedTicks{};     // dense slot -> add
+    std::vector<ChangeTick> chunkTicks{};     // newest changed tick of PART_CHUNK_SIZE slots
+    std::vector<std::pair<Handle, ChangeTick>> removals{};
+    bool trackingRemovals = false;
+    ChangeTick tick = 1;
+    ChangeTick structureTick = 1;             // last time slots moved or were added / removed
+
+    void stamp(uint32_t dense){
+        changedTicks[dense] = tick;
+        chunkTicks[dense / PART_CHUNK_SIZE] = tick;
+    }
+
+    void restampChunks(){
+        chunkTicks.resize((parts.size() + PART_CHUNK_SIZE - 1) / PART_CHUNK_SIZE);
+        for (uint32_t dense = 0; dense < parts.size(); dense++){
+            ChangeTick& chunk = chunkTicks[dense / PART_CHUNK_SIZE];
+            if (dense % PART_CHUNK_SIZE == 0 || tickNewer(changedTicks[dense], chunk)){
+                chunk = changedTicks[dense];
+            }
+        }
+    }
+
+    uint32_t slot(Handle creature) const {
+        uint32_t index = creature.index();
+        if (index >= sparse.size()){
+            return EMPTY;
+        }
+        uint32_t dense = sparse[index];
+        // stale handle: slot now belongs to newer generation of creature
+        return (dense != EMPTY && creatures[dense] == creature) ? dense : EMPTY;
+    }
+
+public:
+    template<typename... Args>
+    T& add(Handle creature, Args&&... args){
+        uint32_t existing = slot(creature);
+        if (existing != EMPTY){
+            parts[existing] = T(std::forward<Args>(args)...);
+            stamp(existing);
+            return parts[existing];
+        }
+
+        uint32_t index = creature.index();
+        if (index >= sparse.size()){
+            sparse.resize(static_cast<size_t>(index) + 1, EMPTY);
+        }
+        uint32_t orphan = sparse[index];
+        if (orphan != EMPTY){
+            // Part of an older generation whose creature was destroyed without removing it:
+            // new Part takes over its slot, otherwise no handle could ever remove it
+            if (trackingRemovals){
+                removals.push_back({creatures[orphan], tick});
+            }
+            creatures[orphan] = creature;
+            parts[orphan] = T(std::forward<Args>(args)...);
+            addedTicks[orphan] = tick;
+            stamp(orphan);
+            structureTick = tick;
+            return parts[orphan];
+        }
+        sparse[index] = static_cast<uint32_t>(parts.size());
+        creatures.push_back(creature);
+        parts.emplace_back(std::forward<Args>(args)...);
+        changedTicks.push_back(tick);
+        addedTicks.push_back(tick);
+        if (chunkTicks.size() * PART_CHUNK_SIZE < parts.size()){
+            chunkTicks.push_back(tick);
+        }
+        stamp(static_cast<uint32_t>(parts.size() - 1));
+        structureTick = tick;
+        return parts.back();
+    }
+
+    bool remove(Handle creature){
+        uint32_t dense = slot(creature);
+        if (dense == EMPTY){
+            return false;
+        }
+
+        uint32_t last = static_cast<uint32_t>(parts.size() - 1);
+        if (dense != last){
+            parts[dense] = std::move(parts[last]);
+            creatures[dense] = creatures[last];
+            sparse[creatures[dense].index()] = dense;
+            // moved Part keeps its ticks, its new chunk must not hide them
+            changedTicks[dense] = changedTicks[last];
+            addedTicks[dense] = addedTicks[last];
+            ChangeTick& chunk = chunkTicks[dense / PART_CHUNK_SIZE];
+            if (tickNewer(changedTicks[dense], chunk)){
+                chunk = changedTicks[dense];
+            }
+        }
+        parts.pop_back();
+        creatures.pop_back();
+        changedTicks.pop_back();
+        addedTicks.pop_back();
+        chunkTicks.resize((parts.size() + PART_CHUNK_SIZE - 1) / PART_CHUNK_SIZE);
+        sparse[creature.index()] = EMPTY;
+        if (trackingRemovals){
+            removals.push_back({creature, tick});
+        }
+        structureTick = tick;
+        return true;
+    }
+
+    // nullptr when creature has no Part here or handle is stale
+    T* get(Handle creature){
+        uint32_t dense = slot(creature);
+        return dense == EMPTY ? nullptr : &parts[dense];
+    }
+
+    const T* get(Handle creature) const {
+        uint32_t dense = slot(creature);
+        return dense == EMPTY ? nullptr : &parts[dense];
+    }
+
+    // get() for writing: Part counts as changed at current tick
+    T* modify(Handle creature){
+        uint32_t dense = slot(creature);
+        if (dense == EMPTY){
+            return nullptr;
+        }
+        stamp(dense);
+        return &parts[dense];
+    }
+
+    void markChanged(Handle creature){
+        uint32_t dense = slot(creature);
+        if (dense != EMPTY){
+            stamp(dense);
+        }
+    }
+
+    // Writers that iterate dense arrays directly
+    void markChangedSlot(uint32_t dense) { stamp(dense); }
+
+    bool contains(Handle creature) const { return slot(creature) != EMPTY; }
+
+    // Part that add(creature) would overwrite: creature's own or an orphan of an older
+    // generation in its slot. Owners of resources in Parts release it before add().
+    T* displaced(Handle creature){
+        uint32_t index = creature.index();
+        if (index >= sparse.size() || sparse[index] == EMPTY){
+            return nullptr;
+        }
+        return &parts[sparse[index]];
+    }
+
+    // Removes Parts whose creature is no longer alive in registry, fn(T&) runs before each removal.
+    // Destroying a creature does not reach Behaviours, they sweep (e.g. once per update).
+    template<typename Registry, typename F>
+    uint32_t removeDead(const Registry& registry, F&& fn){
+        uint32_t removed = 0;
+        for (uint32_t dense = static_cast<uint32_t>(parts.size()); dense-- > 0;){
+            if (!registry.alive(creatures[dense])){
+                fn(parts[dense]);
+                remove(creatures[dense]);
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    void reserve(size_t count){
+        creatures.reserve(count);
+        parts.reserve(count);
+        changedTicks.reserve(count);
+        addedTicks.reserve(count);
+    }
+
+    // Replaces content with packed arrays (snapshot load), one pass to rebuild sparse index
+    void assign(const Handle* owners, const T* data, size_t count){
+        if (trackingRemovals){
+            for (const Handle& creature : creatures){
+                removals.push_back({creature, tick});
+            }
+        }
+        creatures.assign(owners, owners + count);
+        parts.assign(data, data + count);
+        changedTicks.assign(count, tick);
+        addedTicks.assign(count, tick);
+        chunkTicks.assign((count + PART_CHUNK_SIZE - 1) / PART_CHUNK_SIZE, tick);
+        structureTick = tick;
+        sparse.clear();
+        for (uint32_t dense = 0; dense < count; dense++){
+            uint32_t index = owners[dense].index();
+            if (index >= sparse.size()){
+                sparse.resize(static_cast<size_t>(index) + 1, EMPTY);
+            }
+            sparse[index] = dense;
+        }
+    }
+
+    // Moves Parts into given order, order[i] is current slot of Part that goes to slot i.
+    // Lets systems iterate in their processing order (e.g. draw order) with linear reads.
+    void reorder(const uint32_t* order){
+        std::vector<Handle> orderedCreatures{};
+        std::vector<T> orderedParts{};
+        std::vector<ChangeTick> orderedChanged{};
+        std::vector<ChangeTick> orderedAdded{};
+        orderedCreatures.reserve(parts.size());
+        orderedParts.reserve(parts.size());
+        orderedChanged.reserve(parts.size());
+        orderedAdded.reserve(parts.size());
+        for (uint32_t dense = 0; dense < parts.size(); dense++){
+            orderedCreatures.push_back(creatures[order[dense]]);
+            orderedParts.push_back(std::move(parts[order[dense]]));
+            orderedChanged.push_back(changedTicks[order[dense]]);
+            orderedAdded.push_back(addedTicks[order[dense]]);
+            sparse[orderedCreatures.back().index()] = dense;
+        }
+        creatures.swap(orderedCreatures);
+        parts.swap(orderedParts);
+        changedTicks.swap(orderedChanged);
+        addedTicks.swap(orderedAdded);
+        restampChunks();
+        structureTick = tick;
+    }
+
+    void clear(){
+        if (trackingRemovals){
+            for (const Handle& creature : creatures){
+                removals.push_back({creature, tick});
+            }
+        }
+        sparse.clear();
+        creatures.clear();
+        parts.clear();
+        changedTicks.clear();
+        addedTicks.clear();
+        chunkTicks.clear();
+        structureTick = tick;
+    }
+
+    // Reader side of change detection
+    ChangeTick changeTick() const { return tick; }
+    // Returns tick to keep as "last run", changes after this call are newer than it
+    ChangeTick advanceTick() { return tick++; }
+    ChangeTick changedTick(uint32_t dense) const { return changedTicks[dense]; }
+    ChangeTick addedTick(uint32_t dense) const { return addedTicks[dense]; }
+    bool structureChangedSince(ChangeTick since) const { return tickNewer(structureTick, since); }
+
+    // fn(uint32_t slot) for Parts added or modified after since, whole chunks are skipped
+    template<typename F>
+    void forEachChanged(ChangeTick since, F&& fn) const {
+        for (uint32_t chunk = 0; chunk < chunkTicks.size(); chunk++){
+            if (!tickNewer(chunkTicks[chunk], since)){
+                continue;
+            }
+            uint32_t end = std::min<uint32_t>((chunk + 1) * PART_CHUNK_SIZE, static_cast<uint32_t>(parts.size()));
+            for (uint32_t dense = chunk * PART_CHUNK_SIZE; dense < end; dense++){
+                if (tickNewer(changedTicks[dense], since)){
+                    fn(dense);
+                }
+            }
+        }
+    }
+
+    // fn(uint32_t slot) for Parts added after since (a subset of changed)
+    template<typename F>
+    void forEachAdded(ChangeTick since, F&& fn) const {
+        forEachChanged(since, [&](uint32_t dense){
+            if (tickNewer(addedTicks[dense], since)){
+                fn(dense);
+            }
+        });
+    }
+
+    // Removed creatures are recorded only while tracking is on; readers call trimRemovals()
+    // with the oldest tick any of them still needs, so the list does not grow forever.
+    void trackRemovals(bool enabled){
+        trackingRemovals = enabled;
+        if (!enabled){
+            removals.clear();
+        }
+    }
+
+    // fn(Handle creature) for Parts removed after since
+    template<typename F>
+    void forEachRemoved(ChangeTick since, F&& fn) const {
+        for (const std::pair<Handle, ChangeTick>& removal : removals){
+            if (tickNewer(removal.second, since)){
+                fn(removal.first);
+            }
+        }
+    }
+
+    void trimRemovals(ChangeTick upTo){
+        size_t kept = 0;
+        for (size_t i = 0; i < removals.size(); i++){
+            if (tickNewer(removals[i].second, upTo)){
+                removals[kept++] = removals[i];
+            }
+        }
+        removals.resize(kept);
+    }
+
+    size_t size() const { return parts.size(); }
+    bool empty() const { return parts.empty(); }
+
+    // Dense arrays, index i of both belongs to same creature
+    T* data() { return parts.data(); }
+    const Handle* owners() const { return creatures.data(); }
+
+    typename std::vector<T>::iterator begin() { return parts.begin(); }
+    typename std::vector<T>::iterator end() { return parts.end(); }
+    typename std::vector<T>::const_iterator begin() const { return parts.begin(); }
+    typename std::vector<T>::const_iterator end() const { return parts.end(); }
+};
@@ -1,6 +1,8 @@
 template<typename T>
 class System {
-    virtual void init();
-    virtual void update();
-    virtual void add(T* component);
-};
\ No newline at end of file
+public:
+    virtual ~System() = default;
+    virtual void init() = 0;
+    virtual void update() = 0;
+    virtual void add(T* component) = 0;
+};
@@ -0,0 +1,105 @@
+#include "engine.hpp"
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include "../memory/src/allocationtracker.hpp"
+
+void Engine::renderLoop(){
+    AllocationTracker::setCurrentTag(MemoryTag::RENDER);
+
+    try {
+        while (const RenderCommandBuffer* commands = stream.acquire()){
+            bool presented = render->drawFrame(*commands);
+            stream.release();
+            if (!presented){
+                break;
+            }
+        }
+    } catch (std::exception& e) {
+        std::cerr << "Render thread error: " << e.what() << std::endl;
+        renderError = std::current_exception();
+    }
+
+    // game thread leaves its loop; stop() wakes it if it waits in stream.submit()
+    running = false;
+    stream.stop();
+}
+
+void Engine::run(UpdateCallback update, SubmitCallback submit){
+    std::cout << "Starting pipelined main loop" << std::endl << std::endl;
+
+    running = true;
+    renderThread = std::thread(&Engine::renderLoop, this);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point previous = Clock::now();
+    Clock::time_point lastOverlay = previous;
+
+    while (running && !glfwWindowShouldClose(window)){
+        // counts both threads: render thread works on previous frame meanwhile
+        AllocationTracker::beginFrame();
+        // render thread released this buffer, so nothing reads its frame memory any more
+        frameAllocator.beginFrame(stream.writeSlot());
+
+        // Render thread would only wait for GPU, so wait here where input is still unsampled
+        std::this_thread::sleep_for(std::chrono::duration<double>(render->framePacer.sleepBeforeInput()));
+        Clock::time_point workStart = Clock::now();
+
+        if (input){
+            input->update();
+        } else {
+            glfwPollEvents();
+        }
+
+        Clock::time_point now = Clock::now();
+        double frameTime = std::chrono::duration<double>(now - previous).count();
+        previous = now;
+
+        // Simulation of frame N+1 overlaps with render thread recording frame N
+        uint32_t steps = timestep.advance(frameTime);
+        {
+            MemoryTagScope tag{MemoryTag::ENGINE};
+            for (uint32_t i = 0; i < steps; i++){
+                update(static_cast<float>(timestep.stepSeconds()));
+            }
+        }
+
+        // Late input sample, so commands see the newest cursor / keys
+        if (input){
+            input->sampleLate();
+        }
+
+        RenderCommandBuffer& commands = stream.writeBuffer();
+        commands.alpha = timestep.alpha();
+        commands.frame = timestep.ticks;
+        commands.inputTimestamp = input ? input->snapshot().timestamp : static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+        submit(commands, commands.alpha);
+        render->framePacer.reportGameThread(std::chrono::duration<double>(Clock::now() - workStart).count());
+
+        // blocks only if render thread is more than one frame behind
+        stream.submit();
+
+        // GLFW window calls belong to this thread
+        if (render->stats.overlayEnabled() && std::chrono::duration<double>(now - lastOverlay).count() >= RENDER_STATS_OVERLAY_INTERVAL){
+            // formatting and title update allocate; rare, so not counted as steady state allocations
+            AllowAllocationsScope allow{};
+            glfwSetWindowTitle(window, render->stats.summary().c_str());
+            lastOverlay = now;
+        }
+
+        AllocationTracker::endFrame();
+    }
+
+    stream.stop();
+    renderThread.join();
+    running = false;
+
+    vkDeviceWaitIdle(render->device);
+
+    if (renderError){
+        std::exception_ptr error = renderError;
+        renderError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include "src/fixedtimestep.hpp"
+#include "../graphics/src/render.hpp"
+#include "../input/inputBehaviour.hpp"
+#include "../memory/src/arena.hpp"
+
+// Fixed step simulation (dt in seconds)
+using UpdateCallback = std::function<void(float dt)>;
+// Writes render commands for interpolated state
+using SubmitCallback = std::function<void(RenderCommandBuffer& commands, float alpha)>;
+
+// Main loop: game thread (this thread, owns GLFW events) simulates frame N+1
+// while render thread records and submits frame N
+class Engine {
+private:
+    Render* render;
+    GLFWwindow* window;
+    RenderCommandStream stream{};
+    FrameAllocator frameAllocator{2};   // game thread frame memory, one slot per command buffer
+    FixedTimestep timestep;
+    std::thread renderThread;
+    std::atomic<bool> running{false};
+    std::exception_ptr renderError{};   // set by render thread, rethrown by run() after join
+    InputBehaviour* input = nullptr;
+
+    void renderLoop();
+
+public:
+    Engine(Render* render, GLFWwindow* window, double step = 1.0 / 60.0) : render(render), window(window), timestep(step) {}
+
+    // Rethrows exception that ended render thread (device lost, shader errors, ...)
+    void run(UpdateCallback update, SubmitCallback submit);
+    void stop() { running = false; }
+
+    // Input is sampled at frame start and again right before render commands are submitted
+    void setInput(InputBehaviour* inputBehaviour) { input = inputBehaviour; }
+
+    const FixedTimestep& clock() const { return timestep; }
+
+    // Transient memory for update / submit callbacks, valid until render thread is done with the frame
+    FrameAllocator& frameMemory() { return frameAllocator; }
+};
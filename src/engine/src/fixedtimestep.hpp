@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Fixed simulation step with render interpolation factor
+class FixedTimestep {
+private:
+    double step;
+    double accumulator = 0.0;
+    uint32_t maxSteps;
+
+public:
+    uint64_t ticks = 0; // simulation steps taken
+
+    FixedTimestep(double step = 1.0 / 60.0, uint32_t maxSteps = 8) : step(step), maxSteps(maxSteps) {}
+
+    // Adds frame time, returns number of steps to simulate (clamped, so slow frames do not spiral)
+    uint32_t advance(double frameTime){
+        accumulator += frameTime;
+        uint32_t steps = static_cast<uint32_t>(accumulator / step);
+        if (steps > maxSteps){
+            steps = maxSteps;
+            accumulator = step * maxSteps;
+        }
+        accumulator -= steps * step;
+        ticks += steps;
+        return steps;
+    }
+
+    // 0..1 position between previous and current simulation state
+    float alpha() const { return static_cast<float>(accumulator / step); }
+    double stepSeconds() const { return step; }
+};
+
+template<typename T>
+inline T interpolate(const T& previous, const T& current, float alpha){
+    return previous + (current - previous) * alpha;
+}
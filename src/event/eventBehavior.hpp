@@ -3,15 +3,69 @@
 #include <unordered_map>
 #include <functional>
 #include <string>
+#include <vector>
 
-#include "event.hpp"
+#include "src/event.hpp"
 
 using EventTrigger = std::string;
 
+// What enqueue() does when event already has a pending item this frame
+enum class EventCoalesce : uint8_t {
+	NONE,           // every enqueue is delivered
+	KEEP_LATEST,    // one item, newest args (resize, cursor position)
+	ACCUMULATE,     // one item, values summed, newest key (mouse motion deltas)
+	DEDUPE_KEY      // one item per args.key, newest args (per Part change notifications)
+};
+
+// Delivery order of dispatch(): bands in order, events in a band by first enqueue of frame
+enum class EventPriority : uint8_t {
+	HIGH,
+	NORMAL,
+	LOW,
+	COUNT
+};
+
+struct EventQueueStats {
+	uint32_t enqueued = 0;      // enqueue() calls last dispatch covered
+	uint32_t delivered = 0;     // items it emitted after coalescing
+};
+
+// emit-style events run subscribers immediately. Queued events are coalesced when enqueued and
+// emitted once per frame by dispatch(), so subscribers do one unit of work per frame however
+// often the source fires. Single thread (game thread); items enqueued by subscribers during
+// dispatch() are delivered by next dispatch().
 class EventBehaviour {
 private:
+	struct EventQueue {
+		Event* event;
+		EventCoalesce policy = EventCoalesce::NONE;
+		EventPriority priority = EventPriority::NORMAL;
+		bool active = false;                                // listed in bands for next dispatch
+		std::vector<EventArgs> pending{};
+		std::unordered_map<uint64_t, uint32_t> keyIndex{};  // DEDUPE_KEY: key -> pending index
+		std::vector<EventArgs> delivering{};                // pending taken by running dispatch()
+	};
+
 	std::unordered_map<EventTrigger, Event> events{};
+	std::unordered_map<EventTrigger, EventQueue> queues{};
+	std::vector<EventQueue*> bands[static_cast<size_t>(EventPriority::COUNT)]{};
+	std::vector<EventQueue*> delivering[static_cast<size_t>(EventPriority::COUNT)]{};
+	uint32_t enqueuedSinceDispatch = 0;
+	EventQueueStats queueStats{};
+
 public:
 	Event register_event(EventTrigger trigger);
+	// Queued event with coalescing policy and delivery band
+	void register_event(EventTrigger trigger, EventCoalesce policy, EventPriority priority = EventPriority::NORMAL);
 	void subscribe(EventTrigger trigger, std::function<void()> event_callback);
-};
\ No newline at end of file
+	void subscribe(EventTrigger trigger, std::function<void(const EventArgs&)> event_callback);
+
+	// Runs subscribers now
+	void emit(const EventTrigger& trigger, const EventArgs& args = {});
+	// Coalesced with pending items of trigger, delivered by dispatch()
+	void enqueue(const EventTrigger& trigger, const EventArgs& args = {});
+	// Once per frame: emits pending items by band
+	void dispatch();
+
+	const EventQueueStats& stats() const { return queueStats; }
+};
@@ -1,8 +1,112 @@
-#include "eventsystem.hpp"
+#include "eventBehavior.hpp"
+#include "../memory/src/allocationtracker.hpp"
 
 Event EventBehaviour::register_event(EventTrigger trigger) {
     Event event{};
     events[trigger] = event;
 
     return event;
-}
\ No newline at end of file
+}
+
+void EventBehaviour::register_event(EventTrigger trigger, EventCoalesce policy, EventPriority priority) {
+    EventQueue& queue = queues[trigger];
+    queue.event = &events[trigger];
+    queue.policy = policy;
+    queue.priority = priority;
+}
+
+void EventBehaviour::subscribe(EventTrigger trigger, std::function<void()> event_callback) {
+    events[trigger].add(event_callback);
+}
+
+void EventBehaviour::subscribe(EventTrigger trigger, std::function<void(const EventArgs&)> event_callback) {
+    events[trigger].add(event_callback);
+}
+
+void EventBehaviour::emit(const EventTrigger& trigger, const EventArgs& args) {
+    auto event = events.find(trigger);
+    if (event != events.end()) {
+        event->second.emit(args);
+    }
+}
+
+void EventBehaviour::enqueue(const EventTrigger& trigger, const EventArgs& args) {
+    MemoryTagScope tag{MemoryTag::EVENT};
+    auto found = queues.find(trigger);
+    if (found == queues.end()) {
+        // not registered as queued: default policy, delivered every time
+        register_event(trigger, EventCoalesce::NONE);
+        found = queues.find(trigger);
+    }
+    EventQueue& queue = found->second;
+    enqueuedSinceDispatch++;
+
+    if (!queue.active) {
+        queue.active = true;
+        bands[static_cast<size_t>(queue.priority)].push_back(&queue);
+    }
+
+    switch (queue.policy) {
+        case EventCoalesce::NONE:
+            queue.pending.push_back(args);
+            break;
+        case EventCoalesce::KEEP_LATEST:
+            if (queue.pending.empty()) {
+                queue.pending.push_back(args);
+            } else {
+                queue.pending[0] = args;
+            }
+            break;
+        case EventCoalesce::ACCUMULATE:
+            if (queue.pending.empty()) {
+                queue.pending.push_back(args);
+            } else {
+                EventArgs& sum = queue.pending[0];
+                sum.key = args.key;
+                for (int i = 0; i < 4; i++) {
+                    sum.values[i] += args.values[i];
+                }
+            }
+            break;
+        case EventCoalesce::DEDUPE_KEY: {
+            auto index = queue.keyIndex.find(args.key);
+            if (index == queue.keyIndex.end()) {
+                queue.keyIndex.emplace(args.key, static_cast<uint32_t>(queue.pending.size()));
+                queue.pending.push_back(args);
+            } else {
+                queue.pending[index->second] = args;
+            }
+            break;
+        }
+    }
+}
+
+void EventBehaviour::dispatch() {
+    MemoryTagScope tag{MemoryTag::EVENT};
+    queueStats.enqueued = enqueuedSinceDispatch;
+    queueStats.delivered = 0;
+    enqueuedSinceDispatch = 0;
+
+    // take every band first: anything subscribers enqueue, in any band, goes to next dispatch
+    for (size_t band = 0; band < static_cast<size_t>(EventPriority::COUNT); band++) {
+        delivering[band].swap(bands[band]);
+        bands[band].clear();
+        for (EventQueue* queue : delivering[band]) {
+            queue->delivering.swap(queue->pending);
+            queue->pending.clear();
+            queue->keyIndex.clear();
+            queue->active = false;
+        }
+    }
+
+    for (auto& band : delivering) {
+        for (EventQueue* queue : band) {
+            for (const EventArgs& args : queue->delivering) {
+                queue->event->emit(args);
+            }
+            queueStats.delivered += static_cast<uint32_t>(queue->delivering.size());
+            queue->delivering.clear();
+        }
+        band.clear();
+    }
+}
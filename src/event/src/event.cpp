@@ -1,11 +1,24 @@
 #include "event.hpp"
+#include "../../memory/src/allocationtracker.hpp"
 
 void Event::add(std::function<void()> callback) {
-    callbacks.push_back(callback);
+    callbacks.push_back(std::move(callback));
+}
+
+void Event::add(std::function<void(const EventArgs&)> callback) {
+    argCallbacks.push_back(std::move(callback));
 }
 
 void Event::emit() {
-    for (auto func : callbacks){
+    emit(EventArgs{});
+}
+
+void Event::emit(const EventArgs& args) {
+    MemoryTagScope tag{MemoryTag::EVENT};
+    for (auto& func : callbacks){
         func();
     }
-}
\ No newline at end of file
+    for (auto& func : argCallbacks){
+        func(args);
+    }
+}
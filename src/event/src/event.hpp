@@ -1,12 +1,26 @@
 #pragma once
 
 #include <functional>
+#include <vector>
+#include <cstdint>
+
+// Payload of queued events. key identifies source (creature, Part, window) for DEDUPE_KEY,
+// values are event specific: cursor delta, new window size...
+struct EventArgs {
+    uint64_t key = 0;
+    float values[4]{};
+};
 
 class Event{
 private:
     std::vector<std::function<void()>> callbacks{};
+    std::vector<std::function<void(const EventArgs&)>> argCallbacks{};
 
 public:
     void add(std::function<void()> callback);
+    void add(std::function<void(const EventArgs&)> callback);
     void emit();
-};
\ No newline at end of file
+    void emit(const EventArgs& args);
+
+    size_t size() const { return callbacks.size() + argCallbacks.size(); }
+};
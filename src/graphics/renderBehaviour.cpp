@@ -1,14 +1,94 @@
-#include "renderSystem.hpp"
+#include "renderBehaviour.hpp"
 
-RenderComponent::RenderComponent(Render* render)  {
+RenderPart::RenderPart(Render* render)  {
     _render = render;
-    shaders.push_back(Shader(render, "shaders/vert.spv", ShaderType::VERTEX));
-    shaders.push_back(Shader(render, "shaders/frag.spv", ShaderType::FRAGMENT));
-    pipelineCreate = new PipelineCreate(render, shaders, render->renderpass);
+    shaders.push_back(Shader(render, "shaders/shader.vert.spv", ShaderType::VERTEX));
+    shaders.push_back(Shader(render, "shaders/shader.frag.spv", ShaderType::FRAGMENT));
+    pipelineCreate.emplace(render, shaders, render->renderpass);
 }
 
-RenderComponent::~RenderComponent() {
-    if (pipelineCreate) {
-        delete pipelineCreate;
+RenderPart::~RenderPart() {
+    pipelineCreate.reset();
+}
+
+RenderBehaviour::~RenderBehaviour() {
+    for (auto& slot : parts) {
+        release(slot);
+    }
+}
+
+void RenderBehaviour::init() {
+    parts.reserve(64);
+    pool.reserve(64);
+}
+
+void RenderBehaviour::update() {
+    // parts of destroyed creatures, their pooled RenderParts go back to the pool
+    parts.removeDead(*creatures, [this](RenderSlot& slot) { release(slot); });
+}
+
+void RenderBehaviour::release(RenderSlot& slot) {
+    if (slot.owned) {
+        pool.destroy(slot.part);
+    }
+    slot.part = nullptr;
+}
+
+void RenderBehaviour::add(RenderPart* component) {
+    add(creatures->create(), component);
+}
+
+void RenderBehaviour::add(Creature creature, RenderPart* component) {
+    if (RenderSlot* slot = parts.displaced(creature)) {
+        release(*slot);
+    }
+    parts.add(creature, RenderSlot{component, false});
+}
+
+RenderPart* RenderBehaviour::create(Creature creature, Render* render) {
+    if (!creatures->alive(creature)) {
+        return nullptr;
+    }
+    RenderPart* part = pool.create(render);
+    if (RenderSlot* slot = parts.displaced(creature)) {
+        release(*slot);
+    }
+    parts.add(creature, RenderSlot{part, true});
+    return part;
+}
+
+void RenderBehaviour::remove(Creature creature) {
+    if (RenderSlot* slot = parts.get(creature)) {
+        release(*slot);
+        parts.remove(creature);
     }
-}
\ No newline at end of file
+}
+
+RenderPart* RenderBehaviour::get(Creature creature) {
+    if (!creatures->alive(creature)) {
+        return nullptr;
+    }
+    RenderSlot* slot = parts.get(creature);
+    return slot ? slot->part : nullptr;
+}
+
+void RenderBehaviour::buildDrawList(const Frustum& frustum, std::pmr::vector<DrawItem>& out) {
+    if (spatial == nullptr) {
+        const Creature* owners = parts.owners();
+        for (size_t i = 0; i < parts.size(); i++) {
+            if (creatures->alive(owners[i])) {
+                out.push_back(DrawItem{owners[i], parts.data()[i].part});
+            }
+        }
+        return;
+    }
+
+    std::pmr::vector<Creature> visible{out.get_allocator().resource()};
+    visible.reserve(parts.size());
+    spatial->queryFrustum(frustum, visible);
+    for (Creature creature : visible) {
+        if (RenderSlot* slot = parts.get(creature)) {
+            out.push_back(DrawItem{creature, slot->part});
+        }
+    }
+}
@@ -1,17 +1,22 @@
 #include <System.hpp>
+#include <Creature.hpp>
+#include <SparseSet.hpp>
 #include <vector>
 #include <string>
 #include <memory>
+#include <optional>
 #include "src/pipeline/pipelinecreate.hpp"
 #include "src/render.hpp"
 #include "src/pipeline/shader.hpp"
+#include "../memory/src/pool.hpp"
+#include "../spatial/spatialBehaviour.hpp"
 #include <tuple>
 #include <unordered_map>
 
 class RenderPart {
 private:
     Render* _render;
-    PipelineCreate* pipelineCreate;
+    std::optional<PipelineCreate> pipelineCreate{}; // inline, part is one fixed size block
     std::vector<Shader> shaders;
 
 public:
@@ -19,11 +24,50 @@ public:
     ~RenderPart();
 };
 
+struct DrawItem {
+    Creature creature;
+    RenderPart* part;
+};
+
 class RenderBehaviour : public System<RenderPart> {
 private:
-    std::vector<RenderPart*> components;
+    struct RenderSlot {
+        RenderPart* part;
+        bool owned;                     // from pool, destroyed with creature
+    };
+
+    CreatureRegistry<>* creatures;
+    SpatialBehaviour* spatial = nullptr;
+    SparseSet<RenderSlot> parts{};
+    ObjectPool<RenderPart> pool{};
+
+    void release(RenderSlot& slot);
+
 public:
+    RenderBehaviour(CreatureRegistry<>* creatures) : creatures(creatures) {}
+    ~RenderBehaviour();
+
     void init();
+    // Releases parts of destroyed creatures
     void update();
+
+    // Part without creature, gets a new creature from registry
     void add(RenderPart* component);
-};
\ No newline at end of file
+    // Caller keeps ownership of part
+    void add(Creature creature, RenderPart* component);
+
+    // Allocates part from pool for creature
+    RenderPart* create(Creature creature, Render* render);
+    void remove(Creature creature);
+
+    // nullptr for stale creature or creature without render part
+    RenderPart* get(Creature creature);
+
+    // Visible parts come from spatial index instead of testing every creature.
+    // Set by the application once both behaviours exist (bench: spatial_draw_list_100k).
+    void setSpatial(SpatialBehaviour* spatialBehaviour) { spatial = spatialBehaviour; }
+
+    // Appends parts visible in frustum; without spatial index every part is drawn.
+    // out usually lives in Render::frameAllocator.
+    void buildDrawList(const Frustum& frustum, std::pmr::vector<DrawItem>& out);
+};
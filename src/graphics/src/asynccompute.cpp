@@ -0,0 +1,212 @@
+#include "asynccompute.hpp"
+#include "render.hpp"
+#include <stdexcept>
+#include <iostream>
+
+AsyncCompute::AsyncCompute(Render* render){
+    std::cout << "Creating async compute" << std::endl;
+
+    _render = render;
+    queue = render->computeQueue;
+    queueFamily = render->computeQueueFamilyIndex;
+    dedicated = queueFamily != render->graphicsQueueFamilyIndex;
+    sharedFamilies[0] = render->graphicsQueueFamilyIndex;
+    sharedFamilies[1] = queueFamily;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamily;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    if (vkCreateCommandPool(render->device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create compute command pool");
+    }
+
+    commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    recording.assign(MAX_FRAMES_IN_FLIGHT, false);
+    submitted.assign(MAX_FRAMES_IN_FLIGHT, false);
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+    if (vkAllocateCommandBuffers(render->device, &allocInfo, commandBuffers.data()) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate compute command buffers");
+    }
+
+    useTimeline = render->capabilities.timelineSemaphore;
+    if (useTimeline){
+        VkSemaphoreTypeCreateInfo typeCreateInfo{};
+        typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeCreateInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreCreateInfo.pNext = &typeCreateInfo;
+        if (vkCreateSemaphore(render->device, &semaphoreCreateInfo, nullptr, &timeline) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create compute timeline semaphore");
+        }
+        // same queue orders graphics before compute by submission order and barriers, no semaphore needed
+        if (dedicated && vkCreateSemaphore(render->device, &semaphoreCreateInfo, nullptr, &graphicsTimeline) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create graphics timeline semaphore");
+        }
+    } else {
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        finished.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto& semaphore : finished){
+            if (vkCreateSemaphore(render->device, &semaphoreCreateInfo, nullptr, &semaphore) != VK_SUCCESS){
+                throw std::runtime_error("Failed to create compute semaphores");
+            }
+        }
+    }
+
+    std::cout << "\tQueue: " << (dedicated ? "dedicated compute family " : "graphics family ") << queueFamily << std::endl;
+    std::cout << "\tSemaphores: " << (useTimeline ? "timeline" : "binary") << std::endl;
+    std::cout << "Async compute created successfully" << std::endl << std::endl;
+}
+
+AsyncCompute::~AsyncCompute(){
+    VkDevice device = _render->device;
+
+    if (timeline != VK_NULL_HANDLE){
+        vkDestroySemaphore(device, timeline, nullptr);
+    }
+    if (graphicsTimeline != VK_NULL_HANDLE){
+        vkDestroySemaphore(device, graphicsTimeline, nullptr);
+    }
+    for (auto semaphore : finished){
+        vkDestroySemaphore(device, semaphore, nullptr);
+    }
+    if (!commandBuffers.empty()){
+        vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+    }
+    vkDestroyCommandPool(device, commandPool, nullptr);
+}
+
+VkCommandBuffer AsyncCompute::commands(uint32_t frame){
+    if (submitted[frame]){
+        throw std::runtime_error("Async compute of this frame was already submitted");
+    }
+
+    VkCommandBuffer commandBuffer = commandBuffers[frame];
+    if (!recording[frame]){
+        vkResetCommandBuffer(commandBuffer, 0);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        recording[frame] = true;
+    }
+    return commandBuffer;
+}
+
+void AsyncCompute::submit(uint32_t frame, VkPipelineStageFlags graphicsWaitStage){
+    if (!recording[frame]){
+        return;
+    }
+    VkCommandBuffer commandBuffer = commandBuffers[frame];
+    vkEndCommandBuffer(commandBuffer);
+    recording[frame] = false;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+
+    // scheduled work reads graphics output: wait for last graphics submit (previous frame)
+    uint64_t graphicsWaitValue = graphicsValue;
+    if (computeWaitStages != 0 && graphicsTimeline != VK_NULL_HANDLE){
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &graphicsTimeline;
+        submitInfo.pWaitDstStageMask = &computeWaitStages;
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+    uint64_t signalValue = 0;
+    if (useTimeline){
+        signalValue = ++timelineValue;
+        timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineSubmitInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+        timelineSubmitInfo.pWaitSemaphoreValues = &graphicsWaitValue;
+        timelineSubmitInfo.signalSemaphoreValueCount = 1;
+        timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
+        submitInfo.pNext = &timelineSubmitInfo;
+        submitInfo.pSignalSemaphores = &timeline;
+    } else {
+        submitInfo.pSignalSemaphores = &finished[frame];
+    }
+
+    if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS){
+        throw std::runtime_error("Failed to submit async compute");
+    }
+    computeWaitStages = 0;
+    graphicsWaitStages = 0;
+
+    submitted[frame] = true;
+    waitPending = true;
+    waitSemaphore = useTimeline ? timeline : finished[frame];
+    waitValue = signalValue;
+    waitStage = graphicsWaitStage;
+}
+
+void AsyncCompute::schedule(uint32_t frame, VkCommandBuffer graphicsCommands, const std::function<void(VkCommandBuffer, bool)>& record,
+                            VkPipelineStageFlags computeWaitStage, VkPipelineStageFlags graphicsWaitStage){
+    if (computeWaitStage != 0 && dedicated && graphicsTimeline == VK_NULL_HANDLE){
+        record(graphicsCommands, true);
+        return;
+    }
+    record(commands(frame), !dedicated);
+    computeWaitStages |= computeWaitStage;
+    graphicsWaitStages |= graphicsWaitStage;
+}
+
+bool AsyncCompute::graphicsWait(VkSemaphore* semaphore, uint64_t* value, VkPipelineStageFlags* stage, bool* timelineSemaphore){
+    uint32_t frame = _render->currentFrame;
+
+    // scheduled work, or recorded but never submitted: submit now, graphics must not run ahead of it
+    if (recording[frame]){
+        submit(frame, graphicsWaitStages != 0 ? graphicsWaitStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    }
+    submitted[frame] = false;
+
+    if (!waitPending){
+        return false;
+    }
+    waitPending = false;
+    *semaphore = waitSemaphore;
+    *value = waitValue;
+    *stage = waitStage;
+    *timelineSemaphore = useTimeline;
+    return true;
+}
+
+bool AsyncCompute::graphicsSignal(VkSemaphore* semaphore, uint64_t* value){
+    if (graphicsTimeline == VK_NULL_HANDLE){
+        return false;
+    }
+    *semaphore = graphicsTimeline;
+    *value = ++graphicsValue;
+    return true;
+}
+
+void AsyncCompute::shareBuffer(VkBufferCreateInfo& createInfo) const {
+    if (!dedicated){
+        return;
+    }
+    createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    createInfo.queueFamilyIndexCount = 2;
+    createInfo.pQueueFamilyIndices = sharedFamilies;
+}
+
+void AsyncCompute::shareImage(VkImageCreateInfo& createInfo) const {
+    if (!dedicated){
+        return;
+    }
+    createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    createInfo.queueFamilyIndexCount = 2;
+    createInfo.pQueueFamilyIndices = sharedFamilies;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+// forward declaration
+class Render;
+
+// Compute work that overlaps graphics (culling, particles, skinning, post processing).
+// Uses dedicated compute queue family when device has one; otherwise the same calls submit
+// to graphics queue, so callers never branch on hardware.
+//
+// Per frame: schedule(frame, ...) any number of times, drawFrame submits what was recorded just
+// before the graphics submit. Dependencies are semaphores in both directions:
+//   graphics -> compute: compute waits at computeWaitStage for graphics of previous frames
+//                        (e.g. particles drawn last frame from buffers compute rewrites)
+//   compute -> graphics: graphics of this frame waits at graphicsWaitStage only, earlier stages overlap
+// Lower level commands(frame) / submit(frame, stage) have no graphics -> compute wait.
+class AsyncCompute {
+private:
+    Render* _render;
+    VkQueue queue{};
+    uint32_t queueFamily = 0;
+    bool dedicated = false;
+    uint32_t sharedFamilies[2]{};                   // graphics + compute, for concurrent sharing
+
+    VkCommandPool commandPool{};
+    std::vector<VkCommandBuffer> commandBuffers{};  // per frame slot
+    std::vector<bool> recording{};
+    std::vector<bool> submitted{};
+
+    // compute finished: one timeline semaphore, or binary semaphore per slot without timeline support
+    bool useTimeline = false;
+    VkSemaphore timeline{};
+    uint64_t timelineValue = 0;
+    std::vector<VkSemaphore> finished{};
+
+    // graphics finished, timeline; signaled by every graphics submit when queue is dedicated
+    VkSemaphore graphicsTimeline{};
+    uint64_t graphicsValue = 0;
+
+    // stages accumulated by schedule() for frame being recorded
+    VkPipelineStageFlags computeWaitStages = 0;
+    VkPipelineStageFlags graphicsWaitStages = 0;
+
+    // wait handed to next graphics submit
+    bool waitPending = false;
+    VkSemaphore waitSemaphore{};
+    uint64_t waitValue = 0;
+    VkPipelineStageFlags waitStage = 0;
+
+public:
+    AsyncCompute(Render* render);
+    ~AsyncCompute();
+
+    bool isDedicated() const { return dedicated; }
+    uint32_t family() const { return queueFamily; }
+
+    // Command buffer for this frame's compute work, begun on first call of frame.
+    // Safe to reuse once slot's graphics fence is signaled, because graphics waited for it.
+    VkCommandBuffer commands(uint32_t frame);
+
+    // Submits work recorded for frame; graphics submit of frame waits for it at graphicsWaitStage
+    void submit(uint32_t frame, VkPipelineStageFlags graphicsWaitStage);
+
+    // Render thread, while recording frame: record(commandBuffer, graphicsStages) adds compute work.
+    // computeWaitStage: compute stages that read what earlier graphics submits wrote, 0 none.
+    // graphicsWaitStage: graphics stages of this frame that read what compute wrote.
+    // graphicsStages tells record whether barriers may name graphics stages (false on compute family).
+    // A dedicated queue without timeline semaphores cannot wait for graphics: such work is recorded
+    // into graphicsCommands instead, ordered by its barriers.
+    void schedule(uint32_t frame, VkCommandBuffer graphicsCommands, const std::function<void(VkCommandBuffer, bool)>& record,
+                  VkPipelineStageFlags computeWaitStage, VkPipelineStageFlags graphicsWaitStage);
+
+    // Render::drawFrame: semaphore graphics submit must wait on, false when nothing was submitted
+    bool graphicsWait(VkSemaphore* semaphore, uint64_t* value, VkPipelineStageFlags* stage, bool* timelineSemaphore);
+    // Render::drawFrame: timeline semaphore and value graphics submit signals, false when not needed
+    bool graphicsSignal(VkSemaphore* semaphore, uint64_t* value);
+
+    // Resources written on one queue and read on other are shared concurrently, no ownership transfers.
+    // Call on create info of every such buffer; no-op without dedicated queue.
+    void shareBuffer(VkBufferCreateInfo& createInfo) const;
+    void shareImage(VkImageCreateInfo& createInfo) const;
+};
@@ -0,0 +1,285 @@
+#include "capabilities.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#define DEVICE_CAPABILITIES_CACHE_MAGIC 0x43434442u // "BDCC"
+#define DEVICE_CAPABILITIES_CACHE_VERSION 2u
+
+static_assert(std::is_trivially_copyable<DeviceCapabilities>::value, "DeviceCapabilities is cached as raw bytes");
+
+struct DeviceCapabilitiesCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entrySize;  // layout changed -> whole file is ignored
+    uint32_t count;
+};
+
+DeviceCapabilities queryDeviceCapabilities(VkPhysicalDevice physicalDevice){
+    DeviceCapabilities capabilities{};
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    memcpy(capabilities.deviceName, properties.deviceName, sizeof(capabilities.deviceName));
+    capabilities.vendorID = properties.vendorID;
+    capabilities.deviceID = properties.deviceID;
+    capabilities.driverVersion = properties.driverVersion;
+    capabilities.apiVersion = properties.apiVersion;
+    memcpy(capabilities.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    capabilities.deviceType = properties.deviceType;
+
+    const VkPhysicalDeviceLimits& limits = properties.limits;
+    capabilities.timestampPeriod = limits.timestampPeriod;
+    capabilities.timestampComputeAndGraphics = limits.timestampComputeAndGraphics == VK_TRUE;
+    capabilities.maxSamplerAnisotropy = limits.maxSamplerAnisotropy;
+    capabilities.maxImageDimension2D = limits.maxImageDimension2D;
+    capabilities.maxPushConstantsSize = limits.maxPushConstantsSize;
+    capabilities.maxBoundDescriptorSets = limits.maxBoundDescriptorSets;
+    capabilities.maxPerStageDescriptorSamplers = std::min(limits.maxPerStageDescriptorSamplers, limits.maxPerStageDescriptorSampledImages);
+    capabilities.maxDrawIndirectCount = limits.maxDrawIndirectCount;
+    capabilities.maxComputeWorkGroupInvocations = limits.maxComputeWorkGroupInvocations;
+    for (int i = 0; i < 3; i++){
+        capabilities.maxComputeWorkGroupCount[i] = limits.maxComputeWorkGroupCount[i];
+    }
+    capabilities.minUniformBufferOffsetAlignment = limits.minUniformBufferOffsetAlignment;
+    capabilities.minStorageBufferOffsetAlignment = limits.minStorageBufferOffsetAlignment;
+
+    // Memory
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++){
+        if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT){
+            capabilities.deviceLocalMemory += memoryProperties.memoryHeaps[i].size;
+        }
+    }
+
+    // Queues
+    uint32_t queueFamilyPropertiesCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilyProperties{queueFamilyPropertiesCount};
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, queueFamilyProperties.data());
+
+    capabilities.queueFamilyCount = queueFamilyPropertiesCount;
+    capabilities.graphicsQueueFamily = NO_QUEUE_FAMILY;
+    capabilities.computeQueueFamily = NO_QUEUE_FAMILY;
+    capabilities.transferQueueFamily = NO_QUEUE_FAMILY;
+    for (uint32_t i = 0; i < queueFamilyPropertiesCount; i++){
+        VkQueueFlags flags = queueFamilyProperties[i].queueFlags;
+        bool graphics = flags & VK_QUEUE_GRAPHICS_BIT;
+        bool compute = flags & VK_QUEUE_COMPUTE_BIT;
+        bool transfer = flags & VK_QUEUE_TRANSFER_BIT;
+
+        if (graphics && compute && capabilities.graphicsQueueFamily == NO_QUEUE_FAMILY){
+            capabilities.graphicsQueueFamily = i;
+            capabilities.timestampValidBits = queueFamilyProperties[i].timestampValidBits;
+        }
+        if (compute && !graphics && capabilities.computeQueueFamily == NO_QUEUE_FAMILY){
+            capabilities.computeQueueFamily = i;
+        }
+        if (transfer && !graphics && !compute && capabilities.transferQueueFamily == NO_QUEUE_FAMILY){
+            capabilities.transferQueueFamily = i;
+        }
+    }
+
+    // Extensions
+    uint32_t availableExtensionsCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &availableExtensionsCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions{availableExtensionsCount};
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &availableExtensionsCount, availableExtensions.data());
+
+    auto extensionAvailable = [&](const char* name){
+        for (const auto& extension : availableExtensions){
+            if (strcmp(extension.extensionName, name) == 0){
+                return true;
+            }
+        }
+        return false;
+    };
+
+    capabilities.swapchain = extensionAvailable(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    capabilities.memoryBudget = extensionAvailable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    bool presentWaitExtensions = extensionAvailable(VK_KHR_PRESENT_ID_EXTENSION_NAME) && extensionAvailable(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+    // Features, core structs only exist on devices of that version
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    void** next = &features2.pNext;
+
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    if (properties.apiVersion >= VK_API_VERSION_1_2){
+        *next = &features12;
+        next = &features12.pNext;
+    }
+
+    VkPhysicalDeviceVulkan13Features features13{};
+    features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    if (properties.apiVersion >= VK_API_VERSION_1_3){
+        *next = &features13;
+        next = &features13.pNext;
+    }
+
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    if (presentWaitExtensions){
+        *next = &presentIdFeatures;
+        presentIdFeatures.pNext = &presentWaitFeatures;
+    }
+
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+    capabilities.samplerAnisotropy = features2.features.samplerAnisotropy == VK_TRUE;
+    capabilities.multiDrawIndirect = features2.features.multiDrawIndirect == VK_TRUE;
+    capabilities.drawIndirectFirstInstance = features2.features.drawIndirectFirstInstance == VK_TRUE;
+    capabilities.pipelineStatisticsQuery = features2.features.pipelineStatisticsQuery == VK_TRUE;
+    capabilities.timelineSemaphore = features12.timelineSemaphore == VK_TRUE;
+    capabilities.descriptorIndexing = features12.runtimeDescriptorArray == VK_TRUE &&
+                                      features12.descriptorBindingPartiallyBound == VK_TRUE &&
+                                      features12.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+    capabilities.synchronization2 = features13.synchronization2 == VK_TRUE;
+    capabilities.dynamicRendering = features13.dynamicRendering == VK_TRUE;
+    capabilities.presentWait = presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
+
+    return capabilities;
+}
+
+uint32_t findPresentQueueFamily(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, const DeviceCapabilities& capabilities){
+    VkBool32 supported = VK_FALSE;
+    if (capabilities.graphicsQueueFamily != NO_QUEUE_FAMILY){
+        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, capabilities.graphicsQueueFamily, surface, &supported);
+        if (supported == VK_TRUE){
+            return capabilities.graphicsQueueFamily;
+        }
+    }
+
+    for (uint32_t i = 0; i < capabilities.queueFamilyCount; i++){
+        supported = VK_FALSE;
+        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &supported);
+        if (supported == VK_TRUE){
+            return i;
+        }
+    }
+    return NO_QUEUE_FAMILY;
+}
+
+int64_t scoreDevice(const DeviceCapabilities& capabilities, uint32_t presentQueueFamily){
+    if (capabilities.graphicsQueueFamily == NO_QUEUE_FAMILY || presentQueueFamily == NO_QUEUE_FAMILY || !capabilities.swapchain){
+        return -1;
+    }
+
+    int64_t score = 0;
+
+    switch (capabilities.deviceType){
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   score += 100000; break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: score += 50000; break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    score += 20000; break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:            score += 1000; break;
+        default: break;
+    }
+
+    // 1 point per 16 MiB, capped so memory never outweighs device type
+    score += static_cast<int64_t>(std::min<VkDeviceSize>(capabilities.deviceLocalMemory >> 24, 10000));
+
+    // Queue topology: async compute, DMA transfers, present without ownership transfer
+    if (capabilities.computeQueueFamily != NO_QUEUE_FAMILY) score += 2000;
+    if (capabilities.transferQueueFamily != NO_QUEUE_FAMILY) score += 1000;
+    if (presentQueueFamily == capabilities.graphicsQueueFamily) score += 1000;
+
+    for (bool feature : {capabilities.timelineSemaphore, capabilities.descriptorIndexing, capabilities.synchronization2,
+                         capabilities.dynamicRendering, capabilities.presentWait, capabilities.memoryBudget,
+                         capabilities.multiDrawIndirect, capabilities.pipelineStatisticsQuery}){
+        if (feature) score += 500;
+    }
+
+    return score;
+}
+
+void printDeviceCapabilities(const DeviceCapabilities& capabilities){
+    auto yesNo = [](bool value){ return value ? "yes" : "no"; };
+    auto family = [](uint32_t index){ return index == NO_QUEUE_FAMILY ? std::string("none") : std::to_string(index); };
+
+    std::cout << "\tCapabilities of " << capabilities.deviceName << std::endl;
+    std::cout << "\t\tApi Version: " << VK_API_VERSION_MAJOR(capabilities.apiVersion) << "." << VK_API_VERSION_MINOR(capabilities.apiVersion)
+              << "." << VK_API_VERSION_PATCH(capabilities.apiVersion) << std::endl;
+    std::cout << "\t\tDevice local memory: " << (capabilities.deviceLocalMemory >> 20) << " MiB" << std::endl;
+    std::cout << "\t\tQueue families: graphics " << family(capabilities.graphicsQueueFamily)
+              << ", compute " << family(capabilities.computeQueueFamily)
+              << ", transfer " << family(capabilities.transferQueueFamily) << std::endl;
+    std::cout << "\t\tTimeline semaphores: " << yesNo(capabilities.timelineSemaphore) << std::endl;
+    std::cout << "\t\tDescriptor indexing: " << yesNo(capabilities.descriptorIndexing) << std::endl;
+    std::cout << "\t\tSynchronization2: " << yesNo(capabilities.synchronization2) << std::endl;
+    std::cout << "\t\tDynamic rendering: " << yesNo(capabilities.dynamicRendering) << std::endl;
+    std::cout << "\t\tPresent wait: " << yesNo(capabilities.presentWait) << std::endl;
+    std::cout << "\t\tMemory budget: " << yesNo(capabilities.memoryBudget) << std::endl;
+    std::cout << "\t\tPipeline statistics: " << yesNo(capabilities.pipelineStatisticsQuery) << std::endl;
+    std::cout << "\t\tTimestamps: " << capabilities.timestampValidBits << " bits, " << capabilities.timestampPeriod << " ns" << std::endl;
+}
+
+DeviceCapabilitiesCache::DeviceCapabilitiesCache(const std::string& path) : path(path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file){
+        return;
+    }
+
+    DeviceCapabilitiesCacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != DEVICE_CAPABILITIES_CACHE_MAGIC ||
+        header.version != DEVICE_CAPABILITIES_CACHE_VERSION ||
+        header.entrySize != sizeof(DeviceCapabilities)){
+        return;
+    }
+
+    entries.resize(header.count);
+    if (!file.read(reinterpret_cast<char*>(entries.data()), sizeof(DeviceCapabilities) * header.count)){
+        entries.clear();
+    }
+}
+
+const DeviceCapabilities* DeviceCapabilitiesCache::find(const VkPhysicalDeviceProperties& properties) const {
+    for (const auto& entry : entries){
+        if (entry.vendorID == properties.vendorID &&
+            entry.deviceID == properties.deviceID &&
+            entry.driverVersion == properties.driverVersion &&
+            entry.apiVersion == properties.apiVersion &&
+            memcmp(entry.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0){
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void DeviceCapabilitiesCache::store(const DeviceCapabilities& capabilities){
+    // same device with older driver is replaced, not kept next to new one
+    for (auto& entry : entries){
+        if (entry.vendorID == capabilities.vendorID && entry.deviceID == capabilities.deviceID){
+            entry = capabilities;
+            dirty = true;
+            return;
+        }
+    }
+    entries.push_back(capabilities);
+    dirty = true;
+}
+
+void DeviceCapabilitiesCache::save(){
+    if (!dirty){
+        return;
+    }
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file){
+        std::cout << "\tFailed to write device capabilities cache " << path << std::endl;
+        return;
+    }
+
+    DeviceCapabilitiesCacheHeader header{DEVICE_CAPABILITIES_CACHE_MAGIC, DEVICE_CAPABILITIES_CACHE_VERSION,
+                                         sizeof(DeviceCapabilities), static_cast<uint32_t>(entries.size())};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), sizeof(DeviceCapabilities) * entries.size());
+    dirty = false;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#define DEVICE_CAPABILITIES_CACHE "device_capabilities.cache"
+#define NO_QUEUE_FAMILY UINT32_MAX
+
+// Everything engine reads about physical device, queried once at startup.
+// Trivially copyable, so it is cached on disk as is.
+struct DeviceCapabilities {
+    // Identity, also cache key
+    char deviceName[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE];
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint32_t apiVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];   // changes with driver build
+    VkPhysicalDeviceType deviceType;
+    VkDeviceSize deviceLocalMemory;            // sum of device local heaps
+
+    // Queue topology, NO_QUEUE_FAMILY when missing
+    uint32_t queueFamilyCount;
+    uint32_t graphicsQueueFamily;              // graphics + compute
+    uint32_t computeQueueFamily;               // compute without graphics (async compute)
+    uint32_t transferQueueFamily;              // transfer only (DMA engine)
+    uint32_t timestampValidBits;               // of graphics family, 0 = no timestamps
+
+    // Required
+    bool swapchain;
+
+    // Optional features and extensions, enabled at device creation when true
+    bool timelineSemaphore;
+    bool descriptorIndexing;                   // runtime arrays, partially bound, non uniform sampled images
+    bool synchronization2;
+    bool dynamicRendering;
+    bool presentWait;                          // VK_KHR_present_id + VK_KHR_present_wait
+    bool memoryBudget;                         // VK_EXT_memory_budget
+    bool samplerAnisotropy;
+    bool multiDrawIndirect;
+    bool drawIndirectFirstInstance;
+    bool pipelineStatisticsQuery;
+
+    // Limits
+    float timestampPeriod;                     // ns per timestamp tick
+    bool timestampComputeAndGraphics;
+    float maxSamplerAnisotropy;
+    uint32_t maxImageDimension2D;
+    uint32_t maxPushConstantsSize;
+    uint32_t maxBoundDescriptorSets;
+    uint32_t maxPerStageDescriptorSamplers;    // combined image samplers count against samplers and sampled images
+    uint32_t maxDrawIndirectCount;
+    uint32_t maxComputeWorkGroupInvocations;
+    uint32_t maxComputeWorkGroupCount[3];
+    VkDeviceSize minUniformBufferOffsetAlignment;
+    VkDeviceSize minStorageBufferOffsetAlignment;
+};
+
+// Surface independent part, the slow one (features, extensions, memory, queues)
+DeviceCapabilities queryDeviceCapabilities(VkPhysicalDevice physicalDevice);
+
+// Graphics family when it can present (no ownership transfer), else any family that can
+uint32_t findPresentQueueFamily(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, const DeviceCapabilities& capabilities);
+
+// Higher is better, negative when device can not run engine at all.
+// Device type dominates, so discrete GPU always wins over integrated one on hybrid hosts.
+int64_t scoreDevice(const DeviceCapabilities& capabilities, uint32_t presentQueueFamily);
+
+void printDeviceCapabilities(const DeviceCapabilities& capabilities);
+
+// Capabilities from previous runs, keyed by device, driver and api version
+class DeviceCapabilitiesCache {
+private:
+    std::string path;
+    std::vector<DeviceCapabilities> entries{};
+    bool dirty = false;
+
+public:
+    DeviceCapabilitiesCache(const std::string& path);
+
+    // nullptr when device or its driver changed since entry was stored
+    const DeviceCapabilities* find(const VkPhysicalDeviceProperties& properties) const;
+    void store(const DeviceCapabilities& capabilities);
+
+    // Writes file when something was stored
+    void save();
+};
@@ -27,10 +27,12 @@ void Render::createCommandBuffers(){
     std::cout << "Command Buffers created successfully" << std::endl << std::endl;
 }
 
-void Render::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex){
+void Render::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, const RenderCommandBuffer& commands){
     vkResetCommandBuffer(commandBuffer, 0);
 
-    if (imageIndex >= framebuffers.size()) {
+    // no scene target only in HeadlessRender, its render pass ends in a layout for its own framebuffers
+    bool scaled = sceneFramebuffer != VK_NULL_HANDLE;
+    if (!scaled && imageIndex >= framebuffers.size()) {
         std::cout << "ERROR: Framebuffer index out of bounds!" << std::endl;
         return;
     }
@@ -46,23 +48,60 @@ void Render::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIn
     renderPassInfo.renderPass = renderpass;
     renderPassInfo.pClearValues = &clearValue;
     renderPassInfo.clearValueCount = 1;
-    renderPassInfo.framebuffer = framebuffers[imageIndex];
+    renderPassInfo.framebuffer = scaled ? sceneFramebuffer : framebuffers[imageIndex];
     renderPassInfo.renderArea.offset = { 0, 0 };
-    renderPassInfo.renderArea.extent = extent;
+    renderPassInfo.renderArea.extent = scaled ? renderExtent : extent;
 
     vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
 
+    if (timestampQueryPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, timestampQueryPool, currentFrame * 2, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampQueryPool, currentFrame * 2);
+    }
+    stats.beginFrame(commandBuffer, currentFrame);
+
+    // Compute and transfers of commands, render pass can not contain them
+    stats.beginPass(commandBuffer, currentFrame, StatisticsPass::PRE_PASS);
+    if (!prePassHandlers.empty()) {
+        commands.forEach([&](RenderCommandType type, const void* payload){
+            auto handler = prePassHandlers.find(type);
+            if (handler != prePassHandlers.end()) {
+                handler->second(commandBuffer, payload);
+            }
+        });
+    }
+    stats.endPass(commandBuffer, currentFrame, StatisticsPass::PRE_PASS);
+
     vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    stats.beginPass(commandBuffer, currentFrame, StatisticsPass::SCENE);
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
     std::cout << "viewport: " << "x: " << viewportState.pViewports->x << " y: " << viewportState.pViewports->y << " width: " << viewportState.pViewports->width << " height: " << viewportState.pViewports->height << std::endl;
 
     vkCmdSetViewport(commandBuffer, 0, viewportState.viewportCount, viewportState.pViewports);
     vkCmdSetScissor(commandBuffer, 0, viewportState.scissorCount, viewportState.pScissors);
 
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    stats.draw(commandBuffer, 3, 1, 0, 0);
 
+    // Commands from game thread
+    commands.forEach([&](RenderCommandType type, const void* payload){
+        auto handler = commandHandlers.find(type);
+        if (handler != commandHandlers.end()) {
+            handler->second(commandBuffer, payload);
+        }
+    });
+
+    stats.endPass(commandBuffer, currentFrame, StatisticsPass::SCENE);
     vkCmdEndRenderPass(commandBuffer);
+
+    if (scaled) {
+        recordUpscale(commandBuffer, imageIndex);
+    }
+
+    if (timestampQueryPool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, currentFrame * 2 + 1);
+    }
+
     vkEndCommandBuffer(commandBuffer);
 }
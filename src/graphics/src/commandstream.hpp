@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+using RenderCommandType = uint16_t;
+
+struct RenderCommandHeader {
+    RenderCommandType type;
+    uint16_t size;  // payload size in bytes
+};
+
+// Linear list of POD commands written by game thread and replayed by render thread
+class RenderCommandBuffer {
+private:
+    std::vector<uint8_t> data{};
+    uint32_t count = 0;
+
+public:
+    float alpha = 0.0f;   // interpolation factor between last two simulation steps
+    uint64_t frame = 0;   // simulation frame that produced commands
+    uint64_t inputTimestamp = 0; // steady clock ns of input sample used for this frame (latency tracking)
+
+    template<typename T>
+    void push(RenderCommandType type, const T& command){
+        static_assert(std::is_trivially_copyable<T>::value, "Render commands must be trivially copyable");
+        static_assert(sizeof(T) <= UINT16_MAX, "Render command is too big");
+
+        RenderCommandHeader header{type, static_cast<uint16_t>(sizeof(T))};
+        size_t offset = data.size();
+        data.resize(offset + sizeof(header) + sizeof(T));
+        memcpy(data.data() + offset, &header, sizeof(header));
+        memcpy(data.data() + offset + sizeof(header), &command, sizeof(T));
+        count++;
+    }
+
+    // function(RenderCommandType type, const void* payload)
+    template<typename F>
+    void forEach(F&& function) const {
+        size_t offset = 0;
+        while (offset < data.size()){
+            RenderCommandHeader header;
+            memcpy(&header, data.data() + offset, sizeof(header));
+            function(header.type, data.data() + offset + sizeof(header));
+            offset += sizeof(header) + header.size;
+        }
+    }
+
+    // keeps capacity, so steady state frames do not allocate
+    void clear(){
+        data.clear();
+        count = 0;
+    }
+
+    uint32_t size() const { return count; }
+};
+
+// Double buffered hand off: game thread fills one buffer while render thread replays the other
+class RenderCommandStream {
+private:
+    RenderCommandBuffer buffers[2];
+    uint32_t writeIndex = 0;
+    bool published = false;  // buffers[writeIndex ^ 1] is ready for render thread
+    bool reading = false;    // render thread is replaying buffers[writeIndex ^ 1]
+    bool stopped = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+public:
+    // Game thread
+    RenderCommandBuffer& writeBuffer() { return buffers[writeIndex]; }
+
+    // Game thread: index of write buffer, render thread is done with it until next submit()
+    uint32_t writeSlot() const { return writeIndex; }
+
+    // Game thread: publishes write buffer, waits while render thread is still busy with previous one
+    void submit(){
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait(lock, [this]{ return stopped || (!published && !reading); });
+        if (stopped){
+            return;
+        }
+        writeIndex ^= 1;
+        published = true;
+        buffers[writeIndex].clear();
+        condition.notify_all();
+    }
+
+    // Render thread: waits for published buffer, nullptr when stream is stopped
+    const RenderCommandBuffer* acquire(){
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait(lock, [this]{ return stopped || published; });
+        if (stopped){
+            return nullptr;
+        }
+        published = false;
+        reading = true;
+        return &buffers[writeIndex ^ 1];
+    }
+
+    // Render thread: buffer from acquire() is no longer used
+    void release(){
+        std::lock_guard<std::mutex> lock{mutex};
+        reading = false;
+        condition.notify_all();
+    }
+
+    void stop(){
+        std::lock_guard<std::mutex> lock{mutex};
+        stopped = true;
+        condition.notify_all();
+    }
+};
@@ -0,0 +1,97 @@
+#include "deletionqueue.hpp"
+#include "render.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+void DeletionQueue::push(VkObjectType type, uint64_t handle, VkSemaphore timeline, uint64_t value){
+    if (handle == 0){
+        return;
+    }
+    uint64_t frame = 0;
+    if (timeline == VK_NULL_HANDLE){
+        frame = recordingFrame.load();
+        if (std::this_thread::get_id() != renderThread.load(std::memory_order_relaxed)){
+            frame++;
+        }
+    }
+    std::lock_guard<std::mutex> lock{mutex};
+    entries.push_back({type, handle, frame, timeline, value});
+}
+
+void DeletionQueue::destroyObject(const Entry& entry){
+    VkDevice device = _render->device;
+    switch (entry.type){
+        case VK_OBJECT_TYPE_BUFFER: vkDestroyBuffer(device, (VkBuffer)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_IMAGE: vkDestroyImage(device, (VkImage)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_IMAGE_VIEW: vkDestroyImageView(device, (VkImageView)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_DEVICE_MEMORY: vkFreeMemory(device, (VkDeviceMemory)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_SAMPLER: vkDestroySampler(device, (VkSampler)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_PIPELINE: vkDestroyPipeline(device, (VkPipeline)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT: vkDestroyPipelineLayout(device, (VkPipelineLayout)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_SHADER_MODULE: vkDestroyShaderModule(device, (VkShaderModule)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_POOL: vkDestroyDescriptorPool(device, (VkDescriptorPool)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT: vkDestroyDescriptorSetLayout(device, (VkDescriptorSetLayout)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_FRAMEBUFFER: vkDestroyFramebuffer(device, (VkFramebuffer)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_RENDER_PASS: vkDestroyRenderPass(device, (VkRenderPass)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR: vkDestroySwapchainKHR(device, (VkSwapchainKHR)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_QUERY_POOL: vkDestroyQueryPool(device, (VkQueryPool)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_COMMAND_POOL: vkDestroyCommandPool(device, (VkCommandPool)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_SEMAPHORE: vkDestroySemaphore(device, (VkSemaphore)entry.handle, nullptr); break;
+        case VK_OBJECT_TYPE_FENCE: vkDestroyFence(device, (VkFence)entry.handle, nullptr); break;
+        default: throw std::runtime_error("Deletion queue: unsupported object type");
+    }
+}
+
+void DeletionQueue::retire(uint32_t slot){
+    // fence signal covers everything submitted to queue before it
+    completedFrame = std::max(completedFrame, slotFrames[slot]);
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (entries.empty()){
+            return;
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < entries.size(); i++){
+            const Entry& entry = entries[i];
+            bool done;
+            if (entry.timeline != VK_NULL_HANDLE){
+                uint64_t value = 0;
+                vkGetSemaphoreCounterValue(_render->device, entry.timeline, &value);
+                done = value >= entry.value;
+            } else {
+                done = entry.frame <= completedFrame;
+            }
+            if (done){
+                ready.push_back(entry);
+            } else {
+                entries[kept++] = entry;
+            }
+        }
+        entries.resize(kept);
+    }
+
+    // in queue order, outside lock
+    for (const Entry& entry : ready){
+        destroyObject(entry);
+    }
+    ready.clear();
+}
+
+void DeletionQueue::submitted(uint32_t slot){
+    renderThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    slotFrames[slot] = recordingFrame.fetch_add(1);
+}
+
+void DeletionQueue::flush(){
+    std::lock_guard<std::mutex> lock{mutex};
+    for (const Entry& entry : entries){
+        destroyObject(entry);
+    }
+    entries.clear();
+}
+
+size_t DeletionQueue::pending(){
+    std::lock_guard<std::mutex> lock{mutex};
+    return entries.size();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include "const.h"
+
+// forward declaration
+class Render;
+
+// Vulkan objects replaced at runtime (swapchain targets, pipelines after reload, buffers) are handed
+// here instead of destroyed: each is tagged with the frame being recorded, or with a timeline value,
+// and destroyed once GPU is past it. Nothing waits for device idle.
+//
+//   render->deletionQueue.destroy(oldView);
+//   render->deletionQueue.destroy(oldImage);
+//   render->deletionQueue.destroy(oldMemory);    // objects go in queue order, memory after its image
+//
+// Any thread may queue; only render thread retires. Objects queued by other threads (game thread)
+// may still be used by commands in the stream buffer being written, which render thread records
+// in the frame after the one it records now, so they wait one frame longer.
+class DeletionQueue {
+private:
+    struct Entry {
+        VkObjectType type;
+        uint64_t handle;
+        uint64_t frame;          // frame serial, 0 when waiting on timeline
+        VkSemaphore timeline;
+        uint64_t value;
+    };
+
+    Render* _render;
+    std::mutex mutex;
+    std::vector<Entry> entries{};
+    std::vector<Entry> ready{};                 // render thread only, reused
+    std::atomic<uint64_t> recordingFrame{1};    // serial of frame render thread records next
+    std::atomic<std::thread::id> renderThread{};  // thread calling submitted()
+    uint64_t completedFrame = 0;                // every frame up to this serial has finished on GPU
+    uint64_t slotFrames[MAX_FRAMES_IN_FLIGHT]{};  // serial last submitted with slot's fence
+
+    void push(VkObjectType type, uint64_t handle, VkSemaphore timeline, uint64_t value);
+    void destroyObject(const Entry& entry);
+
+    static VkObjectType typeOf(VkBuffer) { return VK_OBJECT_TYPE_BUFFER; }
+    static VkObjectType typeOf(VkImage) { return VK_OBJECT_TYPE_IMAGE; }
+    static VkObjectType typeOf(VkImageView) { return VK_OBJECT_TYPE_IMAGE_VIEW; }
+    static VkObjectType typeOf(VkDeviceMemory) { return VK_OBJECT_TYPE_DEVICE_MEMORY; }
+    static VkObjectType typeOf(VkSampler) { return VK_OBJECT_TYPE_SAMPLER; }
+    static VkObjectType typeOf(VkPipeline) { return VK_OBJECT_TYPE_PIPELINE; }
+    static VkObjectType typeOf(VkPipelineLayout) { return VK_OBJECT_TYPE_PIPELINE_LAYOUT; }
+    static VkObjectType typeOf(VkShaderModule) { return VK_OBJECT_TYPE_SHADER_MODULE; }
+    static VkObjectType typeOf(VkDescriptorPool) { return VK_OBJECT_TYPE_DESCRIPTOR_POOL; }
+    static VkObjectType typeOf(VkDescriptorSetLayout) { return VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT; }
+    static VkObjectType typeOf(VkFramebuffer) { return VK_OBJECT_TYPE_FRAMEBUFFER; }
+    static VkObjectType typeOf(VkRenderPass) { return VK_OBJECT_TYPE_RENDER_PASS; }
+    static VkObjectType typeOf(VkSwapchainKHR) { return VK_OBJECT_TYPE_SWAPCHAIN_KHR; }
+    static VkObjectType typeOf(VkQueryPool) { return VK_OBJECT_TYPE_QUERY_POOL; }
+    static VkObjectType typeOf(VkCommandPool) { return VK_OBJECT_TYPE_COMMAND_POOL; }
+    static VkObjectType typeOf(VkSemaphore) { return VK_OBJECT_TYPE_SEMAPHORE; }
+    static VkObjectType typeOf(VkFence) { return VK_OBJECT_TYPE_FENCE; }
+
+public:
+    DeletionQueue(Render* render) : _render(render) {}
+
+    // Destroyed when frame being recorded now (next one from other threads) has finished (null handles are ignored)
+    template<typename Handle>
+    void destroy(Handle handle) { push(typeOf(handle), (uint64_t)handle, VK_NULL_HANDLE, 0); }
+
+    // Destroyed when timeline semaphore reaches value, for objects used outside frame submits (async compute)
+    template<typename Handle>
+    void destroyAfter(VkSemaphore timeline, uint64_t value, Handle handle) { push(typeOf(handle), (uint64_t)handle, timeline, value); }
+
+    // Render thread, after waiting slot's fence: frame last submitted with it (and all before) finished
+    void retire(uint32_t slot);
+    // Render thread, after submitting frame with slot's fence
+    void submitted(uint32_t slot);
+    // Device is idle: destroys everything
+    void flush();
+
+    size_t pending();
+};
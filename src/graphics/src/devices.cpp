@@ -1,6 +1,8 @@
 #include "render.hpp"
 #include <stdexcept>
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 
 void Render::pickPhysicalDevice(){
     std::cout << "Picking Physical device" << std::endl;
@@ -15,31 +17,62 @@ void Render::pickPhysicalDevice(){
         throw std::runtime_error("Failed to enumerate phsyical devices");
     }
 
-    // Selecting Physical Device
-    VkPhysicalDeviceFeatures   features;
-    VkPhysicalDeviceProperties properties;
+    // BOTTLE_DEVICE=<part of device name> overrides scoring
+    const char* deviceOverride = std::getenv("BOTTLE_DEVICE");
+
+    DeviceCapabilitiesCache cache{DEVICE_CAPABILITIES_CACHE};
+    int64_t bestScore = -1;
+    bool overridden = false;
 
+    // Selecting Physical Device
     std::cout << "\tDevices: " << std::endl;
     for (VkPhysicalDevice currentPhysicalDevice : physicalDevices){
+        VkPhysicalDeviceProperties properties;
         vkGetPhysicalDeviceProperties(currentPhysicalDevice, &properties);
-        vkGetPhysicalDeviceFeatures(currentPhysicalDevice, &features);
+
+        DeviceCapabilities currentCapabilities;
+        if (const DeviceCapabilities* cached = cache.find(properties)){
+            currentCapabilities = *cached;
+        } else {
+            currentCapabilities = queryDeviceCapabilities(currentPhysicalDevice);
+            cache.store(currentCapabilities);
+        }
+
+        // Surface support depends on surface, never cached
+        uint32_t presentFamily = findPresentQueueFamily(currentPhysicalDevice, surface, currentCapabilities);
+        int64_t score = scoreDevice(currentCapabilities, presentFamily);
 
         std::cout << "\t\t" << "Device Name: " << properties.deviceName << std::endl;
         std::cout << "\t\t" << "Api Version: " << properties.apiVersion << std::endl;
         std::cout << "\t\t" << "Driver Version: " << properties.driverVersion << std::endl;
+        std::cout << "\t\t" << "Score: " << score << std::endl;
+
+        if (score < 0 || overridden){
+            continue;
+        }
 
-        if (!physicalDevice && features.geometryShader == VK_TRUE){
+        bool requested = deviceOverride != nullptr && strstr(properties.deviceName, deviceOverride) != nullptr;
+        if (requested || score > bestScore){
             physicalDevice = currentPhysicalDevice;
-            std::cout << "\tSelected " << properties.deviceName << std::endl;
+            capabilities = currentCapabilities;
+            presentQueueFamilyIndex = presentFamily;
+            bestScore = score;
+            overridden = requested;
         }
     }
 
-    // Check surface support
-    VkBool32 supported = VK_FALSE;
-    if (vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, graphicsQueueFamilyIndex, surface, &supported) || supported == VK_FALSE){
-        throw std::runtime_error("Physical does not support surface");
+    cache.save();
+
+    if (physicalDevice == VK_NULL_HANDLE){
+        throw std::runtime_error("No physical device supports graphics and presenting to surface");
     }
 
+    graphicsQueueFamilyIndex = capabilities.graphicsQueueFamily;
+    computeQueueFamilyIndex = capabilities.computeQueueFamily != NO_QUEUE_FAMILY ? capabilities.computeQueueFamily : graphicsQueueFamilyIndex;
+
+    std::cout << "\tSelected " << capabilities.deviceName << (overridden ? " (BOTTLE_DEVICE)" : "") << std::endl;
+    printDeviceCapabilities(capabilities);
+
     std::cout << "\tSurface supported by physical device" << std::endl;
 
     std::cout << "Physical Device selected" << std::endl << std::endl;
@@ -48,28 +81,61 @@ void Render::pickPhysicalDevice(){
 void Render::createLogicalDevice(){
     std::cout << "Creating logical device" << std::endl;
 
-    // Get all queue families properties
-    uint32_t queueFamilyPropertiesCount = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, nullptr);
-    std::vector<VkQueueFamilyProperties> queueFamilyProperties{queueFamilyPropertiesCount};
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, queueFamilyProperties.data());
-
-    // Get Present and Graphics Queue Family Index
-    for (int i = 0; i < queueFamilyPropertiesCount; i++){
-        VkQueueFamilyProperties CurrentQueueFamilyProperties = queueFamilyProperties[i];
-        if (CurrentQueueFamilyProperties.queueFlags & VK_QUEUE_GRAPHICS_BIT){
-            graphicsQueueFamilyIndex = i;
-        }
-        if (CurrentQueueFamilyProperties.queueFlags & VK_QUEUE_TRANSFER_BIT){
-            presentQueueFamilyIndex = i;
-        }
-    }
-
     // Device Extensions
     std::vector<const char*> deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
 
+    if (capabilities.memoryBudget){
+        deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    // Present id / present wait (latency measurement)
+    if (capabilities.presentWait){
+        deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
+
+    // Features, only what capabilities reported
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.features.samplerAnisotropy = capabilities.samplerAnisotropy;
+    features2.features.multiDrawIndirect = capabilities.multiDrawIndirect;
+    features2.features.drawIndirectFirstInstance = capabilities.drawIndirectFirstInstance;
+    features2.features.pipelineStatisticsQuery = capabilities.pipelineStatisticsQuery;
+    void** next = &features2.pNext;
+
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.timelineSemaphore = capabilities.timelineSemaphore;
+    features12.runtimeDescriptorArray = capabilities.descriptorIndexing;
+    features12.descriptorBindingPartiallyBound = capabilities.descriptorIndexing;
+    features12.shaderSampledImageArrayNonUniformIndexing = capabilities.descriptorIndexing;
+    if (capabilities.apiVersion >= VK_API_VERSION_1_2){
+        *next = &features12;
+        next = &features12.pNext;
+    }
+
+    VkPhysicalDeviceVulkan13Features features13{};
+    features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    features13.synchronization2 = capabilities.synchronization2;
+    features13.dynamicRendering = capabilities.dynamicRendering;
+    if (capabilities.apiVersion >= VK_API_VERSION_1_3){
+        *next = &features13;
+        next = &features13.pNext;
+    }
+
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.presentId = VK_TRUE;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    presentWaitFeatures.presentWait = VK_TRUE;
+    if (capabilities.presentWait){
+        *next = &presentIdFeatures;
+        presentIdFeatures.pNext = &presentWaitFeatures;
+    }
+
     // Creating Device Queue
 
     // Graphics Queue
@@ -88,10 +154,24 @@ void Render::createLogicalDevice(){
     devicePresentQueueCreateInfo.queueCount = 1;
     devicePresentQueueCreateInfo.queueFamilyIndex = presentQueueFamilyIndex;
 
+    // Async Compute Queue (compute-only family runs next to graphics)
+    float computeQueuePriority = 1.0;
+    VkDeviceQueueCreateInfo deviceComputeQueueCreateInfo{};
+    deviceComputeQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    deviceComputeQueueCreateInfo.pQueuePriorities = &computeQueuePriority;
+    deviceComputeQueueCreateInfo.queueCount = 1;
+    deviceComputeQueueCreateInfo.queueFamilyIndex = computeQueueFamilyIndex;
+
+    // Same family may not be listed twice
     std::vector<VkDeviceQueueCreateInfo> deviceQueueCreateInfos{
-        deviceGraphicsQueueCreateInfo,
-        devicePresentQueueCreateInfo
+        deviceGraphicsQueueCreateInfo
     };
+    if (presentQueueFamilyIndex != graphicsQueueFamilyIndex){
+        deviceQueueCreateInfos.push_back(devicePresentQueueCreateInfo);
+    }
+    if (computeQueueFamilyIndex != graphicsQueueFamilyIndex && computeQueueFamilyIndex != presentQueueFamilyIndex){
+        deviceQueueCreateInfos.push_back(deviceComputeQueueCreateInfo);
+    }
 
     // Creating Logical Device
     VkDeviceCreateInfo deviceCreateInfo{};
@@ -102,20 +182,23 @@ void Render::createLogicalDevice(){
     deviceCreateInfo.queueCreateInfoCount = deviceQueueCreateInfos.size();
     deviceCreateInfo.enabledLayerCount = validationLayers.size();
     deviceCreateInfo.ppEnabledLayerNames = validationLayers.data();
+    deviceCreateInfo.pNext = &features2;
 
     if (vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device) != VK_SUCCESS){
         throw std::runtime_error("Failed to create logical device");
     }
 
-    std::cout << "\tQueues: " << queueFamilyProperties.size() << std::endl;
+    std::cout << "\tQueues: " << capabilities.queueFamilyCount << std::endl;
 
     std::cout << "\tPresent Queue Family Index: " << presentQueueFamilyIndex << std::endl;
     std::cout << "\tGraphics Queue Family Index: " << graphicsQueueFamilyIndex << std::endl;
+    std::cout << "\tCompute Queue Family Index: " << computeQueueFamilyIndex << std::endl;
 
     vkGetDeviceQueue(device, graphicsQueueFamilyIndex, 0, &graphicsQueue);
     vkGetDeviceQueue(device, presentQueueFamilyIndex, 0, &presentQueue);
+    vkGetDeviceQueue(device, computeQueueFamilyIndex, 0, &computeQueue);
 
-    if (graphicsQueue == VK_NULL_HANDLE || presentQueue == VK_NULL_HANDLE) {
+    if (graphicsQueue == VK_NULL_HANDLE || presentQueue == VK_NULL_HANDLE || computeQueue == VK_NULL_HANDLE) {
         throw std::runtime_error("Failed to get device queues");
     }
 
@@ -0,0 +1,118 @@
+#include "framepacer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "../../memory/src/allocationtracker.hpp"
+
+// Exponential smoothing factor, ~10 frame window
+#define FRAME_PACING_SMOOTHING 0.1
+// Fraction of fence wait error corrected per frame
+#define FRAME_PACING_SLEEP_GAIN 0.5
+
+FramePacer::FramePacer(uint32_t maxFramesInFlight, double targetInterval)
+    : maxFramesInFlight(std::max(maxFramesInFlight, 1u)), targetInterval(targetInterval) {
+    // start where fixed pipeline used to be, pacer lowers it once it knows frame times
+    current = this->maxFramesInFlight;
+    wanted = current;
+}
+
+uint32_t FramePacer::choose() const {
+    double margin = 2.0 * deviation;
+    double serial = cpuTime + gpuTime + margin;           // 1 frame in flight: CPU waits for GPU
+    double overlapped = std::max(cpuTime, gpuTime) + margin;  // 2 frames in flight
+
+    uint32_t choice;
+    if (targetInterval > 0.0){
+        if (serial <= targetInterval){
+            choice = 1;
+        } else if (overlapped <= targetInterval){
+            choice = 2;
+        } else {
+            choice = maxFramesInFlight;
+        }
+    } else {
+        // not vsynced: overlap for throughput, deeper queue only absorbs noise
+        choice = deviation > 0.1 * overlapped ? maxFramesInFlight : 2;
+    }
+    return std::clamp(choice, 1u, maxFramesInFlight);
+}
+
+void FramePacer::frameCompleted(const FrameTimings& timings){
+    double cpu = std::max(timings.cpu, gameThreadTime.load(std::memory_order_relaxed));
+    // without timestamps assume GPU took whole frame period, keeps pipeline deep rather than starving GPU
+    double gpu = timings.gpu >= 0.0 ? timings.gpu : cpu + timings.fenceWait + sleep;
+
+    if (frames == 0){
+        cpuTime = cpu;
+        gpuTime = gpu;
+        fenceWait = timings.fenceWait;
+    } else {
+        double slower = std::max(cpuTime, gpuTime);
+        cpuTime += (cpu - cpuTime) * FRAME_PACING_SMOOTHING;
+        gpuTime += (gpu - gpuTime) * FRAME_PACING_SMOOTHING;
+        fenceWait += (timings.fenceWait - fenceWait) * FRAME_PACING_SMOOTHING;
+        deviation += (std::abs(std::max(cpu, gpu) - slower) - deviation) * FRAME_PACING_SMOOTHING;
+    }
+    gpuBound = gpuTime > cpuTime;
+    frames++;
+
+    double margin = std::max(FRAME_PACING_MIN_MARGIN, 2.0 * deviation);
+    double limit = targetInterval > 0.0 ? targetInterval : std::max(cpuTime, gpuTime);
+    if (timings.fenceWait > margin || timings.gpuIdle < 0.0){
+        // Integral controller: sleep grows until only margin is left waiting on fence
+        sleep += (timings.fenceWait - margin) * FRAME_PACING_SLEEP_GAIN;
+    } else {
+        // Fence is free but frames may still queue behind each other on GPU:
+        // probe upwards while GPU never idles, back off once it starts to
+        gpuIdle = gpuIdle < 0.0 ? timings.gpuIdle : gpuIdle + (timings.gpuIdle - gpuIdle) * FRAME_PACING_SMOOTHING;
+        if (timings.gpuIdle < margin * 0.5){
+            sleep += margin * 0.5 * FRAME_PACING_SLEEP_GAIN;
+        } else {
+            sleep -= (timings.gpuIdle - margin * 0.5) * FRAME_PACING_SLEEP_GAIN;
+        }
+    }
+    sleep = std::clamp(sleep, 0.0, limit);
+    sleepSeconds.store(sleep, std::memory_order_relaxed);
+
+    if (frames < FRAME_PACING_HYSTERESIS){
+        return;
+    }
+
+    // Going up (frame drops) reacts faster than going down (latency)
+    uint32_t choice = choose();
+    if (choice == current){
+        wanted = current;
+        agreeing = 0;
+        return;
+    }
+    if (choice != wanted){
+        wanted = choice;
+        agreeing = 0;
+    }
+    uint32_t required = choice > current ? FRAME_PACING_HYSTERESIS / 3 : FRAME_PACING_HYSTERESIS;
+    if (++agreeing < required){
+        return;
+    }
+
+    AllowAllocationsScope allow{};
+    std::cout << std::fixed << std::setprecision(2)
+              << "Frames in flight: " << current << " -> " << choice
+              << " (cpu " << cpuTime * 1e3 << " ms, gpu " << gpuTime * 1e3 << " ms, deviation " << deviation * 1e3 << " ms)"
+              << std::defaultfloat << std::endl;
+    current = choice;
+    agreeing = 0;
+}
+
+FramePacingStats FramePacer::stats() const {
+    FramePacingStats result{};
+    result.framesInFlight = current;
+    result.cpuTime = cpuTime;
+    result.gpuTime = gpuTime;
+    result.deviation = deviation;
+    result.fenceWait = fenceWait;
+    result.gpuIdle = gpuIdle;
+    result.sleep = sleep;
+    result.gpuBound = gpuBound;
+    return result;
+}
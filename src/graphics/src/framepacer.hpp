@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+// Frames that must agree before frames in flight changes
+#define FRAME_PACING_HYSTERESIS 30
+// Kept free before GPU becomes available, covers frame time jitter
+#define FRAME_PACING_MIN_MARGIN 0.0005
+
+// One retired frame, seconds
+struct FrameTimings {
+    double cpu;        // render thread work: fence signaled -> present returned
+    double gpu;        // timestamps around command buffer, < 0 when unknown
+    double gpuIdle;    // GPU idle between previous frame and this one, < 0 when unknown
+    double fenceWait;  // render thread blocked waiting for frame slot
+};
+
+struct FramePacingStats {
+    uint32_t framesInFlight;
+    double cpuTime;    // smoothed, max of render and game thread
+    double gpuTime;    // smoothed
+    double deviation;  // smoothed absolute deviation of slower side
+    double fenceWait;  // smoothed
+    double gpuIdle;    // smoothed, < 0 when unknown
+    double sleep;      // applied before input sampling
+    bool gpuBound;
+};
+
+// Picks frames in flight and pre-input sleep from measured CPU and GPU frame times.
+// 1 frame in flight when CPU + GPU fits in display interval (lowest latency),
+// 2 when they only fit overlapped, all slots when frame times are too noisy to overlap tightly.
+// Sleep moves fence wait and GPU queueing in front of input sampling, so input is as fresh
+// as possible while GPU still gets next frame in time.
+class FramePacer {
+private:
+    uint32_t maxFramesInFlight;
+    uint32_t current;
+    uint32_t wanted;
+    uint32_t agreeing = 0;
+    double targetInterval;  // display refresh interval, 0 = not vsynced
+
+    double cpuTime = 0.0;
+    double gpuTime = 0.0;
+    double deviation = 0.0;
+    double fenceWait = 0.0;
+    double gpuIdle = -1.0;
+    double sleep = 0.0;
+    bool gpuBound = false;
+    uint64_t frames = 0;
+
+    std::atomic<double> gameThreadTime{0.0};
+    std::atomic<double> sleepSeconds{0.0};
+
+    uint32_t choose() const;
+
+public:
+    FramePacer(uint32_t maxFramesInFlight, double targetInterval = 0.0);
+
+    void setTargetInterval(double interval) { targetInterval = interval; }
+    double targetFrameInterval() const { return targetInterval; }
+
+    // Render thread, once per frame after submit
+    void frameCompleted(const FrameTimings& timings);
+
+    // Game thread work (simulation + command writing) when it runs on its own thread
+    void reportGameThread(double seconds) { gameThreadTime.store(seconds, std::memory_order_relaxed); }
+
+    // Render thread: slots used round robin
+    uint32_t framesInFlight() const { return current; }
+
+    // Any thread: how long to sleep before sampling input
+    double sleepBeforeInput() const { return sleepSeconds.load(std::memory_order_relaxed); }
+
+    // Render thread
+    FramePacingStats stats() const;
+};
@@ -0,0 +1,42 @@
+#include "gpuwaits.hpp"
+#include "render.hpp"
+
+bool GpuWaitQueue::signaled(VkFence fence, VkSemaphore semaphore, uint64_t value) const {
+    if (fence != VK_NULL_HANDLE){
+        return vkGetFenceStatus(_render->device, fence) == VK_SUCCESS;
+    }
+    uint64_t current = 0;
+    vkGetSemaphoreCounterValue(_render->device, semaphore, &current);
+    return current >= value;
+}
+
+void GpuWaitQueue::add(const Wait& wait){
+    std::lock_guard<std::mutex> lock{mutex};
+    waits.push_back(wait);
+}
+
+uint32_t GpuWaitQueue::poll(){
+    std::vector<std::coroutine_handle<>> ready{};
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        size_t kept = 0;
+        for (size_t i = 0; i < waits.size(); i++){
+            if (signaled(waits[i].fence, waits[i].semaphore, waits[i].value)){
+                ready.push_back(waits[i].handle);
+            } else {
+                waits[kept++] = waits[i];
+            }
+        }
+        waits.resize(kept);
+    }
+    // outside lock: resumed coroutines may wait again
+    for (auto handle : ready){
+        handle.resume();
+    }
+    return static_cast<uint32_t>(ready.size());
+}
+
+size_t GpuWaitQueue::pending(){
+    std::lock_guard<std::mutex> lock{mutex};
+    return waits.size();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <coroutine>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+// forward declaration
+class Render;
+
+// Coroutines waiting for GPU: co_await gpuWaits.fence(fence) or gpuWaits.timeline(semaphore, value).
+// Nothing blocks; render thread polls waits once per frame and resumes signaled ones there,
+// so code after the co_await runs on render thread. Already signaled waits do not suspend.
+class GpuWaitQueue {
+private:
+    struct Wait {
+        VkFence fence;
+        VkSemaphore semaphore;
+        uint64_t value;
+        std::coroutine_handle<> handle;
+    };
+
+    Render* _render;
+    std::mutex mutex;
+    std::vector<Wait> waits{};
+
+    bool signaled(VkFence fence, VkSemaphore semaphore, uint64_t value) const;
+    void add(const Wait& wait);
+
+public:
+    struct Awaiter {
+        GpuWaitQueue& queue;
+        VkFence fence;
+        VkSemaphore semaphore;
+        uint64_t value;
+
+        bool await_ready() const { return queue.signaled(fence, semaphore, value); }
+        void await_suspend(std::coroutine_handle<> handle) { queue.add({fence, semaphore, value, handle}); }
+        void await_resume() const {}
+    };
+
+    GpuWaitQueue(Render* render) : _render(render) {}
+
+    Awaiter fence(VkFence fence) { return {*this, fence, VK_NULL_HANDLE, 0}; }
+    // Timeline semaphores only (Vulkan 1.2 or VK_KHR_timeline_semaphore)
+    Awaiter timeline(VkSemaphore semaphore, uint64_t value) { return {*this, VK_NULL_HANDLE, semaphore, value}; }
+
+    // Render thread: resumes coroutines whose wait is signaled, returns how many
+    uint32_t poll();
+    size_t pending();
+};
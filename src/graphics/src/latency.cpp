@@ -0,0 +1,227 @@
+#include "latency.hpp"
+#include "render.hpp"
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include "../../memory/src/allocationtracker.hpp"
+
+// steady clock ns, same time base as InputBehaviour::now()
+static uint64_t timestampNow(){
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+LatencyTracker::LatencyTracker(Render* render){
+    _render = render;
+    slotSamples.resize(MAX_FRAMES_IN_FLIGHT);
+    history.reserve(LATENCY_HISTORY);
+
+    if (render->capabilities.presentWait){
+        waitForPresent = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(render->device, "vkWaitForPresentKHR");
+    }
+    usePresentWait = waitForPresent != nullptr;
+
+    std::cout << "Latency tracking: " << (usePresentWait ? "present wait" : "CPU estimate") << std::endl;
+
+    if (usePresentWait){
+        running = true;
+        waiter = std::thread(&LatencyTracker::waiterLoop, this);
+    }
+}
+
+LatencyTracker::~LatencyTracker(){
+    running = false;
+    if (waiter.joinable()){
+        waiter.join();
+    }
+}
+
+uint64_t LatencyTracker::beginPresent(VkPresentInfoKHR* presentInfo, VkPresentIdKHR* presentIdInfo, uint64_t inputTimestamp){
+    if (!usePresentWait){
+        return 0;
+    }
+
+    uint64_t presentId = nextPresentId++;
+    presentIdInfo->sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo->pNext = presentInfo->pNext;
+    presentIdInfo->swapchainCount = 1;
+    presentInfo->pNext = presentIdInfo;
+
+    // pPresentIds points into pending list, entry lives until present is completed
+    std::lock_guard<std::mutex> lock{historyMutex};
+    LatencySample sample{};
+    sample.presentId = presentId;
+    sample.inputTimestamp = inputTimestamp;
+    pending.push_back(sample);
+    presentIdInfo->pPresentIds = &pending.back().presentId;
+    return presentId;
+}
+
+void LatencyTracker::endPresent(uint64_t presentId, uint32_t frameSlot, uint64_t inputTimestamp){
+    uint64_t now = timestampNow();
+
+    if (usePresentWait){
+        std::lock_guard<std::mutex> lock{historyMutex};
+        for (auto& sample : pending){
+            if (sample.presentId == presentId){
+                sample.submitTimestamp = now;
+                break;
+            }
+        }
+        return;
+    }
+
+    LatencySample& sample = slotSamples[frameSlot];
+    sample = LatencySample{};
+    sample.inputTimestamp = inputTimestamp;
+    sample.submitTimestamp = now;
+    sample.estimated = true;
+}
+
+void LatencyTracker::frameRetired(uint32_t frameSlot){
+    if (usePresentWait){
+        return;
+    }
+
+    LatencySample& sample = slotSamples[frameSlot];
+    if (sample.submitTimestamp == 0){
+        return;
+    }
+
+    // GPU finished the frame, it is scanned out within one display interval
+    sample.presentTimestamp = timestampNow() + static_cast<uint64_t>(displayInterval * 1e9);
+    complete(sample);
+    sample = LatencySample{};
+}
+
+void LatencyTracker::frameDropped(uint32_t frameSlot, uint64_t presentId){
+    slotSamples[frameSlot] = LatencySample{};
+
+    // waiter would poll id that is never presented, blocking every sample behind it
+    if (presentId != 0){
+        std::lock_guard<std::mutex> lock{historyMutex};
+        for (auto it = pending.begin(); it != pending.end(); it++){
+            if (it->presentId == presentId){
+                pending.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+void LatencyTracker::waiterLoop(){
+    while (running){
+        uint64_t presentId = 0;
+        {
+            std::lock_guard<std::mutex> lock{historyMutex};
+            if (!pending.empty() && pending.front().submitTimestamp != 0){
+                presentId = pending.front().presentId;
+            }
+        }
+
+        if (presentId == 0){
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+            continue;
+        }
+
+        // poll without holding swapchain for long, presents must not wait for us
+        VkResult result;
+        {
+            std::lock_guard<std::mutex> lock{presentMutex};
+            result = waitForPresent(_render->device, _render->swapchain, presentId, 0);
+        }
+
+        if (result == VK_TIMEOUT){
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+            continue;
+        }
+
+        uint64_t now = timestampNow();
+        LatencySample sample;
+        {
+            std::lock_guard<std::mutex> lock{historyMutex};
+            sample = pending.front();
+            pending.pop_front();
+        }
+
+        // VK_ERROR_OUT_OF_DATE_KHR and friends: frame never reached display, drop it
+        if (result == VK_SUCCESS){
+            sample.presentTimestamp = now;
+            complete(sample);
+        }
+    }
+}
+
+void LatencyTracker::complete(const LatencySample& sample){
+    std::lock_guard<std::mutex> lock{historyMutex};
+    if (history.size() < LATENCY_HISTORY){
+        history.push_back(sample);
+    } else {
+        history[historyNext] = sample;
+    }
+    historyNext = (historyNext + 1) % LATENCY_HISTORY;
+}
+
+static LatencyPercentiles percentiles(std::vector<double>& values){
+    LatencyPercentiles result{};
+    if (values.empty()){
+        return result;
+    }
+    std::sort(values.begin(), values.end());
+    auto at = [&](double p){
+        size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+        return values[index];
+    };
+    result.p50 = at(0.50);
+    result.p90 = at(0.90);
+    result.p99 = at(0.99);
+    result.max = values.back();
+    return result;
+}
+
+LatencyStats LatencyTracker::stats(){
+    std::vector<double> inputToPresent{};
+    std::vector<double> submitToPresent{};
+    LatencyStats result{};
+
+    {
+        std::lock_guard<std::mutex> lock{historyMutex};
+        for (const auto& sample : history){
+            if (sample.inputTimestamp != 0 && sample.presentTimestamp > sample.inputTimestamp){
+                inputToPresent.push_back((sample.presentTimestamp - sample.inputTimestamp) / 1e6);
+            }
+            if (sample.presentTimestamp > sample.submitTimestamp){
+                submitToPresent.push_back((sample.presentTimestamp - sample.submitTimestamp) / 1e6);
+            }
+        }
+        result.samples = static_cast<uint32_t>(history.size());
+    }
+
+    result.estimated = !usePresentWait;
+    result.inputToPresent = percentiles(inputToPresent);
+    result.submitToPresent = percentiles(submitToPresent);
+    return result;
+}
+
+void LatencyTracker::report(){
+    uint64_t now = timestampNow();
+    if (lastReport != 0 && now - lastReport < static_cast<uint64_t>(reportInterval * 1e9)){
+        return;
+    }
+    lastReport = now;
+
+    AllowAllocationsScope allow{};
+    LatencyStats current = stats();
+    if (current.samples == 0){
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Latency (" << current.samples << " frames, " << (current.estimated ? "estimated" : "present wait") << ")" << std::endl
+              << "\tInput to present  p50: " << current.inputToPresent.p50 << " ms, p90: " << current.inputToPresent.p90
+              << " ms, p99: " << current.inputToPresent.p99 << " ms, max: " << current.inputToPresent.max << " ms" << std::endl
+              << "\tSubmit to present p50: " << current.submitToPresent.p50 << " ms, p90: " << current.submitToPresent.p90
+              << " ms, p99: " << current.submitToPresent.p99 << " ms, max: " << current.submitToPresent.max << " ms" << std::endl
+              << std::defaultfloat;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <cstdint>
+
+// forward declaration
+class Render;
+
+#define LATENCY_HISTORY 1024
+
+struct LatencySample {
+    uint64_t presentId = 0;
+    uint64_t inputTimestamp = 0;    // input sample the frame was built from (ns)
+    uint64_t submitTimestamp = 0;   // vkQueuePresentKHR call (ns)
+    uint64_t presentTimestamp = 0;  // image reached display (ns), measured or estimated
+    bool estimated = false;         // no present wait, CPU side estimate
+};
+
+struct LatencyPercentiles {
+    double p50 = 0.0;  // milliseconds
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+struct LatencyStats {
+    uint32_t samples = 0;
+    bool estimated = false;
+    LatencyPercentiles inputToPresent{};  // input sample -> display
+    LatencyPercentiles submitToPresent{}; // present call -> display
+};
+
+// Measures input-to-photon latency. With VK_KHR_present_id / VK_KHR_present_wait every present is tagged
+// and a waiter thread records when it is displayed, otherwise fence completion + one display interval is used.
+class LatencyTracker {
+private:
+    Render* _render;
+    PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+    bool usePresentWait = false;
+    uint64_t nextPresentId = 1;
+
+    std::mutex historyMutex;
+    std::deque<LatencySample> pending{};      // waiting for present
+    std::vector<LatencySample> history{};     // completed, ring of LATENCY_HISTORY
+    size_t historyNext = 0;
+
+    // frame in flight slot -> sample, for CPU estimates
+    std::vector<LatencySample> slotSamples{};
+
+    std::thread waiter;
+    std::atomic<bool> running{false};
+
+    double displayInterval = 1.0 / 60.0;
+    double reportInterval = 5.0;
+    uint64_t lastReport = 0;
+
+    void waiterLoop();
+    void complete(const LatencySample& sample);
+
+public:
+    std::mutex presentMutex; // vkQueuePresentKHR and vkWaitForPresentKHR need external sync of swapchain
+
+    LatencyTracker(Render* render);
+    ~LatencyTracker();
+
+    // Chain into VkPresentInfoKHR before vkQueuePresentKHR, returns present id (0 when present id is not used)
+    uint64_t beginPresent(VkPresentInfoKHR* presentInfo, VkPresentIdKHR* presentIdInfo, uint64_t inputTimestamp);
+    // Call after vkQueuePresentKHR
+    void endPresent(uint64_t presentId, uint32_t frameSlot, uint64_t inputTimestamp);
+    // Call when frame slot fence is observed signaled (CPU estimate path)
+    void frameRetired(uint32_t frameSlot);
+    // Call when frame slot will not be presented (failed acquire / present, slot skipped by pacer), its sample is dropped
+    void frameDropped(uint32_t frameSlot, uint64_t presentId = 0);
+
+    LatencyStats stats();
+    void setDisplayInterval(double seconds) { displayInterval = seconds; }
+    void setReportInterval(double seconds) { reportInterval = seconds; }
+    bool measured() const { return usePresentWait; }
+
+    // Prints stats every report interval
+    void report();
+};
@@ -0,0 +1,161 @@
+#include "mesh.hpp"
+#include "../render.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <cstddef>
+#include <algorithm>
+
+// Vertex layout table, attributes are generated from it
+struct VertexAttributeLayout {
+    uint32_t location;
+    VkFormat format;
+    uint32_t offset;
+};
+
+static const VertexAttributeLayout packedVertexLayout[] = {
+    {0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex, position)}, // quantized position
+    {1, VK_FORMAT_R16G16_SNORM,       offsetof(PackedVertex, normal)},   // octahedral normal
+    {2, VK_FORMAT_R16G16_SFLOAT,      offsetof(PackedVertex, uv)},       // half float uv
+};
+
+VkPipelineVertexInputStateCreateInfo* VertexInputDescription::get(){
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    createInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindings.size());
+    createInfo.pVertexBindingDescriptions = bindings.data();
+    createInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size());
+    createInfo.pVertexAttributeDescriptions = attributes.data();
+    return &createInfo;
+}
+
+VertexInputDescription Mesh::vertexInputDescription(){
+    VertexInputDescription description{};
+
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(PackedVertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    description.bindings.push_back(binding);
+
+    for (const VertexAttributeLayout& layout : packedVertexLayout){
+        VkVertexInputAttributeDescription attribute{};
+        attribute.binding = 0;
+        attribute.location = layout.location;
+        attribute.format = layout.format;
+        attribute.offset = layout.offset;
+        description.attributes.push_back(attribute);
+    }
+
+    return description;
+}
+
+Mesh::Mesh(Render* render, std::string path){
+    _render = render;
+    if (path.substr(path.find_last_of(".") + 1) == "bmesh"){
+        this->path = path;
+    } else {
+        throw std::runtime_error("File is not a BMESH file");
+    }
+    this->readFile();
+    this->createBuffers();
+}
+
+void Mesh::readFile(){
+    if (std::ifstream file{path, std::ios::ate | std::ios::binary}){
+        size_t fileSize = (size_t)file.tellg();
+        data.resize(fileSize);
+        file.seekg(0);
+        file.read(data.data(), fileSize);
+        file.close();
+    } else {
+        throw std::runtime_error("File not found");
+    }
+
+    if (data.size() < sizeof(MeshHeader)){
+        throw std::runtime_error("Mesh file is too small");
+    }
+    memcpy(&header, data.data(), sizeof(MeshHeader));
+
+    if (header.magic != MESH_MAGIC || header.version == 0 || header.version > MESH_VERSION){
+        throw std::runtime_error("Unsupported mesh file: " + path);
+    }
+    if (header.indexSize != 2 && header.indexSize != 4){
+        throw std::runtime_error("Invalid mesh index size");
+    }
+
+    uint64_t vertexBytes = uint64_t(header.vertexCount) * sizeof(PackedVertex);
+    uint64_t indexBytes = uint64_t(header.indexCount) * header.indexSize;
+    if (header.vertexOffset + vertexBytes > data.size() || header.indexOffset + indexBytes > data.size()){
+        throw std::runtime_error("Mesh file is truncated");
+    }
+
+    // version 1 files have reserved field (0) where level count is
+    if (header.lodCount > MESH_MAX_LODS || sizeof(MeshHeader) + uint64_t(header.lodCount) * sizeof(MeshLod) > header.vertexOffset){
+        throw std::runtime_error("Invalid mesh level table");
+    }
+    lods.resize(header.lodCount);
+    memcpy(lods.data(), data.data() + sizeof(MeshHeader), sizeof(MeshLod) * header.lodCount);
+    for (const MeshLod& lod : lods){
+        if (uint64_t(lod.firstIndex) + lod.indexCount > header.indexCount){
+            throw std::runtime_error("Mesh level is out of index buffer");
+        }
+    }
+    if (lods.empty()){
+        lods.push_back({0, header.indexCount, 0.0f, 0});
+    }
+
+    indexType = header.indexSize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+}
+
+void Mesh::createBuffers(){
+    VkDeviceSize vertexBytes = VkDeviceSize(header.vertexCount) * sizeof(PackedVertex);
+    VkDeviceSize indexBytes = VkDeviceSize(header.indexCount) * header.indexSize;
+
+    _render->createBuffer(vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &vertexBuffer, &vertexMemory);
+    _render->uploadBuffer(vertexBuffer, data.data() + header.vertexOffset, vertexBytes);
+
+    _render->createBuffer(indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &indexBuffer, &indexMemory);
+    _render->uploadBuffer(indexBuffer, data.data() + header.indexOffset, indexBytes);
+
+    // file contents are on GPU now
+    data.clear();
+    data.shrink_to_fit();
+}
+
+MeshQuantization Mesh::quantization() const {
+    MeshQuantization quantization{};
+    for (int k = 0; k < 3; k++){
+        quantization.offset[k] = header.boundsMin[k];
+        quantization.scale[k] = header.boundsMax[k] - header.boundsMin[k];
+    }
+    return quantization;
+}
+
+void Mesh::bind(VkCommandBuffer commandBuffer){
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+}
+
+void Mesh::draw(VkCommandBuffer commandBuffer, uint32_t instanceCount){
+    drawLod(commandBuffer, 0, instanceCount);
+}
+
+void Mesh::drawLod(VkCommandBuffer commandBuffer, uint32_t level, uint32_t instanceCount){
+    const MeshLod& lod = lods[std::min(level, lodCount() - 1)];
+    _render->stats.drawIndexed(commandBuffer, lod.indexCount, instanceCount, lod.firstIndex, 0, 0);
+}
+
+void Mesh::cleanup(){
+    if (vertexBuffer != VK_NULL_HANDLE){
+        vkDestroyBuffer(_render->device, vertexBuffer, nullptr);
+        vkFreeMemory(_render->device, vertexMemory, nullptr);
+        vertexBuffer = VK_NULL_HANDLE;
+    }
+    if (indexBuffer != VK_NULL_HANDLE){
+        vkDestroyBuffer(_render->device, indexBuffer, nullptr);
+        vkFreeMemory(_render->device, indexMemory, nullptr);
+        indexBuffer = VK_NULL_HANDLE;
+    }
+}
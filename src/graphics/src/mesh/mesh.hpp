@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include "meshformat.hpp"
+
+// forward declaration
+class Render;
+
+// Vertex input state generated from vertex layout, can be passed to PipelineCreate
+struct VertexInputDescription {
+    std::vector<VkVertexInputBindingDescription> bindings{};
+    std::vector<VkVertexInputAttributeDescription> attributes{};
+    VkPipelineVertexInputStateCreateInfo createInfo{};
+
+    VkPipelineVertexInputStateCreateInfo* get();
+};
+
+class Mesh {
+private:
+    Render* _render;
+    std::string path;
+    std::vector<char> data{};
+    void readFile();
+    void createBuffers();
+
+public:
+    MeshHeader header{};
+    std::vector<MeshLod> lods{};        // at least one, level 0 is full detail
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory vertexMemory = VK_NULL_HANDLE;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory indexMemory = VK_NULL_HANDLE;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+
+    Mesh(Render* render, std::string path);
+
+    // Push constant data for position dequantization
+    MeshQuantization quantization() const;
+
+    void bind(VkCommandBuffer commandBuffer);
+    void draw(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1);
+    void drawLod(VkCommandBuffer commandBuffer, uint32_t level, uint32_t instanceCount = 1);
+    uint32_t lodCount() const { return static_cast<uint32_t>(lods.size()); }
+    void cleanup();
+
+    // Bindings and attributes matching PackedVertex
+    static VertexInputDescription vertexInputDescription();
+};
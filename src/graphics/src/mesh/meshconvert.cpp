@@ -0,0 +1,130 @@
+#include "meshconvert.hpp"
+#include "meshoptimizer.hpp"
+#include "meshsimplify.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <cfloat>
+
+MeshData convertMesh(const MeshSource& source, const MeshLodOptions& options){
+    size_t vertexCount = source.positions.size() / 3;
+    if (vertexCount == 0 || source.indices.size() % 3 != 0){
+        throw std::runtime_error("Mesh source is empty or not triangulated");
+    }
+
+    bool hasNormals = source.normals.size() == vertexCount * 3;
+    bool hasUvs = source.uvs.size() == vertexCount * 2;
+
+    MeshData mesh{};
+    for (uint32_t index : source.indices){
+        if (index >= vertexCount){
+            throw std::runtime_error("Mesh index out of range");
+        }
+    }
+
+    // Bounds
+    float boundsMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float boundsMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (size_t i = 0; i < vertexCount; i++){
+        for (int k = 0; k < 3; k++){
+            boundsMin[k] = std::min(boundsMin[k], source.positions[i * 3 + k]);
+            boundsMax[k] = std::max(boundsMax[k], source.positions[i * 3 + k]);
+        }
+    }
+
+    // Levels of detail: each one simplified from full detail, stop when reduction stalls or error gets too big
+    std::vector<std::vector<uint32_t>> levels{source.indices};
+    std::vector<float> errors{0.0f};
+    float diagonal = std::sqrt((boundsMax[0] - boundsMin[0]) * (boundsMax[0] - boundsMin[0]) +
+                               (boundsMax[1] - boundsMin[1]) * (boundsMax[1] - boundsMin[1]) +
+                               (boundsMax[2] - boundsMin[2]) * (boundsMax[2] - boundsMin[2]));
+    uint32_t levelCount = std::min(std::max(options.levels, 1u), MESH_MAX_LODS);
+    for (uint32_t level = 1; level < levelCount; level++){
+        size_t previous = levels.back().size();
+        size_t target = static_cast<size_t>(previous * options.reduction) / 3 * 3;
+        float error = 0.0f;
+        std::vector<uint32_t> simplified = simplifyMesh(source.indices, source.positions, target, options.maxError * diagonal, &error);
+        if (simplified.empty() || simplified.size() > previous - previous / 10){
+            break;
+        }
+        levels.push_back(std::move(simplified));
+        errors.push_back(std::max(error, errors.back()));
+    }
+
+    // Index order: vertex cache first per level, then vertex order follows index order (full detail first)
+    for (size_t level = 0; level < levels.size(); level++){
+        optimizeVertexCache(levels[level], vertexCount);
+        if (levels.size() > 1){
+            MeshLod lod{};
+            lod.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+            lod.indexCount = static_cast<uint32_t>(levels[level].size());
+            lod.error = errors[level];
+            mesh.lods.push_back(lod);
+        }
+        mesh.indices.insert(mesh.indices.end(), levels[level].begin(), levels[level].end());
+    }
+    std::vector<uint32_t> remap = optimizeVertexFetch(mesh.indices, vertexCount);
+
+    float inverseExtent[3];
+    for (int k = 0; k < 3; k++){
+        float extent = boundsMax[k] - boundsMin[k];
+        inverseExtent[k] = extent > 0.0f ? 1.0f / extent : 0.0f;
+    }
+
+    // Packing
+    mesh.vertices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++){
+        PackedVertex& vertex = mesh.vertices[remap[i]];
+
+        for (int k = 0; k < 3; k++){
+            vertex.position[k] = meshformat::quantizeUnorm16((source.positions[i * 3 + k] - boundsMin[k]) * inverseExtent[k]);
+        }
+        vertex.position[3] = 0;
+
+        if (hasNormals){
+            meshformat::octEncode(&source.normals[i * 3], vertex.normal);
+        } else {
+            const float up[3] = {0.0f, 0.0f, 1.0f};
+            meshformat::octEncode(up, vertex.normal);
+        }
+
+        vertex.uv[0] = meshformat::floatToHalf(hasUvs ? source.uvs[i * 2 + 0] : 0.0f);
+        vertex.uv[1] = meshformat::floatToHalf(hasUvs ? source.uvs[i * 2 + 1] : 0.0f);
+    }
+
+    // Header
+    MeshHeader& header = mesh.header;
+    header.vertexCount = static_cast<uint32_t>(vertexCount);
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.indexSize = vertexCount <= UINT16_MAX ? 2 : 4;
+    header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+    for (int k = 0; k < 3; k++){
+        header.boundsMin[k] = boundsMin[k];
+        header.boundsMax[k] = boundsMax[k];
+    }
+    header.vertexOffset = sizeof(MeshHeader) + sizeof(MeshLod) * mesh.lods.size();
+    header.indexOffset = header.vertexOffset + sizeof(PackedVertex) * vertexCount;
+
+    return mesh;
+}
+
+void writeMeshFile(const std::string& path, const MeshData& mesh){
+    std::ofstream file{path, std::ios::binary};
+    if (!file){
+        throw std::runtime_error("Failed to open mesh file for writing: " + path);
+    }
+
+    file.write(reinterpret_cast<const char*>(&mesh.header), sizeof(MeshHeader));
+    file.write(reinterpret_cast<const char*>(mesh.lods.data()), sizeof(MeshLod) * mesh.lods.size());
+    file.write(reinterpret_cast<const char*>(mesh.vertices.data()), sizeof(PackedVertex) * mesh.vertices.size());
+
+    if (mesh.header.indexSize == 2){
+        std::vector<uint16_t> indices16(mesh.indices.begin(), mesh.indices.end());
+        file.write(reinterpret_cast<const char*>(indices16.data()), sizeof(uint16_t) * indices16.size());
+    } else {
+        file.write(reinterpret_cast<const char*>(mesh.indices.data()), sizeof(uint32_t) * mesh.indices.size());
+    }
+
+    if (!file){
+        throw std::runtime_error("Failed to write mesh file: " + path);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "meshformat.hpp"
+
+// Unpacked mesh as it comes from an interchange format (OBJ, glTF...)
+struct MeshSource {
+    std::vector<float> positions; // xyz per vertex
+    std::vector<float> normals;   // xyz per vertex (optional)
+    std::vector<float> uvs;       // uv per vertex (optional)
+    std::vector<uint32_t> indices;
+};
+
+// Packed mesh, ready to be written to a .bmesh file
+struct MeshData {
+    MeshHeader header{};
+    std::vector<MeshLod> lods;          // empty when mesh has one level
+    std::vector<PackedVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// Simplified levels generated by convertMesh
+struct MeshLodOptions {
+    uint32_t levels = 1;                // including full detail, at most MESH_MAX_LODS
+    float reduction = 0.5f;             // index count of a level relative to previous one
+    float maxError = 0.05f;             // relative to bounds diagonal, coarser levels are dropped
+};
+
+// Quantizes vertices, generates levels of detail and optimizes index buffer for vertex cache and vertex fetch
+MeshData convertMesh(const MeshSource& source, const MeshLodOptions& options = {});
+
+void writeMeshFile(const std::string& path, const MeshData& mesh);
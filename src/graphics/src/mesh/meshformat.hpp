@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// Binary mesh file (.bmesh) layout:
+//   MeshHeader
+//   MeshLod[lodCount]
+//   PackedVertex[vertexCount]
+//   uint16_t or uint32_t [indexCount] (see MeshHeader::indexSize), all levels back to back
+// Files are produced offline by the meshconvert tool and are uploaded as is.
+
+constexpr uint32_t MESH_MAGIC = 0x48534D42; // "BMSH"
+constexpr uint32_t MESH_VERSION = 2;        // 2: level of detail table (version 1 files have none)
+constexpr uint32_t MESH_MAX_LODS = 8;
+
+struct MeshHeader {
+    uint32_t magic = MESH_MAGIC;     // file magic
+    uint32_t version = MESH_VERSION; // format version
+    uint32_t vertexCount = 0;        // number of PackedVertex entries
+    uint32_t indexCount = 0;         // number of indices, of all levels
+    uint32_t indexSize = 2;          // 2 (uint16) or 4 (uint32) bytes per index
+    uint32_t lodCount = 0;           // entries in level table, 0: whole index buffer is one level
+    float boundsMin[3]{};            // quantization origin
+    float boundsMax[3]{};            // quantization extent
+    uint64_t vertexOffset = 0;       // offset of vertex data in file
+    uint64_t indexOffset = 0;        // offset of index data in file
+};
+
+// 16 bytes instead of 32 for float position/normal/uv
+struct PackedVertex {
+    uint16_t position[4]; // unorm16 inside mesh bounds (w unused)
+    int16_t normal[2];    // snorm16 octahedral encoded normal
+    uint16_t uv[2];       // half float texture coordinates
+};
+
+// Level of detail, a range of the shared index buffer. Level 0 is full detail.
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;              // distance to full detail surface, mesh units
+    uint32_t reserved = 0;
+};
+
+static_assert(sizeof(MeshHeader) == 64, "MeshHeader layout changed");
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex layout changed");
+static_assert(sizeof(MeshLod) == 16, "MeshLod layout changed");
+
+// Dequantization parameters, passed to vertex shader as push constant:
+//   position = offset + unorm * scale
+struct MeshQuantization {
+    float offset[4];
+    float scale[4];
+};
+
+namespace meshformat {
+
+inline uint16_t quantizeUnorm16(float value){
+    value = std::clamp(value, 0.0f, 1.0f);
+    return static_cast<uint16_t>(value * 65535.0f + 0.5f);
+}
+
+inline int16_t quantizeSnorm16(float value){
+    value = std::clamp(value, -1.0f, 1.0f);
+    return static_cast<int16_t>(std::lround(value * 32767.0f));
+}
+
+// float32 -> float16 with round to nearest even
+inline uint16_t floatToHalf(float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF){ // inf / nan
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+    if (exponent >= 31){                // overflow
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    if (exponent <= 0){                 // subnormal or zero
+        if (exponent < -10){
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))){
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))){
+        half++; // may carry into exponent, which is the correct rounding
+    }
+    return static_cast<uint16_t>(half);
+}
+
+inline float halfToFloat(uint16_t half){
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0){
+        if (mantissa == 0){
+            bits = sign;
+        } else {
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400) == 0){
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    } else if (exponent == 31){
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Octahedral normal encoding (unit vector -> 2 components in [-1, 1])
+inline void octEncode(const float n[3], int16_t out[2]){
+    float l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+    if (l1 == 0.0f){
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+    float x = n[0] / l1;
+    float y = n[1] / l1;
+    if (n[2] < 0.0f){
+        float ox = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float oy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = ox;
+        y = oy;
+    }
+    out[0] = quantizeSnorm16(x);
+    out[1] = quantizeSnorm16(y);
+}
+
+inline void octDecode(const int16_t in[2], float n[3]){
+    float x = std::max(in[0] / 32767.0f, -1.0f);
+    float y = std::max(in[1] / 32767.0f, -1.0f);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f){
+        float ox = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float oy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = ox;
+        y = oy;
+    }
+    float length = std::sqrt(x * x + y * y + z * z);
+    n[0] = x / length;
+    n[1] = y / length;
+    n[2] = z / length;
+}
+
+} // namespace meshformat
@@ -0,0 +1,141 @@
+#include "meshoptimizer.hpp"
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize){
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0){
+        return;
+    }
+
+    // Vertex -> triangles adjacency (CSR)
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (uint32_t index : indices){
+        liveTriangles[index]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < vertexCount; i++){
+        adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveTriangles[i];
+    }
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++){
+        adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd{};
+    std::vector<uint32_t> candidates{};
+    std::vector<uint32_t> result{};
+    result.reserve(indices.size());
+
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0; // next vertex in input order, used when dead end stack is empty
+    int64_t fanning = 0;
+
+    while (fanning >= 0){
+        candidates.clear();
+
+        // Emit all triangles of fanning vertex
+        for (uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++){
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle]){
+                continue;
+            }
+            for (uint32_t k = 0; k < 3; k++){
+                uint32_t vertex = indices[triangle * 3 + k];
+                result.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (time - cacheTime[vertex] > cacheSize){
+                    cacheTime[vertex] = time++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // Next fanning vertex: the candidate that stays longest in cache after its triangles are emitted
+        int64_t next = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates){
+            if (liveTriangles[vertex] == 0){
+                continue;
+            }
+            int64_t priority = 0;
+            if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize){
+                priority = time - cacheTime[vertex];
+            }
+            if (priority > bestPriority){
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        // Dead end: take recently used vertex from stack, then fall back to input order
+        if (next == -1){
+            while (!deadEnd.empty()){
+                uint32_t vertex = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[vertex] > 0){
+                    next = vertex;
+                    break;
+                }
+            }
+        }
+        if (next == -1){
+            while (cursor < vertexCount){
+                if (liveTriangles[cursor] > 0){
+                    next = cursor;
+                    break;
+                }
+                cursor++;
+            }
+        }
+
+        fanning = next;
+    }
+
+    indices.swap(result);
+}
+
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount){
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t next = 0;
+
+    for (uint32_t& index : indices){
+        if (remap[index] == UINT32_MAX){
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+
+    // Unreferenced vertices go to the end
+    for (uint32_t& value : remap){
+        if (value == UINT32_MAX){
+            value = next++;
+        }
+    }
+
+    return remap;
+}
+
+float analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize){
+    if (indices.empty()){
+        return 0.0f;
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+
+    for (uint32_t index : indices){
+        if (time - cacheTime[index] > cacheSize){
+            cacheTime[index] = time++;
+            misses++;
+        }
+    }
+
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Offline index / vertex buffer optimizations used by the mesh converter
+
+// Reorders triangles for the post-transform vertex cache (Tipsify, Sander et al. 2007)
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+// Reorders vertices in order of first use so vertex fetch walks memory linearly (reduces overfetch).
+// Returns remap table: remap[oldIndex] = newIndex. Indices are rewritten in place.
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount);
+
+// Average cache miss ratio (transformed vertices per triangle) for a FIFO cache of given size
+float analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16);
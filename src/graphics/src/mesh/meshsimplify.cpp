@@ -0,0 +1,244 @@
+#include "meshsimplify.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Symmetric 4x4 matrix: sum of squared distances to planes. Doubles, errors are small differences.
+struct Quadric {
+    double xx = 0, xy = 0, xz = 0, xw = 0, yy = 0, yz = 0, yw = 0, zz = 0, zw = 0, ww = 0;
+
+    void addPlane(double a, double b, double c, double d){
+        xx += a * a; xy += a * b; xz += a * c; xw += a * d;
+        yy += b * b; yz += b * c; yw += b * d;
+        zz += c * c; zw += c * d;
+        ww += d * d;
+    }
+
+    void add(const Quadric& q){
+        xx += q.xx; xy += q.xy; xz += q.xz; xw += q.xw;
+        yy += q.yy; yz += q.yz; yw += q.yw;
+        zz += q.zz; zw += q.zw;
+        ww += q.ww;
+    }
+
+    double evaluate(const float* p) const {
+        double x = p[0], y = p[1], z = p[2];
+        double error = xx * x * x + 2 * xy * x * y + 2 * xz * x * z + 2 * xw * x
+                     + yy * y * y + 2 * yz * y * z + 2 * yw * y
+                     + zz * z * z + 2 * zw * z
+                     + ww;
+        return std::max(error, 0.0);
+    }
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+static void triangleNormal(const float* a, const float* b, const float* c, float n[3]){
+    float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+static uint64_t edgeKey(uint32_t a, uint32_t b){
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+std::vector<uint32_t> simplifyMesh(const std::vector<uint32_t>& indices, const std::vector<float>& positions,
+                                   size_t targetIndexCount, float maxError, float* resultError){
+    size_t vertexCount = positions.size() / 3;
+    std::vector<uint32_t> result = indices;
+    double worstCost = 0.0;
+
+    // Position welding: vertices split by normal or uv share one canonical vertex and are locked
+    std::vector<uint32_t> order(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++){
+        order[i] = i;
+    }
+    auto position = [&](uint32_t v){ return &positions[size_t(v) * 3]; };
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){
+        return std::lexicographical_compare(position(a), position(a) + 3, position(b), position(b) + 3);
+    });
+    std::vector<uint32_t> canonical(vertexCount);
+    std::vector<bool> locked(vertexCount, false);
+    for (size_t i = 0; i < vertexCount;){
+        size_t end = i + 1;
+        while (end < vertexCount && std::equal(position(order[i]), position(order[i]) + 3, position(order[end]))){
+            end++;
+        }
+        for (size_t k = i; k < end; k++){
+            canonical[order[k]] = order[i];
+            locked[order[k]] = end - i > 1;
+        }
+        i = end;
+    }
+
+    // Border and non manifold edges (not shared by exactly two triangles) lock their vertices
+    std::vector<uint64_t> edges{};
+    edges.reserve(result.size());
+    for (size_t t = 0; t < result.size(); t += 3){
+        for (int k = 0; k < 3; k++){
+            edges.push_back(edgeKey(canonical[result[t + k]], canonical[result[t + (k + 1) % 3]]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    std::vector<bool> lockedCanonical(vertexCount, false);
+    for (size_t i = 0; i < edges.size();){
+        size_t end = i + 1;
+        while (end < edges.size() && edges[end] == edges[i]){
+            end++;
+        }
+        if (end - i != 2){
+            lockedCanonical[edges[i] >> 32] = true;
+            lockedCanonical[edges[i] & 0xFFFFFFFFu] = true;
+        }
+        i = end;
+    }
+    for (size_t v = 0; v < vertexCount; v++){
+        locked[v] = locked[v] || lockedCanonical[canonical[v]];
+    }
+
+    // Plane quadric of every triangle, accumulated on canonical vertices
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t < result.size(); t += 3){
+        const float* a = position(result[t]);
+        float n[3];
+        triangleNormal(a, position(result[t + 1]), position(result[t + 2]), n);
+        double length = std::sqrt(double(n[0]) * n[0] + double(n[1]) * n[1] + double(n[2]) * n[2]);
+        if (length == 0.0){
+            continue;
+        }
+        double nx = n[0] / length, ny = n[1] / length, nz = n[2] / length;
+        Quadric q{};
+        q.addPlane(nx, ny, nz, -(nx * a[0] + ny * a[1] + nz * a[2]));
+        for (int k = 0; k < 3; k++){
+            quadrics[canonical[result[t + k]]].add(q);
+        }
+    }
+
+    double costLimit = double(maxError) * maxError;
+    std::vector<Collapse> collapses{};
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency{};
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+
+    // Passes: cheapest independent collapses first, then index buffer is rewritten
+    while (result.size() > targetIndexCount){
+        collapses.clear();
+        edges.clear();
+        for (size_t t = 0; t < result.size(); t += 3){
+            for (int k = 0; k < 3; k++){
+                edges.push_back(edgeKey(result[t + k], result[t + (k + 1) % 3]));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        for (uint64_t edge : edges){
+            uint32_t a = static_cast<uint32_t>(edge >> 32);
+            uint32_t b = static_cast<uint32_t>(edge & 0xFFFFFFFFu);
+            Quadric q = quadrics[canonical[a]];
+            q.add(quadrics[canonical[b]]);
+            double toB = locked[a] ? INFINITY : q.evaluate(position(b));
+            double toA = locked[b] ? INFINITY : q.evaluate(position(a));
+            if (toB <= toA && toB <= costLimit){
+                collapses.push_back({a, b, toB});
+            } else if (toA < toB && toA <= costLimit){
+                collapses.push_back({b, a, toA});
+            }
+        }
+        if (collapses.empty()){
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r){ return l.cost < r.cost; });
+
+        // Vertex -> triangles adjacency (CSR)
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : result){
+            adjacencyOffsets[index + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; v++){
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+        adjacency.resize(result.size());
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < result.size(); i++){
+            adjacency[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        for (uint32_t v = 0; v < vertexCount; v++){
+            remap[v] = v;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+
+        // every collapse removes about two triangles
+        size_t goal = (result.size() - targetIndexCount) / 6 + 1;
+        size_t performed = 0;
+        for (const Collapse& collapse : collapses){
+            if (performed == goal){
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to]){
+                continue;
+            }
+
+            // Triangles that keep area must not flip
+            bool flips = false;
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1] && !flips; a++){
+                const uint32_t* triangle = &result[size_t(adjacency[a]) * 3];
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to){
+                    continue;
+                }
+                const float* before[3];
+                const float* after[3];
+                for (int k = 0; k < 3; k++){
+                    before[k] = position(triangle[k]);
+                    after[k] = triangle[k] == collapse.from ? position(collapse.to) : before[k];
+                }
+                float n0[3], n1[3];
+                triangleNormal(before[0], before[1], before[2], n0);
+                triangleNormal(after[0], after[1], after[2], n1);
+                flips = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0f;
+            }
+            if (flips){
+                continue;
+            }
+
+            // one ring of from changes shape, no other collapse touches it in this pass
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++){
+                for (int k = 0; k < 3; k++){
+                    touched[result[size_t(adjacency[a]) * 3 + k]] = true;
+                }
+            }
+            remap[collapse.from] = collapse.to;
+            quadrics[canonical[collapse.to]].add(quadrics[collapse.from]);
+            worstCost = std::max(worstCost, collapse.cost);
+            performed++;
+        }
+        if (performed == 0){
+            break;
+        }
+
+        // Rewrite indices, collapsed triangles are degenerate now
+        size_t write = 0;
+        for (size_t t = 0; t < result.size(); t += 3){
+            uint32_t a = remap[result[t]], b = remap[result[t + 1]], c = remap[result[t + 2]];
+            if (a != b && b != c && c != a){
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+        }
+        result.resize(write);
+    }
+
+    if (resultError != nullptr){
+        *resultError = static_cast<float>(std::sqrt(worstCost));
+    }
+    return result;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Offline level of detail generation used by the mesh converter
+
+// Quadric error metric simplification (Garland and Heckbert 1997). Edges collapse onto one of
+// their endpoints, so vertices are never moved or created and every level indexes the original
+// vertex buffer. Border vertices and attribute seams (several vertices at one position) are locked.
+// Stops at targetIndexCount or when next collapse would exceed maxError (position units).
+// resultError: largest error of performed collapses, distance in position units.
+std::vector<uint32_t> simplifyMesh(const std::vector<uint32_t>& indices, const std::vector<float>& positions,
+                                   size_t targetIndexCount, float maxError, float* resultError = nullptr);
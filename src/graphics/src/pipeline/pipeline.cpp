@@ -8,8 +8,8 @@ void Render::createGraphicsPipeline(){
     std::cout << "Creating Graphics Pipeline" << std::endl;
 
     std::vector<Shader> shaders{
-        Shader(this, "shaders/vert.spv", VK_SHADER_STAGE_VERTEX_BIT),
-        Shader(this, "shaders/frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT)
+        Shader(this, "shaders/shader.vert.spv", ShaderType::VERTEX),
+        Shader(this, "shaders/shader.frag.spv", ShaderType::FRAGMENT)
     };
 
     std::cout << "\tShaders loaded" << std::endl;
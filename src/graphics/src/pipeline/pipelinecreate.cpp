@@ -190,16 +190,21 @@ PipelineCreate::PipelineCreate(
 }
 
 PipelineCreate::~PipelineCreate(){
-    if (pipelineLayout != VK_NULL_HANDLE) {
-        vkDestroyPipelineLayout(_render->device, pipelineLayout, nullptr);
-    }
+    // pipelines made from it may still be in flight (hot reload), layout goes when they retire
+    _render->deletionQueue.destroy(pipelineLayout);
     for (auto& shader : shaders){
-        shader.cleanup();
+        _render->deletionQueue.destroy(shader.shadermodule);
     }
 }
 
-void PipelineCreate::createPipeline(VkPipeline* pipeline){
-    if (vkCreateGraphicsPipelines(_render->device, VK_NULL_HANDLE, 1, &createInfo, nullptr, pipeline) != VK_SUCCESS){
+void PipelineCreate::createPipeline(VkPipeline* pipeline, VkPipelineCache cache){
+    if (vkCreateGraphicsPipelines(_render->device, cache, 1, &createInfo, nullptr, pipeline) != VK_SUCCESS){
         throw std::runtime_error("Failed to create graphics pipeline");
     }
-}
\ No newline at end of file
+}
+Task<VkPipeline> PipelineCreate::createPipelineAsync(JobPool& jobs, VkPipelineCache cache){
+    co_await resumeOn(jobs);
+    VkPipeline pipeline;
+    createPipeline(&pipeline, cache);
+    co_return pipeline;
+}
@@ -7,7 +7,7 @@
 #include "../const.h"
 
 // forward declaration
-class App;
+class Render;
 
 class PipelineCreate {
 private:
@@ -49,5 +49,7 @@ public:
 
     ~PipelineCreate();
 
-    void createPipeline(VkPipeline* pipeline);
+    void createPipeline(VkPipeline* pipeline, VkPipelineCache cache = VK_NULL_HANDLE);
+    // Compiles on a JobPool worker, caller continues there. PipelineCreate must outlive the task.
+    Task<VkPipeline> createPipelineAsync(JobPool& jobs, VkPipelineCache cache = VK_NULL_HANDLE);
 };
\ No newline at end of file
@@ -1,13 +1,13 @@
-#include "app.hpp"
+#include "../render.hpp"
 #include <iostream>
 
-void App::createRenderPass(){
+void Render::createRenderPass(){
     std::cout << "Creating Render Pass" << std::endl;
 
     VkAttachmentDescription colorAttachmentDescription{};
     colorAttachmentDescription.format = format.format;                            // swapchain image format
     colorAttachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;         // layout before render pass begins
-    colorAttachmentDescription.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;     // layout after render pass ends
+    colorAttachmentDescription.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL; // layout after render pass ends (scene target is blitted to swapchain)
     colorAttachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;              // load operation (clear the color attachment)
     colorAttachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;            // store operation (store the color attachment to memory)
     colorAttachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;   // stencil load operation (don't care if you don't have stencil buffer, stencil is used for depth testing)
@@ -24,13 +24,21 @@ void App::createRenderPass(){
     subpassDescription.colorAttachmentCount = 1;                                  // number of color attachments
     subpassDescription.pColorAttachments = &colorAttachmentReference;             // color attachment reference
 
-    VkSubpassDependency subpassDependency{};
-    subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;                             // source subpass
-    subpassDependency.dstSubpass = 0;                                               // destination subpass
-    subpassDependency.srcAccessMask = 0;                                            // source access mask
-    subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;         // destination access mask
-    subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT; // source stage mask
-    subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT; // destination stage mask
+    VkSubpassDependency subpassDependencies[2]{};
+    // previous frame's upscale blit reads scene target before this frame overwrites it
+    subpassDependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;                                                             // source subpass
+    subpassDependencies[0].dstSubpass = 0;                                                                               // destination subpass
+    subpassDependencies[0].srcAccessMask = 0;                                                                            // source access mask
+    subpassDependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;                                         // destination access mask
+    subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT; // source stage mask
+    subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;                                 // destination stage mask
+    // rendered scene -> upscale blit
+    subpassDependencies[1].srcSubpass = 0;
+    subpassDependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    subpassDependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    subpassDependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    subpassDependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
 
     VkRenderPassCreateInfo renderpassCreateInfo{};
     renderpassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -38,8 +46,8 @@ void App::createRenderPass(){
     renderpassCreateInfo.pAttachments = &colorAttachmentDescription;              // color attachment description
     renderpassCreateInfo.subpassCount = 1;                                        // number of subpasses
     renderpassCreateInfo.pSubpasses = &subpassDescription;                        // subpass description
-    renderpassCreateInfo.dependencyCount = 0;                                     // number of dependencies
-    renderpassCreateInfo.pDependencies = &subpassDependency;                      // subpass dependency
+    renderpassCreateInfo.dependencyCount = 2;                                     // number of dependencies
+    renderpassCreateInfo.pDependencies = subpassDependencies;                     // subpass dependencies
 
     if (vkCreateRenderPass(device, &renderpassCreateInfo, nullptr, &renderpass) != VK_SUCCESS){
         throw std::runtime_error("Failed to create render pass");
@@ -1,6 +1,7 @@
 #include "shader.hpp"
 #include <fstream>
 #include "../render.hpp"
+#include "../../../job/src/fileread.hpp"
 
 Shader::Shader(Render* render, std::string path, ShaderType bits){
     _render = render;
@@ -14,6 +15,23 @@ Shader::Shader(Render* render, std::string path, ShaderType bits){
     this->createShaderModule();
 }
 
+Shader::Shader(Render* render, std::string path, ShaderType bits, std::vector<char> code){
+    _render = render;
+    this->bits = (VkShaderStageFlagBits)bits;
+    this->path = path;
+    this->code = std::move(code);
+    this->createShaderModule();
+}
+
+Task<Shader> Shader::loadAsync(Render* render, JobPool& jobs, std::string path, ShaderType bits){
+    if (path.substr(path.find_last_of(".") + 1) != "spv"){
+        throw std::runtime_error("File is not a SPV file");
+    }
+    std::vector<char> code = co_await readFileAsync(jobs, path);
+    // vkCreateShaderModule needs no external synchronization, module is created on the worker
+    co_return Shader{render, path, bits, std::move(code)};
+}
+
 void Shader::createShaderModule(){
     if (code.size() > 0){
         VkShaderModuleCreateInfo createInfo{};
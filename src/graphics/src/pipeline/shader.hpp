@@ -3,6 +3,7 @@
 #include <string>
 #include <vulkan/vulkan.h>
 #include <vector>
+#include "../../../job/src/task.hpp"
 
 // forward declaration
 class Render;
@@ -27,5 +28,10 @@ public:
     VkShaderModule shadermodule;
 
     Shader(Render* render, std::string path, ShaderType bits);
+    // SPIR-V already read, path is kept for errors only
+    Shader(Render* render, std::string path, ShaderType bits, std::vector<char> code);
     void cleanup();
+
+    // Reads file and creates module on a JobPool worker, caller continues there
+    static Task<Shader> loadAsync(Render* render, JobPool& jobs, std::string path, ShaderType bits);
 };
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include "render.hpp"
+#include "texture/texturestreamer.hpp"
 #include <vector>
 #include <stdexcept>
 #include <iostream>
 #include <cstring>
+#include <chrono>
+#include <thread>
+#include "../../memory/src/allocationtracker.hpp"
 
-#include "window.hpp"
+#include "src/window.hpp"
 
 VKAPI_ATTR VkBool32 VKAPI_CALL debug_utils_messenger_callback(
     VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
@@ -33,73 +37,209 @@ void Render::initVulkan(){
     createImageViews();
     createRenderPass();
     createGraphicsPipeline();
-    createFramebuffers();
+    createSceneTarget();
     createCommandBuffers();
     sync();
+    createLatencyTracking();
+    createFramePacing();
+    createAsyncCompute();
+    createTextureStreaming();
 }
 
 void Render::loop(){
-    int currentFrame = 0;
-    uint64_t framesCount = 0;
+    RenderCommandBuffer commands{};
 
     std::cout << "Starting main loop" << std::endl << std::endl;
 
-    while (!glfwWindowShouldClose(window)) {
-        std::cout << "=== Frame " << framesCount << " ===" << std::endl;
-
+    std::chrono::steady_clock::time_point lastOverlay = std::chrono::steady_clock::now();
+    while (!glfwWindowShouldClose(window->getWindow())) {
+        // GPU is still busy for a while, sample input as late as possible
+        std::this_thread::sleep_for(std::chrono::duration<double>(framePacer.sleepBeforeInput()));
         glfwPollEvents();
+        commands.inputTimestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
 
-        if (currentFrame >= MAX_FRAMES_IN_FLIGHT) {
-            std::cout << "ERROR: currentFrame out of bounds: " << currentFrame << std::endl;
+        AllocationTracker::beginFrame();
+        if (!drawFrame(commands)) {
             break;
         }
+        AllocationTracker::endFrame();
 
-        std::cout << "Waiting for fence..." << std::endl;
-        vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
-        std::cout << "Fence signaled, resetting..." << std::endl;
-        vkResetFences(device, 1, &inFlightFences[currentFrame]);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (stats.overlayEnabled() && std::chrono::duration<double>(now - lastOverlay).count() >= RENDER_STATS_OVERLAY_INTERVAL) {
+            AllowAllocationsScope allow{};
+            glfwSetWindowTitle(window->getWindow(), stats.summary().c_str());
+            lastOverlay = now;
+        }
+    }
+    vkDeviceWaitIdle(device);
+}
 
-        uint32_t imageIndex;
-        vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+void Render::registerCommand(RenderCommandType type, RenderCommandHandler handler){
+    commandHandlers[type] = handler;
+}
 
-        std::cout << "Acquired image index: " << imageIndex << std::endl;
+void Render::registerPrePassCommand(RenderCommandType type, RenderCommandHandler handler){
+    prePassHandlers[type] = handler;
+}
 
-        recordCommandBuffer(commandBuffers[currentFrame], imageIndex);
+bool Render::drawFrame(const RenderCommandBuffer& commands){
+    MemoryTagScope tag{MemoryTag::RENDER};
+    std::cout << "=== Frame " << framesCount << " ===" << std::endl;
 
-        std::cout << "Recorded command buffer" << std::endl;
+    if (currentFrame >= MAX_FRAMES_IN_FLIGHT) {
+        std::cout << "ERROR: currentFrame out of bounds: " << currentFrame << std::endl;
+        return false;
+    }
 
-        VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    using Clock = std::chrono::steady_clock;
+    std::cout << "Waiting for fence..." << std::endl;
+    Clock::time_point waitStart = Clock::now();
+    vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    // cpu time starts here, retiring the slot below is frame work rather than waiting
+    Clock::time_point frameStart = Clock::now();
+    std::cout << "Fence signaled, resetting..." << std::endl;
+    vkResetFences(device, 1, &inFlightFences[currentFrame]);
+    deletionQueue.retire(currentFrame);
+    stats.frameRetired(currentFrame);
+
+    FrameTimings timings{};
+    timings.fenceWait = std::chrono::duration<double>(frameStart - waitStart).count();
+    readGpuTimes(currentFrame, timings.gpu, timings.gpuIdle);
+    updateRenderResolution(timings.gpu);
+
+    // GPU is done with this slot, so is everything allocated for it
+    frameAllocator.beginFrame(currentFrame);
+
+    // Loading coroutines: GPU waits that finished, then work handed to render thread, within budget.
+    // Loading allocates (coroutine frames, staging), it is not steady state frame work
+    {
+        AllowAllocationsScope allow{};
+        gpuWaits.poll();
+        renderTasks.drain(taskBudget);
+    }
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
-        submitInfo.pWaitSemaphores = &imageAvailableSemaphores[currentFrame];
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = &renderFinishedSemaphores[currentFrame];
-        submitInfo.pWaitDstStageMask = waitStages;
+    if (latencyTracker) {
+        latencyTracker->frameRetired(currentFrame);
+    }
 
-        if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to submit draw command buffer");
+    // mip uploads and evictions for demand requested last frame
+    if (textureStreamer) {
+        textureStreamer->update();
+    }
+
+    uint32_t imageIndex;
+    VkResult acquireResult = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+    if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR) {
+        if (latencyTracker) {
+            latencyTracker->frameDropped(currentFrame);
         }
+        throw std::runtime_error("Failed to acquire swapchain image");
+    }
+
+    std::cout << "Acquired image index: " << imageIndex << std::endl;
+
+    recordCommandBuffer(commandBuffers[currentFrame], imageIndex, commands);
 
-        VkPresentInfoKHR presentInfo{};
-        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = &renderFinishedSemaphores[currentFrame];
-        presentInfo.swapchainCount = 1;
-        presentInfo.pSwapchains = &swapchain;
-        presentInfo.pImageIndices = &imageIndex;
+    std::cout << "Recorded command buffer" << std::endl;
+
+    // Only upscale blit touches swapchain image, scene rendering does not wait for acquire
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT};
+
+    // Compute submitted for this frame: graphics waits only at the stage that consumes it
+    VkSemaphore waitSemaphores[2] = {imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE};
+    VkPipelineStageFlags waitDstStages[2] = {waitStages[0], 0};
+    uint64_t waitValues[2] = {0, 0};
+    uint32_t waitCount = 1;
+    bool timelineWait = false;
+    if (asyncCompute && asyncCompute->graphicsWait(&waitSemaphores[1], &waitValues[1], &waitDstStages[1], &timelineWait)) {
+        waitCount = 2;
+    }
+
+    // Compute of next frames may wait for this submit (dedicated compute queue only)
+    VkSemaphore signalSemaphores[2] = {renderFinishedSemaphores[imageIndex], VK_NULL_HANDLE};
+    uint64_t signalValues[2] = {0, 0};
+    uint32_t signalCount = 1;
+    if (asyncCompute && asyncCompute->graphicsSignal(&signalSemaphores[1], &signalValues[1])) {
+        signalCount = 2;
+    }
 
-        if (vkQueuePresentKHR(presentQueue, &presentInfo) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to present swapchain image");
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
+    submitInfo.pWaitSemaphores = waitSemaphores;
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.signalSemaphoreCount = signalCount;
+    submitInfo.pSignalSemaphores = signalSemaphores;
+    submitInfo.pWaitDstStageMask = waitDstStages;
+
+    // binary semaphores ignore their value
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+    if (timelineWait || signalCount == 2) {
+        timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineSubmitInfo.waitSemaphoreValueCount = waitCount;
+        timelineSubmitInfo.pWaitSemaphoreValues = waitValues;
+        timelineSubmitInfo.signalSemaphoreValueCount = signalCount;
+        timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+        submitInfo.pNext = &timelineSubmitInfo;
+    }
+
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit draw command buffer");
+    }
+    deletionQueue.submitted(currentFrame);
+    stats.endFrame(currentFrame, framesCount);
+    if (timestampQueryPool != VK_NULL_HANDLE) {
+        timestampsWritten[currentFrame] = true;
+    }
+
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &renderFinishedSemaphores[imageIndex];
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &swapchain;
+    presentInfo.pImageIndices = &imageIndex;
+
+    VkResult presentResult;
+    if (latencyTracker) {
+        VkPresentIdKHR presentIdInfo{};
+        uint64_t presentId = latencyTracker->beginPresent(&presentInfo, &presentIdInfo, commands.inputTimestamp);
+        {
+            std::lock_guard<std::mutex> lock{latencyTracker->presentMutex};
+            presentResult = vkQueuePresentKHR(presentQueue, &presentInfo);
         }
+        // frame that never reached display must not leave a sample behind
+        if (presentResult == VK_SUCCESS) {
+            latencyTracker->endPresent(presentId, currentFrame, commands.inputTimestamp);
+        } else {
+            latencyTracker->frameDropped(currentFrame, presentId);
+        }
+        latencyTracker->report();
+    } else {
+        presentResult = vkQueuePresentKHR(presentQueue, &presentInfo);
+    }
 
-        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
-        framesCount++;
+    if (presentResult != VK_SUCCESS) {
+        throw std::runtime_error("Failed to present swapchain image");
     }
-    vkDeviceWaitIdle(device);
+
+    timings.cpu = std::chrono::duration<double>(Clock::now() - frameStart).count();
+    framePacer.frameCompleted(timings);
+
+    // Slots above pacer's count are skipped; their fences are waited when count grows again,
+    // their timestamps would be out of order by then
+    uint32_t framesInFlight = framePacer.framesInFlight();
+    for (uint32_t i = framesInFlight; i < timestampsWritten.size(); i++) {
+        timestampsWritten[i] = false;
+        if (latencyTracker) {
+            latencyTracker->frameDropped(i);
+        }
+    }
+    currentFrame = (currentFrame + 1) % framesInFlight;
+    framesCount++;
+    return true;
 }
 
 void Render::createInstance() {
@@ -217,7 +357,9 @@ void Render::setupDebugMessenger(){
 }
 
 void Render::createSurface(){
-    window.getWindowSurface(instance, &surface);
+    Surface windowSurface{};
+    windowSurface.createVulkanSurface(instance, window->getWindow());
+    surface = windowSurface.vulkanSurface;
 }
 
 Render::~Render(){
@@ -226,6 +368,20 @@ Render::~Render(){
     }
 
     if (device != VK_NULL_HANDLE) {
+        // waiter thread polls swapchain
+        delete latencyTracker;
+        latencyTracker = nullptr;
+
+        // hands its images to deletion queue
+        delete textureStreamer;
+        textureStreamer = nullptr;
+
+        deletionQueue.flush();
+        stats.destroy();
+
+        delete asyncCompute;
+        asyncCompute = nullptr;
+
         if (!commandBuffers.empty() && commandPool != VK_NULL_HANDLE) {
             vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
             commandBuffers.clear();
@@ -236,6 +392,11 @@ Render::~Render(){
             commandPool = VK_NULL_HANDLE;
         }
 
+        if (timestampQueryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, timestampQueryPool, nullptr);
+            timestampQueryPool = VK_NULL_HANDLE;
+        }
+
         for (auto semaphore : imageAvailableSemaphores) {
             if (semaphore != VK_NULL_HANDLE) {
                 vkDestroySemaphore(device, semaphore, nullptr);
@@ -257,6 +418,8 @@ Render::~Render(){
         }
         inFlightFences.clear();
 
+        destroySceneTarget();
+
         for (auto framebuffer : framebuffers) {
             if (framebuffer != VK_NULL_HANDLE) {
                 vkDestroyFramebuffer(device, framebuffer, nullptr);
@@ -3,43 +3,103 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <functional>
+#include <unordered_map>
 #include "pipeline.hpp"
+#include "commandstream.hpp"
+#include "latency.hpp"
+#include "capabilities.hpp"
+#include "framepacer.hpp"
+#include "resolutionscaler.hpp"
+#include "asynccompute.hpp"
+#include "gpuwaits.hpp"
+#include "deletionqueue.hpp"
+#include "renderstats.hpp"
+#include "../../memory/src/arena.hpp"
+#include "../../job/src/task.hpp"
 #include "src/window.hpp"
 
 #include "const.h"
 
+// forward declaration
+class TextureStreamer;
+
+// Replays one render command into frame command buffer
+using RenderCommandHandler = std::function<void(VkCommandBuffer commandBuffer, const void* payload)>;
+
 class Render{
 public:
     Window* window;                                    // Window
     VkInstance instance{};                             // Vulkan runtime
-    VkDebugUtilsMessengerEXT debugMessenger;           // debug
-    VkSurfaceKHR surface;                              // surface
+    VkDebugUtilsMessengerEXT debugMessenger{};         // debug
+    VkSurfaceKHR surface{};                            // surface
     VkPhysicalDevice physicalDevice{};                 // physical device
-    VkDevice device;                                   // logical device
+    VkDevice device{};                                 // logical device
     VkSurfaceFormatKHR format;                         // format
     VkSwapchainKHR swapchain{};                        // swapchain
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR; // present mode of swapchain
     std::vector<VkImage> swapchainImages{};            // For images
     std::vector<VkImageView> swapchainImageViews{};    // For image views
     std::vector<VkFramebuffer> framebuffers{};         // framebuffers
     VkExtent2D extent{};                               // extent (surface size)
+    VkExtent2D renderExtent{};                         // scene resolution this frame, <= extent
     VkViewport viewport{};                             // viewport
     VkRect2D scissor{};                                // scissor
     VkPipelineViewportStateCreateInfo viewportState;   // viewport
-    VkPipeline pipeline;                               // graphics pipeline
-    VkRenderPass renderpass;                           // render pass (recipe of making images)
+    VkPipeline pipeline{};                             // graphics pipeline
+    VkRenderPass renderpass{};                         // render pass (recipe of making images)
     std::vector<VkCommandBuffer> commandBuffers{};     // command buffers
-    VkCommandPool commandPool;                         // command pool
+    VkCommandPool commandPool{};                       // command pool
     std::vector<VkSemaphore> imageAvailableSemaphores; // semaphores (sync threads that avilable to draw)
-    std::vector<VkSemaphore> renderFinishedSemaphores; // semaphores (sync threads that finished render)
+    std::vector<VkSemaphore> renderFinishedSemaphores; // semaphores (sync threads that finished render), per swapchain image
     std::vector<VkFence> inFlightFences;               // fences (sync cpu with gpu) 
 
     uint32_t graphicsQueueFamilyIndex;                 // thread that can draw
     uint32_t presentQueueFamilyIndex;                  // thread that can present
+    uint32_t computeQueueFamilyIndex;                  // async compute, graphics family when device has no compute-only one
 
-    PipelineCreate* pipelineCreate;                    // pipeline creater
+    DeviceCapabilities capabilities{};                 // features and limits of selected device, what is enabled
+
+    PipelineCreate* pipelineCreate = nullptr;          // pipeline creater
 
     VkQueue graphicsQueue;                             // graphics queue
     VkQueue presentQueue;                              // present queue
+    VkQueue computeQueue;                              // async compute queue (may be graphicsQueue)
+
+    AsyncCompute* asyncCompute = nullptr;              // compute work overlapping graphics
+    TextureStreamer* textureStreamer = nullptr;        // KTX2 mips streamed within memory budget, updated before recording
+
+    uint32_t currentFrame = 0;                         // frame in flight index, < framePacer.framesInFlight()
+    uint64_t framesCount = 0;                          // presented frames
+
+    LatencyTracker* latencyTracker = nullptr;          // input-to-photon measurement, present wait when supported
+    bool measureLatency = true;                        // set false before initVulkan() to skip latency tracking
+
+    FrameAllocator frameAllocator{MAX_FRAMES_IN_FLIGHT}; // render thread transient CPU memory, slot reset when its fence retires
+
+    ResumeQueue renderTasks{};                         // coroutines continuing on render thread (co_await resumeOn(renderTasks))
+    GpuWaitQueue gpuWaits{this};                       // coroutines waiting for fences and timeline values
+    DeletionQueue deletionQueue{this};                 // objects replaced at runtime, destroyed when frames using them retire
+    RenderStats stats{this};                           // per frame draw / bind / barrier / upload counters, optional GPU statistics
+    double taskBudget = 0.002;                         // seconds per frame spent resuming renderTasks
+
+    FramePacer framePacer{MAX_FRAMES_IN_FLIGHT};       // frames in flight (1..MAX_FRAMES_IN_FLIGHT) and pre-input sleep
+    VkQueryPool timestampQueryPool{};                  // 2 timestamps per frame slot, null without timestamp support
+    std::vector<bool> timestampsWritten{};             // slot has timestamps from a submitted frame
+    uint64_t lastGpuEnd = 0;                           // end timestamp of last retired frame
+
+    // Dynamic resolution: scene renders into part of offscreen target, blit upscales it to swapchain
+    VkImage sceneImage{};                              // full extent, scales never reallocate it
+    VkDeviceMemory sceneMemory{};
+    VkImageView sceneImageView{};
+    VkFramebuffer sceneFramebuffer{};                  // always set by initVulkan; null only in HeadlessRender, whose own render pass targets framebuffers
+    VkFilter upscaleFilter = VK_FILTER_LINEAR;
+    ResolutionScaler resolutionScaler{};               // scale from GPU timestamps against frame budget
+    std::vector<float> sceneScales{};                  // scale each frame slot was rendered at
+    double gpuFrameBudget = 1.0 / 60.0;                // GPU budget when present mode is not vsynced
+
+    std::unordered_map<RenderCommandType, RenderCommandHandler> commandHandlers{}; // render command replay
+    std::unordered_map<RenderCommandType, RenderCommandHandler> prePassHandlers{}; // replayed before render pass (compute, copies)
 
     Render(Window* window) : window(window) {}
     
@@ -60,6 +120,12 @@ public:
 
     void loop();
 
+    // Waits for frame slot, records commands, submits and presents (render thread)
+    bool drawFrame(const RenderCommandBuffer& commands);
+    void registerCommand(RenderCommandType type, RenderCommandHandler handler);
+    // Handler records outside render pass, before commands of any type are drawn
+    void registerPrePassCommand(RenderCommandType type, RenderCommandHandler handler);
+
     // For Vulkan initialization
     void createInstance();
     void setupDebugMessenger();
@@ -73,6 +139,30 @@ public:
     void createFramebuffers();
     void createCommandBuffers();
     void sync();
+    void createFramePacing();
+    void createLatencyTracking();
+    void createAsyncCompute();
+    void createTextureStreaming();
+    void createSceneTarget();
+    void destroySceneTarget();
+
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, const RenderCommandBuffer& commands);
+
+    // GPU time of frame that last used slot, seconds; false when unknown
+    bool readGpuTimes(uint32_t frame, double& gpuTime, double& gpuIdle);
+
+    // Feeds GPU time of retired slot (< 0 unknown) to scaler, sets renderExtent, viewport and scissor
+    void updateRenderResolution(double gpuTime);
+    // Blits scene target to swapchain image, leaves it ready to present
+    void recordUpscale(VkCommandBuffer commandBuffer, uint32_t imageIndex);
 
-    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    // Buffers
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    // computeShared: also used on async compute queue (AsyncCompute::shareBuffer)
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* buffer, VkDeviceMemory* memory, bool computeShared = false);
+    void uploadBuffer(VkBuffer dst, const void* data, VkDeviceSize size);
+    // Staging copy from any thread, recorded and submitted on render thread; completes when GPU copy is done
+    Task<void> uploadBufferAsync(VkBuffer dst, std::vector<char> data);
+    VkCommandBuffer beginSingleTimeCommands();
+    void endSingleTimeCommands(VkCommandBuffer commandBuffer);
 };
\ No newline at end of file
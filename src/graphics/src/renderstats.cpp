@@ -0,0 +1,176 @@
+#include "renderstats.hpp"
+#include "render.hpp"
+#include "texture/texturestreamer.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <iomanip>
+
+// Order of results follows bit order
+#define STATISTICS_FLAGS (VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | \
+                          VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT | \
+                          VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | \
+                          VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | \
+                          VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT | \
+                          VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT)
+#define STATISTICS_VALUES 6
+
+void RenderStats::beginFrame(VkCommandBuffer commandBuffer, uint32_t frame){
+    recording = false;
+    bool wanted = queriesWanted.load(std::memory_order_relaxed) && _render->capabilities.pipelineStatisticsQuery;
+
+    if (wanted && queryPool == VK_NULL_HANDLE){
+        VkQueryPoolCreateInfo queryPoolCreateInfo{};
+        queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolCreateInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        queryPoolCreateInfo.queryCount = MAX_FRAMES_IN_FLIGHT * STATISTICS_PASS_COUNT;
+        queryPoolCreateInfo.pipelineStatistics = STATISTICS_FLAGS;
+        if (vkCreateQueryPool(_render->device, &queryPoolCreateInfo, nullptr, &queryPool) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create pipeline statistics query pool");
+        }
+        queryFrames.assign(MAX_FRAMES_IN_FLIGHT, 0);
+    } else if (!wanted && queryPool != VK_NULL_HANDLE){
+        // frames in flight may still write it
+        _render->deletionQueue.destroy(queryPool);
+        queryPool = VK_NULL_HANDLE;
+        queryFrames.clear();
+        gpuLatest = {};
+    }
+
+    if (queryPool != VK_NULL_HANDLE){
+        vkCmdResetQueryPool(commandBuffer, queryPool, frame * STATISTICS_PASS_COUNT, STATISTICS_PASS_COUNT);
+        queryFrames[frame] = 0;
+        recording = true;
+    }
+}
+
+void RenderStats::beginPass(VkCommandBuffer commandBuffer, uint32_t frame, StatisticsPass pass){
+    if (recording){
+        vkCmdBeginQuery(commandBuffer, queryPool, frame * STATISTICS_PASS_COUNT + static_cast<uint32_t>(pass), 0);
+    }
+}
+
+void RenderStats::endPass(VkCommandBuffer commandBuffer, uint32_t frame, StatisticsPass pass){
+    if (recording){
+        vkCmdEndQuery(commandBuffer, queryPool, frame * STATISTICS_PASS_COUNT + static_cast<uint32_t>(pass));
+    }
+}
+
+void RenderStats::frameRetired(uint32_t frame){
+    if (queryPool == VK_NULL_HANDLE || queryFrames[frame] == 0 || queryFrames[frame] <= gpuLatest.gpuFrame){
+        return;
+    }
+
+    // fence of slot is signaled, results are available without waiting
+    uint64_t results[STATISTICS_PASS_COUNT][STATISTICS_VALUES];
+    if (vkGetQueryPoolResults(_render->device, queryPool, frame * STATISTICS_PASS_COUNT, STATISTICS_PASS_COUNT,
+                              sizeof(results), results, sizeof(results[0]), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS){
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{mutex};
+    gpuLatest.gpuValid = true;
+    gpuLatest.gpuFrame = queryFrames[frame];
+    for (uint32_t pass = 0; pass < STATISTICS_PASS_COUNT; pass++){
+        PipelineStatistics& statistics = gpuLatest.gpu[pass];
+        statistics.inputVertices = results[pass][0];
+        statistics.inputPrimitives = results[pass][1];
+        statistics.vertexInvocations = results[pass][2];
+        statistics.clippingPrimitives = results[pass][3];
+        statistics.fragmentInvocations = results[pass][4];
+        statistics.computeInvocations = results[pass][5];
+    }
+}
+
+void RenderStats::endFrame(uint32_t slot, uint64_t frame){
+    if (recording){
+        // serial 0 means nothing written, so frames count from 1 here
+        queryFrames[slot] = frame + 1;
+        recording = false;
+    }
+
+    RenderStatistics statistics{};
+    statistics.frame = frame;
+    statistics.draws = draws.exchange(0, std::memory_order_relaxed);
+    statistics.indirectDraws = indirectDraws.exchange(0, std::memory_order_relaxed);
+    statistics.dispatches = dispatches.exchange(0, std::memory_order_relaxed);
+    statistics.pipelineBinds = pipelineBinds.exchange(0, std::memory_order_relaxed);
+    statistics.descriptorBinds = descriptorBinds.exchange(0, std::memory_order_relaxed);
+    statistics.barriers = barriers.exchange(0, std::memory_order_relaxed);
+    statistics.triangles = triangles.exchange(0, std::memory_order_relaxed);
+    statistics.bytesUploaded = bytesUploaded.exchange(0, std::memory_order_relaxed);
+
+    // streamer updates on this thread before recording, its stats belong to this frame
+    if (_render->textureStreamer){
+        const TextureStreamingStats& streaming = _render->textureStreamer->stats();
+        statistics.streamedTextures = streaming.textureCount;
+        statistics.streamedResident = streaming.fullyResident;
+        statistics.streamingPending = streaming.pendingLevels;
+        statistics.mipsUploaded = streaming.levelsUploaded;
+        statistics.mipsEvicted = streaming.levelsEvicted;
+        statistics.textureBytes = streaming.residentBytes;
+        statistics.textureBudget = streaming.budgetBytes;
+    }
+
+    std::lock_guard<std::mutex> lock{mutex};
+    statistics.gpuValid = gpuLatest.gpuValid;
+    statistics.gpuFrame = gpuLatest.gpuValid ? gpuLatest.gpuFrame - 1 : 0;
+    for (uint32_t pass = 0; pass < STATISTICS_PASS_COUNT; pass++){
+        statistics.gpu[pass] = gpuLatest.gpu[pass];
+    }
+    lastFrame = statistics;
+}
+
+void RenderStats::destroy(){
+    if (queryPool != VK_NULL_HANDLE){
+        vkDestroyQueryPool(_render->device, queryPool, nullptr);
+        queryPool = VK_NULL_HANDLE;
+    }
+}
+
+RenderStatistics RenderStats::last(){
+    std::lock_guard<std::mutex> lock{mutex};
+    return lastFrame;
+}
+
+static std::string shortCount(uint64_t value){
+    std::ostringstream out{};
+    out << std::fixed << std::setprecision(1);
+    if (value >= 1000000){
+        out << value / 1e6 << "M";
+    } else if (value >= 10000){
+        out << value / 1e3 << "k";
+    } else {
+        out << value;
+    }
+    return out.str();
+}
+
+std::string RenderStats::summary(){
+    RenderStatistics statistics = last();
+    std::ostringstream out{};
+    out << std::fixed << std::setprecision(1);
+    out << "draws " << statistics.draws << " (" << statistics.drawsPerPipeline() << "/pipeline)"
+        << " | indirect " << statistics.indirectDraws
+        << " | pipelines " << statistics.pipelineBinds
+        << " | sets " << statistics.descriptorBinds
+        << " | barriers " << statistics.barriers
+        << " | dispatches " << statistics.dispatches
+        << " | tris " << shortCount(statistics.triangles)
+        << " | upload " << shortCount(statistics.bytesUploaded) << "B";
+    if (statistics.streamedTextures > 0){
+        out << " | textures " << statistics.streamedResident << "/" << statistics.streamedTextures
+            << " pending " << statistics.streamingPending
+            << " mips +" << statistics.mipsUploaded << " -" << statistics.mipsEvicted
+            << " " << shortCount(statistics.textureBytes) << "B/" << shortCount(statistics.textureBudget) << "B";
+    }
+    if (statistics.gpuValid){
+        const PipelineStatistics& scene = statistics.gpu[static_cast<uint32_t>(StatisticsPass::SCENE)];
+        const PipelineStatistics& prePass = statistics.gpu[static_cast<uint32_t>(StatisticsPass::PRE_PASS)];
+        out << " | gpu prims " << shortCount(scene.inputPrimitives + prePass.inputPrimitives)
+            << " clipped " << shortCount(scene.clippingPrimitives + prePass.clippingPrimitives)
+            << " vs " << shortCount(scene.vertexInvocations + prePass.vertexInvocations)
+            << " fs " << shortCount(scene.fragmentInvocations + prePass.fragmentInvocations)
+            << " cs " << shortCount(scene.computeInvocations + prePass.computeInvocations);
+    }
+    return out.str();
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Seconds between window title overlay updates
+#define RENDER_STATS_OVERLAY_INTERVAL 0.5
+
+// forward declaration
+class Render;
+
+// Passes with their own pipeline statistics query
+enum class StatisticsPass : uint32_t {
+    PRE_PASS,   // compute and copies before render pass (culling, particles, skinning)
+    SCENE,      // render pass
+    COUNT
+};
+#define STATISTICS_PASS_COUNT static_cast<uint32_t>(StatisticsPass::COUNT)
+
+// GPU counts of one pass (VK_QUERY_TYPE_PIPELINE_STATISTICS)
+struct PipelineStatistics {
+    uint64_t inputVertices = 0;
+    uint64_t inputPrimitives = 0;
+    uint64_t vertexInvocations = 0;
+    uint64_t clippingPrimitives = 0;    // primitives that survived clipping
+    uint64_t fragmentInvocations = 0;
+    uint64_t computeInvocations = 0;
+};
+
+struct RenderStatistics {
+    uint64_t frame = 0;
+    // recorded on CPU
+    uint32_t draws = 0;             // draw calls, an indirect call counts once
+    uint32_t indirectDraws = 0;     // draws an indirect call may produce (drawCount)
+    uint32_t dispatches = 0;
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorBinds = 0;   // vkCmdBindDescriptorSets calls
+    uint32_t barriers = 0;          // vkCmdPipelineBarrier calls
+    uint64_t triangles = 0;         // of direct draws, as triangle lists
+    uint64_t bytesUploaded = 0;     // staging copies since previous frame
+    // texture streaming of this frame, zero without TextureStreamer
+    uint32_t streamedTextures = 0;
+    uint32_t streamedResident = 0;  // textures that have all requested mips
+    uint32_t streamingPending = 0;  // requested mips not resident yet
+    uint32_t mipsUploaded = 0;
+    uint32_t mipsEvicted = 0;
+    uint64_t textureBytes = 0;      // resident streamed texture memory
+    uint64_t textureBudget = 0;     // effective streaming budget
+    // GPU, from pipeline statistics queries of an older frame (frames in flight later)
+    bool gpuValid = false;
+    uint64_t gpuFrame = 0;
+    PipelineStatistics gpu[STATISTICS_PASS_COUNT]{};
+
+    // draw calls per pipeline bind, batching efficiency at a glance
+    float drawsPerPipeline() const { return pipelineBinds > 0 ? float(draws) / float(pipelineBinds) : float(draws); }
+};
+
+// Per frame render counters. Command recording goes through the methods below instead of vkCmd*,
+// they count and record the command:
+//
+//   _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+//   _render->stats.drawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+//
+// Counters are relaxed atomics, so uploads from loader threads count too. drawFrame closes the
+// frame after submit; last() is the previous complete frame. Pipeline statistics queries are
+// optional (feature pipelineStatisticsQuery), off until setPipelineQueries(true).
+class RenderStats {
+private:
+    Render* _render;
+
+    std::atomic<uint32_t> draws{0};
+    std::atomic<uint32_t> indirectDraws{0};
+    std::atomic<uint32_t> dispatches{0};
+    std::atomic<uint32_t> pipelineBinds{0};
+    std::atomic<uint32_t> descriptorBinds{0};
+    std::atomic<uint32_t> barriers{0};
+    std::atomic<uint64_t> triangles{0};
+    std::atomic<uint64_t> bytesUploaded{0};
+
+    std::mutex mutex;
+    RenderStatistics lastFrame{};
+
+    // render thread
+    std::atomic<bool> queriesWanted{false};
+    VkQueryPool queryPool = VK_NULL_HANDLE;     // STATISTICS_PASS_COUNT queries per frame slot
+    std::vector<uint64_t> queryFrames{};        // frame slot's queries were written in, 0 none
+    bool recording = false;                     // queries of frame being recorded were reset
+    RenderStatistics gpuLatest{};
+
+    std::atomic<bool> overlay{false};
+
+public:
+    RenderStats(Render* render) : _render(render) {}
+
+    // Commands, counted
+    void bindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipeline pipeline){
+        pipelineBinds.fetch_add(1, std::memory_order_relaxed);
+        vkCmdBindPipeline(commandBuffer, bindPoint, pipeline);
+    }
+    void bindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t firstSet,
+                            uint32_t setCount, const VkDescriptorSet* sets, uint32_t dynamicOffsetCount = 0, const uint32_t* dynamicOffsets = nullptr){
+        descriptorBinds.fetch_add(1, std::memory_order_relaxed);
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, firstSet, setCount, sets, dynamicOffsetCount, dynamicOffsets);
+    }
+    void draw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance){
+        draws.fetch_add(1, std::memory_order_relaxed);
+        triangles.fetch_add(uint64_t(vertexCount / 3) * instanceCount, std::memory_order_relaxed);
+        vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+    }
+    void drawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance){
+        draws.fetch_add(1, std::memory_order_relaxed);
+        triangles.fetch_add(uint64_t(indexCount / 3) * instanceCount, std::memory_order_relaxed);
+        vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    }
+    void drawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride){
+        draws.fetch_add(1, std::memory_order_relaxed);
+        indirectDraws.fetch_add(drawCount, std::memory_order_relaxed);
+        vkCmdDrawIndirect(commandBuffer, buffer, offset, drawCount, stride);
+    }
+    void drawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride){
+        draws.fetch_add(1, std::memory_order_relaxed);
+        indirectDraws.fetch_add(drawCount, std::memory_order_relaxed);
+        vkCmdDrawIndexedIndirect(commandBuffer, buffer, offset, drawCount, stride);
+    }
+    void dispatch(VkCommandBuffer commandBuffer, uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ){
+        dispatches.fetch_add(1, std::memory_order_relaxed);
+        vkCmdDispatch(commandBuffer, groupsX, groupsY, groupsZ);
+    }
+    void dispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset){
+        dispatches.fetch_add(1, std::memory_order_relaxed);
+        vkCmdDispatchIndirect(commandBuffer, buffer, offset);
+    }
+    void pipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkDependencyFlags flags,
+                         uint32_t memoryBarrierCount, const VkMemoryBarrier* memoryBarriers,
+                         uint32_t bufferBarrierCount, const VkBufferMemoryBarrier* bufferBarriers,
+                         uint32_t imageBarrierCount, const VkImageMemoryBarrier* imageBarriers){
+        barriers.fetch_add(1, std::memory_order_relaxed);
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, flags, memoryBarrierCount, memoryBarriers,
+                             bufferBarrierCount, bufferBarriers, imageBarrierCount, imageBarriers);
+    }
+
+    // Any thread: bytes copied through staging memory
+    void uploaded(uint64_t bytes) { bytesUploaded.fetch_add(bytes, std::memory_order_relaxed); }
+
+    // Render thread, recording frame of slot: query around pass (no-op when queries are off)
+    void beginPass(VkCommandBuffer commandBuffer, uint32_t frame, StatisticsPass pass);
+    void endPass(VkCommandBuffer commandBuffer, uint32_t frame, StatisticsPass pass);
+    // Render thread: at start of recording (resets slot's queries) and after slot's fence wait (reads them)
+    void beginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+    void frameRetired(uint32_t frame);
+    // Render thread, after submitting frame of slot: counters become last() and start over
+    void endFrame(uint32_t slot, uint64_t frame);
+    // Device is idle
+    void destroy();
+
+    // Any thread
+    RenderStatistics last();
+    // Takes effect on render thread at next frame; ignored without pipelineStatisticsQuery feature
+    void setPipelineQueries(bool enabled) { queriesWanted.store(enabled, std::memory_order_relaxed); }
+
+    // Window title overlay, updated by thread that owns window
+    void setOverlay(bool enabled) { overlay.store(enabled, std::memory_order_relaxed); }
+    bool overlayEnabled() const { return overlay.load(std::memory_order_relaxed); }
+    // One line summary, e.g. for overlay or logs
+    std::string summary();
+};
@@ -0,0 +1,41 @@
+#include "resolutionscaler.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Smoothing of full resolution cost, ~5 frame window
+#define RESOLUTION_COST_SMOOTHING 0.2
+
+ResolutionScaler::ResolutionScaler(float minScale, float maxScale){
+    setRange(minScale, maxScale);
+    current = this->maxScale;
+}
+
+void ResolutionScaler::setRange(float minimum, float maximum){
+    minScale = std::clamp(minimum, 0.1f, 1.0f);
+    maxScale = std::clamp(maximum, minScale, 1.0f);
+    current = std::clamp(current, minScale, maxScale);
+}
+
+float ResolutionScaler::update(double gpuTime, float frameScale, double budget){
+    if (gpuTime <= 0.0 || frameScale <= 0.0f || budget <= 0.0){
+        return current;
+    }
+
+    double cost = gpuTime / (static_cast<double>(frameScale) * frameScale);
+    // over budget reacts immediately, under budget slowly
+    if (fullCost < 0.0 || cost > fullCost){
+        fullCost = cost;
+    } else {
+        fullCost += (cost - fullCost) * RESOLUTION_COST_SMOOTHING;
+    }
+
+    float wanted = static_cast<float>(std::sqrt(budget * RESOLUTION_BUDGET_HEADROOM / fullCost));
+    wanted = std::clamp(wanted, minScale, maxScale);
+
+    if (std::abs(wanted - current) < RESOLUTION_SCALE_DEADBAND && wanted != minScale && wanted != maxScale){
+        return current;
+    }
+
+    current += std::clamp(wanted - current, -RESOLUTION_SCALE_RATE, RESOLUTION_SCALE_RATE);
+    return current;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#define RESOLUTION_SCALE_MIN 0.5f
+#define RESOLUTION_SCALE_MAX 1.0f
+// Fraction of frame budget GPU time aims for, rest absorbs spikes
+#define RESOLUTION_BUDGET_HEADROOM 0.9
+// Largest scale change per frame, measurements lag by frames in flight
+#define RESOLUTION_SCALE_RATE 0.05f
+// Changes smaller than this are ignored, so resolution does not shimmer
+#define RESOLUTION_SCALE_DEADBAND 0.02f
+
+// Picks render resolution scale (per axis) from GPU frame times.
+// GPU cost is modelled as proportional to pixel count, so a frame rendered at scale s
+// costs gpu / s^2 at full resolution; fixed costs make model pessimistic when scaling down,
+// which next measurements correct.
+class ResolutionScaler {
+private:
+    float minScale;
+    float maxScale;
+    float current = RESOLUTION_SCALE_MAX;
+    double fullCost = -1.0;  // smoothed GPU seconds at scale 1, < 0 until first sample
+
+public:
+    ResolutionScaler(float minScale = RESOLUTION_SCALE_MIN, float maxScale = RESOLUTION_SCALE_MAX);
+
+    void setRange(float minimum, float maximum);
+
+    // gpuTime of frame that was rendered at frameScale, budget in seconds; returns new scale
+    float update(double gpuTime, float frameScale, double budget);
+
+    float scale() const { return current; }
+};
+
+// Render extent for scale, at least 1 pixel, never above full extent
+inline void scaledExtent(uint32_t width, uint32_t height, float scale, uint32_t& outWidth, uint32_t& outHeight){
+    outWidth = static_cast<uint32_t>(width * scale + 0.5f);
+    outHeight = static_cast<uint32_t>(height * scale + 0.5f);
+    outWidth = outWidth < 1 ? 1 : (outWidth > width ? width : outWidth);
+    outHeight = outHeight < 1 ? 1 : (outHeight > height ? height : outHeight);
+}
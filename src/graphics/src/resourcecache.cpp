@@ -0,0 +1,58 @@
+#include "resourcecache.hpp"
+#include "render.hpp"
+#include "../../world/src/contenthash.hpp"
+#include <stdexcept>
+
+GpuResourceCache::~GpuResourceCache(){
+    for (auto& [hash, shader] : shaders){
+        shader->cleanup();
+    }
+    for (auto& [hash, mesh] : meshes){
+        mesh->cleanup();
+    }
+}
+
+Shader* GpuResourceCache::shader(const std::string& path, ShaderType type, uint64_t hash){
+    if (hash == 0){
+        hash = contentHashFile(path);
+    }
+    // same SPIR-V used as two stages is two modules
+    uint64_t key = hash ^ static_cast<uint64_t>(type);
+
+    auto it = shaders.find(key);
+    if (it != shaders.end()){
+        return it->second.get();
+    }
+    Shader* shader = new Shader(_render, path, type);
+    shaders.emplace(key, std::unique_ptr<Shader>(shader));
+    return shader;
+}
+
+Mesh* GpuResourceCache::mesh(const std::string& path, uint64_t hash){
+    if (hash == 0){
+        hash = contentHashFile(path);
+    }
+
+    auto it = meshes.find(hash);
+    if (it != meshes.end()){
+        return it->second.get();
+    }
+    Mesh* mesh = new Mesh(_render, path);
+    meshes.emplace(hash, std::unique_ptr<Mesh>(mesh));
+    return mesh;
+}
+
+void* GpuResourceCache::resolve(SnapshotResourceType type, const std::string& path, uint64_t hash){
+    switch (type){
+        case SnapshotResourceType::SHADER_VERTEX:
+            return shader(path, ShaderType::VERTEX, hash);
+        case SnapshotResourceType::SHADER_FRAGMENT:
+            return shader(path, ShaderType::FRAGMENT, hash);
+        case SnapshotResourceType::SHADER_COMPUTE:
+            return shader(path, ShaderType::COMPUTE, hash);
+        case SnapshotResourceType::MESH:
+            return mesh(path, hash);
+        default:
+            return nullptr;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include "pipeline/shader.hpp"
+#include "mesh/mesh.hpp"
+#include "../../world/src/snapshot.hpp"
+
+class Render;
+
+// GPU objects keyed by content hash: every distinct file is read and uploaded once,
+// no matter how many Parts (or paths) refer to it. Used as WorldSnapshot resolver.
+class GpuResourceCache {
+private:
+    Render* _render;
+    std::unordered_map<uint64_t, std::unique_ptr<Shader>> shaders{};
+    std::unordered_map<uint64_t, std::unique_ptr<Mesh>> meshes{};
+
+public:
+    GpuResourceCache(Render* render) : _render(render) {}
+    ~GpuResourceCache();
+
+    // hash = 0: computed from file content
+    Shader* shader(const std::string& path, ShaderType type, uint64_t hash = 0);
+    Mesh* mesh(const std::string& path, uint64_t hash = 0);
+
+    // SnapshotResolver for shader and mesh resources (CUSTOM returns nullptr)
+    void* resolve(SnapshotResourceType type, const std::string& path, uint64_t hash);
+    SnapshotResolver resolver() { return [this](SnapshotResourceType type, const std::string& path, uint64_t hash){ return resolve(type, path, hash); }; }
+
+    size_t size() const { return shaders.size() + meshes.size(); }
+};
@@ -0,0 +1,151 @@
+#include "render.hpp"
+#include <iostream>
+#include <stdexcept>
+
+void Render::createSceneTarget(){
+    std::cout << "Creating Scene Target" << std::endl;
+
+    // Allocated once at full swapchain extent, lower scales render into top left corner of it
+    VkImageCreateInfo imageCreateInfo{};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = format.format;
+    imageCreateInfo.extent = {extent.width, extent.height, 1};
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageCreateInfo, nullptr, &sceneImage) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scene image");
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(device, sceneImage, &memoryRequirements);
+
+    VkMemoryAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.allocationSize = memoryRequirements.size;
+    allocateInfo.memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (vkAllocateMemory(device, &allocateInfo, nullptr, &sceneMemory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate scene image memory");
+    }
+    vkBindImageMemory(device, sceneImage, sceneMemory, 0);
+
+    VkImageViewCreateInfo viewCreateInfo{};
+    viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewCreateInfo.image = sceneImage;
+    viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewCreateInfo.format = format.format;
+    viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewCreateInfo.subresourceRange.levelCount = 1;
+    viewCreateInfo.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(device, &viewCreateInfo, nullptr, &sceneImageView) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scene image view");
+    }
+
+    VkFramebufferCreateInfo framebufferCreateInfo{};
+    framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferCreateInfo.renderPass = renderpass;
+    framebufferCreateInfo.attachmentCount = 1;
+    framebufferCreateInfo.pAttachments = &sceneImageView;
+    framebufferCreateInfo.width = extent.width;
+    framebufferCreateInfo.height = extent.height;
+    framebufferCreateInfo.layers = 1;
+    if (vkCreateFramebuffer(device, &framebufferCreateInfo, nullptr, &sceneFramebuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scene framebuffer");
+    }
+
+    // Linear upscale needs filterable format, nearest always works
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format.format, &formatProperties);
+    upscaleFilter = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+        ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+
+    sceneScales.assign(MAX_FRAMES_IN_FLIGHT, resolutionScaler.scale());
+    updateRenderResolution(-1.0);
+
+    std::cout << "\tScene target: " << extent.width << "x" << extent.height
+              << ", upscale filter: " << (upscaleFilter == VK_FILTER_LINEAR ? "linear" : "nearest") << std::endl;
+    std::cout << "Scene Target created successfully" << std::endl << std::endl;
+}
+
+void Render::destroySceneTarget(){
+    if (sceneFramebuffer != VK_NULL_HANDLE) {
+        vkDestroyFramebuffer(device, sceneFramebuffer, nullptr);
+        sceneFramebuffer = VK_NULL_HANDLE;
+    }
+    if (sceneImageView != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, sceneImageView, nullptr);
+        sceneImageView = VK_NULL_HANDLE;
+    }
+    if (sceneImage != VK_NULL_HANDLE) {
+        vkDestroyImage(device, sceneImage, nullptr);
+        sceneImage = VK_NULL_HANDLE;
+    }
+    if (sceneMemory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, sceneMemory, nullptr);
+        sceneMemory = VK_NULL_HANDLE;
+    }
+}
+
+void Render::updateRenderResolution(double gpuTime){
+    if (gpuTime >= 0.0 && !sceneScales.empty()) {
+        // frame that used this slot was rendered at its own scale
+        double budget = framePacer.targetFrameInterval() > 0.0 ? framePacer.targetFrameInterval() : gpuFrameBudget;
+        resolutionScaler.update(gpuTime, sceneScales[currentFrame], budget);
+    }
+
+    float scale = resolutionScaler.scale();
+    if (!sceneScales.empty()) {
+        sceneScales[currentFrame] = scale;
+    }
+
+    // Only dynamic state changes, target and pipelines stay as they are
+    scaledExtent(extent.width, extent.height, scale, renderExtent.width, renderExtent.height);
+    viewport.width = static_cast<float>(renderExtent.width);
+    viewport.height = static_cast<float>(renderExtent.height);
+    scissor.extent = renderExtent;
+}
+
+void Render::recordUpscale(VkCommandBuffer commandBuffer, uint32_t imageIndex){
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.levelCount = 1;
+    range.layerCount = 1;
+
+    // Scene image is already TRANSFER_SRC_OPTIMAL (render pass final layout + external dependency)
+    VkImageMemoryBarrier toTransfer{};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = 0;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = swapchainImages[imageIndex];
+    toTransfer.subresourceRange = range;
+    stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+    VkImageBlit blit{};
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.layerCount = 1;
+    blit.srcOffsets[1] = {static_cast<int32_t>(renderExtent.width), static_cast<int32_t>(renderExtent.height), 1};
+    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.dstSubresource.layerCount = 1;
+    blit.dstOffsets[1] = {static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1};
+    vkCmdBlitImage(commandBuffer, sceneImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   swapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, upscaleFilter);
+
+    VkImageMemoryBarrier toPresent = toTransfer;
+    toPresent.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toPresent.dstAccessMask = 0;
+    toPresent.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                          0, 0, nullptr, 0, nullptr, 1, &toPresent);
+}
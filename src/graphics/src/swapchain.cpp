@@ -42,7 +42,7 @@ void Render::createSwapchain(){
     std::cout << "\tFormat selected" << std::endl;
 
     // Choosing present Mode
-    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR; // fallback
+    presentMode = VK_PRESENT_MODE_FIFO_KHR; // fallback
     for (int i = 0; i < presentModesCount; i++){
         VkPresentModeKHR currentPresentMode = presentModes[i];
         if (currentPresentMode == VK_PRESENT_MODE_MAILBOX_KHR){ // MAILBOX is better then FIFO (doesnt metter render if queue is full)
@@ -57,7 +57,11 @@ void Render::createSwapchain(){
     std::cout << "\tMax image count: " << capatibilities.maxImageCount << std::endl;
 
     std::cout << "\tSupported usage flags: " << capatibilities.supportedUsageFlags << std::endl;
-    std::cout << "\tOur usage flags: " << VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT << std::endl;
+    std::cout << "\tOur usage flags: " << (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT) << std::endl;
+
+    if (!(capatibilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)){
+        throw std::runtime_error("Swapchain images can not be blit destination");
+    }
 
     // Creating Swapchain
     // Queues indices Array
@@ -74,7 +78,7 @@ void Render::createSwapchain(){
     swapchainCreateInfo.imageFormat = format.format;                         // format
     swapchainCreateInfo.imageColorSpace = format.colorSpace;                 // color space (sRGB, RGB...)
     swapchainCreateInfo.imageArrayLayers = 1;                                // array layers
-    swapchainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;    // image usage
+    swapchainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT; // image usage (upscale blit target)
     
     if (queuesAreDifferent) {
         swapchainCreateInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;   // concurrent for different queue
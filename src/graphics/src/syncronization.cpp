@@ -1,5 +1,7 @@
 #include "render.hpp"
+#include "texture/texturestreamer.hpp"
 #include <iostream>
+#include <stdexcept>
 
 void Render::sync(){
     std::cout << "Creating syncronization objects" << std::endl;
@@ -7,7 +9,9 @@ void Render::sync(){
     inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
 
     imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+    // per swapchain image: present may still wait on one after its frame slot's fence signaled
+    // (with 1 frame in flight every frame would reuse it), but not once the image is acquired again
+    renderFinishedSemaphores.resize(swapchainImages.size());
 
     // creating fences
     VkFenceCreateInfo fenceCreateInfo{};
@@ -30,6 +34,8 @@ void Render::sync(){
         if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create semaphores");
         }
+    }
+    for (size_t i = 0; i < renderFinishedSemaphores.size(); ++i) {
         if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create semaphores");
         }
@@ -38,4 +44,85 @@ void Render::sync(){
     std::cout << "\tSemaphores created successfully" << std::endl;
 
     std::cout << "Syncronization objects created successfully" << std::endl << std::endl;
+}
+
+// Present wait (VK_KHR_present_id + VK_KHR_present_wait) when device has it, CPU estimate otherwise
+void Render::createLatencyTracking(){
+    if (!measureLatency) {
+        return;
+    }
+    latencyTracker = new LatencyTracker(this);
+}
+
+void Render::createFramePacing(){
+    std::cout << "Creating frame pacing" << std::endl;
+
+    // FIFO presents once per refresh, pacer aims for that interval; MAILBOX is not capped
+    double targetInterval = 0.0;
+    if (presentMode == VK_PRESENT_MODE_FIFO_KHR || presentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR) {
+        const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        if (mode != nullptr && mode->refreshRate > 0) {
+            targetInterval = 1.0 / mode->refreshRate;
+        }
+    }
+    framePacer.setTargetInterval(targetInterval);
+    if (latencyTracker && targetInterval > 0.0) {
+        latencyTracker->setDisplayInterval(targetInterval);
+    }
+    std::cout << "\tTarget interval: " << targetInterval * 1e3 << " ms" << std::endl;
+
+    timestampsWritten.assign(MAX_FRAMES_IN_FLIGHT, false);
+
+    if (capabilities.timestampValidBits == 0 || capabilities.timestampPeriod <= 0.0f) {
+        std::cout << "\tGPU timestamps not supported, GPU time is estimated from fence waits" << std::endl;
+        std::cout << "Frame pacing created successfully" << std::endl << std::endl;
+        return;
+    }
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo{};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolCreateInfo.queryCount = MAX_FRAMES_IN_FLIGHT * 2;
+
+    if (vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &timestampQueryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool");
+    }
+
+    std::cout << "Frame pacing created successfully" << std::endl << std::endl;
+}
+
+bool Render::readGpuTimes(uint32_t frame, double& gpuTime, double& gpuIdle){
+    gpuTime = -1.0;
+    gpuIdle = -1.0;
+    if (timestampQueryPool == VK_NULL_HANDLE || !timestampsWritten[frame]) {
+        return false;
+    }
+
+    // fence of slot is signaled, results are available without waiting
+    uint64_t timestamps[2];
+    if (vkGetQueryPoolResults(device, timestampQueryPool, frame * 2, 2, sizeof(timestamps), timestamps,
+                              sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return false;
+    }
+
+    uint64_t mask = capabilities.timestampValidBits >= 64 ? UINT64_MAX : (uint64_t(1) << capabilities.timestampValidBits) - 1;
+    uint64_t begin = timestamps[0] & mask;
+    uint64_t end = timestamps[1] & mask;
+    double period = capabilities.timestampPeriod * 1e-9;
+
+    gpuTime = ((end - begin) & mask) * period;
+    // slots retire in submission order, so previous end belongs to previous frame
+    if (lastGpuEnd != 0) {
+        gpuIdle = begin > lastGpuEnd ? ((begin - lastGpuEnd) & mask) * period : 0.0;
+    }
+    lastGpuEnd = end;
+    return true;
+}
+
+void Render::createAsyncCompute(){
+    asyncCompute = new AsyncCompute(this);
+}
+
+void Render::createTextureStreaming(){
+    textureStreamer = new TextureStreamer(this);
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "ktx2.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+static const uint8_t KTX2_IDENTIFIER[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+struct Ktx2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    // index
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+
+static_assert(sizeof(Ktx2Header) == 80, "KTX2 header layout");
+
+Ktx2File::Ktx2File(std::string path){
+    if (path.substr(path.find_last_of(".") + 1) == "ktx2"){
+        this->path = path;
+    } else {
+        throw std::runtime_error("File is not a KTX2 file");
+    }
+
+    std::ifstream file{path, std::ios::binary};
+    if (!file){
+        throw std::runtime_error("File not found");
+    }
+
+    Ktx2Header header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0){
+        throw std::runtime_error("Invalid KTX2 identifier: " + path);
+    }
+
+    format = static_cast<VkFormat>(header.vkFormat);
+    if (!isBlockCompressed(format)){
+        throw std::runtime_error("KTX2 texture is not BC compressed: " + path);
+    }
+    if (header.supercompressionScheme != 0){
+        throw std::runtime_error("KTX2 supercompression is not supported: " + path);
+    }
+    if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1){
+        throw std::runtime_error("Only 2D KTX2 textures are supported: " + path);
+    }
+
+    width = header.pixelWidth;
+    height = header.pixelHeight;
+    levelCount = std::max(header.levelCount, 1u);
+
+    levels.resize(levelCount);
+    file.read(reinterpret_cast<char*>(levels.data()), sizeof(Ktx2Level) * levelCount);
+    if (!file){
+        throw std::runtime_error("KTX2 level index is truncated: " + path);
+    }
+}
+
+uint32_t Ktx2File::levelWidth(uint32_t level) const {
+    return std::max(width >> level, 1u);
+}
+
+uint32_t Ktx2File::levelHeight(uint32_t level) const {
+    return std::max(height >> level, 1u);
+}
+
+void Ktx2File::readLevel(uint32_t level, std::vector<char>& dst) const {
+    const Ktx2Level& entry = levels[level];
+
+    std::ifstream file{path, std::ios::binary};
+    if (!file){
+        throw std::runtime_error("File not found");
+    }
+    dst.resize(entry.byteLength);
+    file.seekg(static_cast<std::streamoff>(entry.byteOffset));
+    file.read(dst.data(), static_cast<std::streamsize>(entry.byteLength));
+    if (!file){
+        throw std::runtime_error("Failed to read KTX2 level " + std::to_string(level) + ": " + path);
+    }
+}
+
+bool Ktx2File::isBlockCompressed(VkFormat format){
+    return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK;
+}
+
+uint32_t Ktx2File::blockSize(VkFormat format){
+    switch (format){
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            return 8;
+        default:
+            return 16;
+    }
+}
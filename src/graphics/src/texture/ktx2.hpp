@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// KTX2 container reader. Only level index is read on load,
+// mip level data is read from file on demand by TextureStreamer.
+
+struct Ktx2Level {
+    uint64_t byteOffset;            // offset of level data in file
+    uint64_t byteLength;            // size of level data
+    uint64_t uncompressedByteLength;
+};
+
+class Ktx2File {
+private:
+    std::string path;
+
+public:
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+    std::vector<Ktx2Level> levels{}; // levels[0] is the most detailed mip
+
+    Ktx2File() = default;
+    Ktx2File(std::string path);
+
+    uint32_t levelWidth(uint32_t level) const;
+    uint32_t levelHeight(uint32_t level) const;
+
+    // Reads level data into dst (resized to level size)
+    void readLevel(uint32_t level, std::vector<char>& dst) const;
+
+    static bool isBlockCompressed(VkFormat format);
+    static uint32_t blockSize(VkFormat format); // bytes per 4x4 block
+};
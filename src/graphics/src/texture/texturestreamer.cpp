@@ -0,0 +1,438 @@
+#include "texturestreamer.hpp"
+#include "../render.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "../../../memory/src/allocationtracker.hpp"
+
+// mips up to this size (longest edge) are always resident
+#define TEXTURE_TAIL_SIZE 64
+
+// maximum mips streamed in per frame
+#define TEXTURE_UPLOADS_PER_FRAME 8
+
+static void imageBarrier(RenderStats& stats, VkCommandBuffer commandBuffer, VkImage image, uint32_t levelCount,
+                         VkImageLayout oldLayout, VkImageLayout newLayout,
+                         VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                         VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage){
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = levelCount;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+
+    stats.pipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+TextureStreamer::TextureStreamer(Render* render, VkDeviceSize budgetBytes, VkDeviceSize stagingBytes){
+    _render = render;
+    budget = budgetBytes;
+    stagingSize = stagingBytes;
+
+    // Upload command buffer (own pool, so it can be reset independently of frame command buffers)
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = render->graphicsQueueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    if (vkCreateCommandPool(render->device, &poolInfo, nullptr, &uploadPool) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create texture upload command pool");
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = uploadPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(render->device, &allocInfo, &uploadCommandBuffer) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate texture upload command buffer");
+    }
+
+    VkFenceCreateInfo fenceCreateInfo{};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    if (vkCreateFence(render->device, &fenceCreateInfo, nullptr, &uploadFence) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create texture upload fence");
+    }
+
+    // Persistently mapped staging buffer
+    render->createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                         &stagingBuffer, &stagingMemory);
+    void* mapped;
+    vkMapMemory(render->device, stagingMemory, 0, stagingSize, 0, &mapped);
+    stagingMapped = static_cast<char*>(mapped);
+}
+
+TextureStreamer::~TextureStreamer(){
+    VkDevice device = _render->device;
+    vkWaitForFences(device, 1, &uploadFence, VK_TRUE, UINT64_MAX);
+
+    // frames in flight may still sample them
+    for (auto& texture : textures){
+        _render->deletionQueue.destroy(texture.view);
+        _render->deletionQueue.destroy(texture.image);
+        _render->deletionQueue.destroy(texture.memory);
+    }
+    textures.clear();
+
+    vkUnmapMemory(device, stagingMemory);
+    vkDestroyBuffer(device, stagingBuffer, nullptr);
+    vkFreeMemory(device, stagingMemory, nullptr);
+
+    vkDestroyFence(device, uploadFence, nullptr);
+    vkDestroyCommandPool(device, uploadPool, nullptr);
+}
+
+void TextureStreamer::createImage(StreamedTexture& texture, uint32_t baseLevel, VkImage* image, VkDeviceMemory* memory, VkImageView* view, VkDeviceSize* size){
+    VkDevice device = _render->device;
+    uint32_t mipLevels = texture.file.levelCount - baseLevel;
+
+    VkImageCreateInfo imageCreateInfo{};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = texture.file.format;
+    imageCreateInfo.extent = {texture.file.levelWidth(baseLevel), texture.file.levelHeight(baseLevel), 1};
+    imageCreateInfo.mipLevels = mipLevels;                     // only resident mips
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageCreateInfo, nullptr, image) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create texture image");
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(device, *image, &memoryRequirements);
+
+    VkMemoryAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.allocationSize = memoryRequirements.size;
+    allocateInfo.memoryTypeIndex = _render->findMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    if (vkAllocateMemory(device, &allocateInfo, nullptr, memory) != VK_SUCCESS){
+        vkDestroyImage(device, *image, nullptr);
+        throw std::runtime_error("Failed to allocate texture memory");
+    }
+    vkBindImageMemory(device, *image, *memory, 0);
+    *size = memoryRequirements.size;
+
+    VkImageViewCreateInfo viewCreateInfo{};
+    viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewCreateInfo.image = *image;
+    viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewCreateInfo.format = texture.file.format;
+    viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewCreateInfo.subresourceRange.baseMipLevel = 0;
+    viewCreateInfo.subresourceRange.levelCount = mipLevels;
+    viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+    viewCreateInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewCreateInfo, nullptr, view) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create texture image view");
+    }
+}
+
+bool TextureStreamer::stageLevel(const StreamedTexture& texture, uint32_t level, VkDeviceSize* offset){
+    VkDeviceSize size = texture.file.levels[level].byteLength;
+    VkDeviceSize alignedOffset = (stagingUsed + 15) & ~VkDeviceSize(15); // block size alignment
+
+    if (alignedOffset + size > stagingSize){
+        return false;
+    }
+
+    texture.file.readLevel(level, levelData);
+    memcpy(stagingMapped + alignedOffset, levelData.data(), static_cast<size_t>(size));
+    _render->stats.uploaded(size);
+
+    *offset = alignedOffset;
+    stagingUsed = alignedOffset + size;
+    return true;
+}
+
+// Replaces texture image by one holding mips [level, levelCount), keeps already resident mips by GPU copy
+bool TextureStreamer::setResidentLevel(StreamedTexture& texture, uint32_t level, VkCommandBuffer commandBuffer){
+    uint32_t oldLevel = texture.residentLevel;
+    uint32_t levelCount = texture.file.levelCount;
+
+    // Stage new mips first, so nothing is recorded if staging buffer is full
+    std::vector<std::pair<uint32_t, VkDeviceSize>> uploads{};
+    for (uint32_t l = level; l < oldLevel; l++){
+        VkDeviceSize offset;
+        if (!stageLevel(texture, l, &offset)){
+            return false;
+        }
+        uploads.push_back({l, offset});
+    }
+
+    VkImage image;
+    VkDeviceMemory memory;
+    VkImageView view;
+    VkDeviceSize size;
+    createImage(texture, level, &image, &memory, &view, &size);
+
+    imageBarrier(_render->stats, commandBuffer, image, levelCount - level,
+                 VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    imageBarrier(_render->stats, commandBuffer, texture.image, levelCount - oldLevel,
+                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                 VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    // Copy mips that are resident in both images
+    std::vector<VkImageCopy> copies{};
+    for (uint32_t l = std::max(level, oldLevel); l < levelCount; l++){
+        VkImageCopy copy{};
+        copy.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, l - oldLevel, 0, 1};
+        copy.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, l - level, 0, 1};
+        copy.extent = {texture.file.levelWidth(l), texture.file.levelHeight(l), 1};
+        copies.push_back(copy);
+    }
+    vkCmdCopyImage(commandBuffer, texture.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   static_cast<uint32_t>(copies.size()), copies.data());
+
+    // Upload streamed in mips
+    for (auto& [l, offset] : uploads){
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, l - level, 0, 1};
+        region.imageExtent = {texture.file.levelWidth(l), texture.file.levelHeight(l), 1};
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    }
+
+    imageBarrier(_render->stats, commandBuffer, image, levelCount - level,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    // Old image can still be sampled by frames in flight
+    _render->deletionQueue.destroy(texture.view);
+    _render->deletionQueue.destroy(texture.image);
+    _render->deletionQueue.destroy(texture.memory);
+
+    texture.image = image;
+    texture.memory = memory;
+    texture.view = view;
+    texture.residentLevel = level;
+    texture.residentBytes = size;
+    texture.version++;
+    return true;
+}
+
+TextureId TextureStreamer::load(std::string path){
+    StreamedTexture texture{};
+    texture.file = Ktx2File(path);
+
+    // Mip tail: first level that fits TEXTURE_TAIL_SIZE
+    uint32_t tail = texture.file.levelCount - 1;
+    for (uint32_t l = 0; l < texture.file.levelCount; l++){
+        if (std::max(texture.file.levelWidth(l), texture.file.levelHeight(l)) <= TEXTURE_TAIL_SIZE){
+            tail = l;
+            break;
+        }
+    }
+    texture.tailLevel = tail;
+    texture.residentLevel = tail;
+    texture.requestedLevel = tail;
+    texture.lastUsedFrame = frame;
+
+    createImage(texture, tail, &texture.image, &texture.memory, &texture.view, &texture.residentBytes);
+
+    // Upload mip tail synchronously
+    vkWaitForFences(_render->device, 1, &uploadFence, VK_TRUE, UINT64_MAX);
+    stagingUsed = 0;
+
+    VkCommandBuffer commandBuffer = _render->beginSingleTimeCommands();
+    imageBarrier(_render->stats, commandBuffer, texture.image, texture.file.levelCount - tail,
+                 VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    for (uint32_t l = tail; l < texture.file.levelCount; l++){
+        VkDeviceSize offset;
+        if (!stageLevel(texture, l, &offset)){
+            throw std::runtime_error("Texture mip tail does not fit staging buffer: " + path);
+        }
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, l - tail, 0, 1};
+        region.imageExtent = {texture.file.levelWidth(l), texture.file.levelHeight(l), 1};
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    }
+    imageBarrier(_render->stats, commandBuffer, texture.image, texture.file.levelCount - tail,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    _render->endSingleTimeCommands(commandBuffer);
+    stagingUsed = 0;
+
+    textures.push_back(std::move(texture));
+    return static_cast<TextureId>(textures.size() - 1);
+}
+
+void TextureStreamer::request(TextureId id, float screenPixels){
+    StreamedTexture& texture = textures[id];
+    texture.lastUsedFrame = frame;
+
+    // One texel per pixel: level = log2(textureSize / screenSize)
+    float textureSize = static_cast<float>(std::max(texture.file.width, texture.file.height));
+    float level = screenPixels > 0.0f ? std::log2(textureSize / screenPixels) : static_cast<float>(texture.tailLevel);
+    uint32_t wanted = static_cast<uint32_t>(std::clamp(std::floor(level), 0.0f, static_cast<float>(texture.tailLevel)));
+
+    texture.requestedLevel = std::min(texture.requestedLevel, wanted);
+}
+
+void TextureStreamer::queryMemoryBudget(VkDeviceSize& heapUsage, VkDeviceSize& heapBudget){
+    heapUsage = 0;
+    heapBudget = 0;
+    if (!_render->capabilities.memoryBudget){
+        return;
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+    memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memoryProperties.pNext = &budgetProperties;
+    vkGetPhysicalDeviceMemoryProperties2(_render->physicalDevice, &memoryProperties);
+
+    for (uint32_t i = 0; i < memoryProperties.memoryProperties.memoryHeapCount; i++){
+        if (memoryProperties.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT){
+            heapUsage += budgetProperties.heapUsage[i];
+            heapBudget += budgetProperties.heapBudget[i];
+        }
+    }
+}
+
+void TextureStreamer::update(){
+    // mip uploads read files and recreate images, not part of steady state budget
+    MemoryTagScope tag{MemoryTag::TEXTURE};
+    AllowAllocationsScope allow{};
+    TextureStreamingStats stats{};
+    stats.frame = frame;
+    stats.textureCount = static_cast<uint32_t>(textures.size());
+
+    // Previous upload is still running, try next frame
+    bool uploadIdle = vkGetFenceStatus(_render->device, uploadFence) == VK_SUCCESS;
+
+    // Effective budget: user budget, limited by what the driver reports as available
+    queryMemoryBudget(stats.heapUsage, stats.heapBudget);
+
+    VkDeviceSize residentBytes = 0;
+    for (auto& texture : textures){
+        residentBytes += texture.residentBytes;
+    }
+
+    VkDeviceSize effectiveBudget = budget;
+    if (stats.heapBudget > 0){
+        VkDeviceSize available = stats.heapBudget > stats.heapUsage ? stats.heapBudget - stats.heapUsage : 0;
+        available -= available / 10; // keep 10% headroom for other allocations
+        effectiveBudget = std::min(budget, residentBytes + available);
+    }
+
+    if (uploadIdle){
+        vkResetCommandBuffer(uploadCommandBuffer, 0);
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(uploadCommandBuffer, &beginInfo);
+        stagingUsed = 0;
+
+        // Least recently used first
+        std::pmr::vector<TextureId> lru(textures.size(), _render->frameAllocator.resource());
+        for (TextureId i = 0; i < lru.size(); i++){
+            lru[i] = i;
+        }
+        std::sort(lru.begin(), lru.end(), [&](TextureId a, TextureId b){
+            return textures[a].lastUsedFrame < textures[b].lastUsedFrame;
+        });
+
+        auto evictOne = [&](uint64_t olderThan) -> bool {
+            for (TextureId id : lru){
+                StreamedTexture& texture = textures[id];
+                if (texture.lastUsedFrame >= olderThan || texture.residentLevel >= texture.tailLevel){
+                    continue;
+                }
+                VkDeviceSize before = texture.residentBytes;
+                if (setResidentLevel(texture, texture.residentLevel + 1, uploadCommandBuffer)){
+                    residentBytes = residentBytes - before + texture.residentBytes;
+                    stats.levelsEvicted++;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        // Over budget: drop most detailed mips of least recently used textures
+        while (residentBytes > effectiveBudget && evictOne(frame + 1)){}
+
+        // Stream in one level per texture per frame (progressive), most recently used first
+        uint32_t uploads = 0;
+        for (auto it = lru.rbegin(); it != lru.rend() && uploads < TEXTURE_UPLOADS_PER_FRAME; ++it){
+            StreamedTexture& texture = textures[*it];
+            if (texture.requestedLevel >= texture.residentLevel){
+                continue;
+            }
+
+            uint32_t level = texture.residentLevel - 1;
+            VkDeviceSize estimate = texture.file.levels[level].byteLength;
+
+            // Make room by evicting textures not used this frame
+            while (residentBytes + estimate > effectiveBudget && evictOne(frame)){}
+            if (residentBytes + estimate > effectiveBudget){
+                break;
+            }
+
+            VkDeviceSize before = texture.residentBytes;
+            if (!setResidentLevel(texture, level, uploadCommandBuffer)){
+                break; // staging buffer is full
+            }
+            residentBytes = residentBytes - before + texture.residentBytes;
+            stats.levelsUploaded++;
+            uploads++;
+        }
+
+        vkEndCommandBuffer(uploadCommandBuffer);
+
+        if (stats.levelsUploaded > 0 || stats.levelsEvicted > 0){
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &uploadCommandBuffer;
+
+            vkResetFences(_render->device, 1, &uploadFence);
+            if (vkQueueSubmit(_render->graphicsQueue, 1, &submitInfo, uploadFence) != VK_SUCCESS){
+                throw std::runtime_error("Failed to submit texture upload");
+            }
+        }
+    }
+
+    // Statistics
+    for (auto& texture : textures){
+        if (texture.residentLevel <= texture.requestedLevel){
+            stats.fullyResident++;
+        } else {
+            stats.pendingLevels += texture.residentLevel - texture.requestedLevel;
+        }
+        // demand must be requested again next frame
+        texture.requestedLevel = texture.tailLevel;
+    }
+    stats.residentBytes = residentBytes;
+    stats.budgetBytes = effectiveBudget;
+    currentStats = stats;
+    frame++;
+}
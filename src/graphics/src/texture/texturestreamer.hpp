@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "ktx2.hpp"
+
+// forward declaration
+class Render;
+
+using TextureId = uint32_t;
+
+struct StreamedTexture {
+    Ktx2File file;
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    uint32_t residentLevel = 0;    // most detailed mip on GPU (file level index)
+    uint32_t tailLevel = 0;        // mips from tailLevel are always resident
+    uint32_t requestedLevel = 0;   // most detailed mip wanted this frame
+    uint64_t lastUsedFrame = 0;    // for LRU eviction
+    VkDeviceSize residentBytes = 0;
+    uint32_t version = 0;          // incremented when image / view is replaced, see TextureStreamer
+};
+
+struct TextureStreamingStats {
+    uint64_t frame = 0;
+    uint32_t textureCount = 0;
+    uint32_t fullyResident = 0;      // textures that have all requested mips
+    uint32_t pendingLevels = 0;      // requested mips not resident yet
+    uint32_t levelsUploaded = 0;     // this frame
+    uint32_t levelsEvicted = 0;      // this frame
+    VkDeviceSize residentBytes = 0;  // texture memory
+    VkDeviceSize budgetBytes = 0;    // effective budget for textures this frame
+    VkDeviceSize heapUsage = 0;      // device local heap usage (VK_EXT_memory_budget)
+    VkDeviceSize heapBudget = 0;     // device local heap budget (VK_EXT_memory_budget)
+};
+
+// Streaming a texture in or out replaces its image and view, the old ones are retired through the deletion queue.
+// Streamer does not know which descriptor sets sample a texture: owners compare version with the one they wrote
+// and rewrite the set of the frame being recorded. Stats of the latest update() are reported through RenderStats.
+class TextureStreamer {
+private:
+    Render* _render;
+    std::vector<StreamedTexture> textures{};
+
+    VkCommandPool uploadPool = VK_NULL_HANDLE;
+    VkCommandBuffer uploadCommandBuffer = VK_NULL_HANDLE;
+    VkFence uploadFence = VK_NULL_HANDLE;
+
+    VkBuffer stagingBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+    char* stagingMapped = nullptr;
+    VkDeviceSize stagingSize = 0;
+    VkDeviceSize stagingUsed = 0;
+    std::vector<char> levelData{};
+
+    VkDeviceSize budget = 0;
+    uint64_t frame = 0;
+    TextureStreamingStats currentStats{};
+
+    void queryMemoryBudget(VkDeviceSize& heapUsage, VkDeviceSize& heapBudget);
+    void createImage(StreamedTexture& texture, uint32_t baseLevel, VkImage* image, VkDeviceMemory* memory, VkImageView* view, VkDeviceSize* size);
+    bool setResidentLevel(StreamedTexture& texture, uint32_t level, VkCommandBuffer commandBuffer);
+    bool stageLevel(const StreamedTexture& texture, uint32_t level, VkDeviceSize* offset);
+
+public:
+    TextureStreamer(Render* render, VkDeviceSize budgetBytes = 256ull << 20, VkDeviceSize stagingBytes = 16ull << 20);
+    ~TextureStreamer();
+
+    // Loads level index and the mip tail, other mips are streamed on demand
+    TextureId load(std::string path);
+
+    // Screen space demand: size in pixels of the longest texture edge on screen
+    void request(TextureId id, float screenPixels);
+
+    // Evicts / streams mips, call once per frame before recording
+    void update();
+
+    const StreamedTexture& texture(TextureId id) const { return textures[id]; }
+    const TextureStreamingStats& stats() const { return currentStats; }
+    void setBudget(VkDeviceSize budgetBytes) { budget = budgetBytes; }
+};
@@ -0,0 +1,185 @@
+#include "inputBehaviour.hpp"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include "../memory/src/allocationtracker.hpp"
+
+uint64_t InputBehaviour::now(){
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void InputBehaviour::init(){
+    glfwSetWindowUserPointer(window, this);
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    glfwSetCursorPosCallback(window, cursorCallback);
+    glfwSetScrollCallback(window, scrollCallback);
+
+    double x, y;
+    glfwGetCursorPos(window, &x, &y);
+    history[published].cursorX = x;
+    history[published].cursorY = y;
+    history[published].timestamp = now();
+
+    std::cout << "Input callbacks installed" << std::endl;
+}
+
+void InputBehaviour::push(const InputEvent& event){
+    if (!ring.push(event)){
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void InputBehaviour::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods){
+    auto* input = static_cast<InputBehaviour*>(glfwGetWindowUserPointer(window));
+    input->push({now(), InputEventType::KEY, key, action, 0.0, 0.0});
+}
+
+void InputBehaviour::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods){
+    auto* input = static_cast<InputBehaviour*>(glfwGetWindowUserPointer(window));
+    input->push({now(), InputEventType::MOUSE_BUTTON, button, action, 0.0, 0.0});
+}
+
+void InputBehaviour::cursorCallback(GLFWwindow* window, double x, double y){
+    auto* input = static_cast<InputBehaviour*>(glfwGetWindowUserPointer(window));
+    input->push({now(), InputEventType::CURSOR, 0, 0, x, y});
+}
+
+void InputBehaviour::scrollCallback(GLFWwindow* window, double x, double y){
+    auto* input = static_cast<InputBehaviour*>(glfwGetWindowUserPointer(window));
+    input->push({now(), InputEventType::SCROLL, 0, 0, x, y});
+}
+
+void InputBehaviour::drain(InputSnapshot& snapshot){
+    InputEvent event;
+    while (ring.pop(event)){
+        switch (event.type){
+            case InputEventType::KEY:
+                if (event.code < 0 || event.code >= INPUT_KEY_COUNT){
+                    break; // GLFW_KEY_UNKNOWN
+                }
+                if (event.action == GLFW_PRESS){
+                    snapshot.keys.set(event.code);
+                    snapshot.keysPressed.set(event.code);
+                } else if (event.action == GLFW_RELEASE){
+                    snapshot.keys.reset(event.code);
+                    snapshot.keysReleased.set(event.code);
+                }
+                break;
+            case InputEventType::MOUSE_BUTTON:
+                if (event.code < 0 || event.code >= INPUT_BUTTON_COUNT){
+                    break;
+                }
+                if (event.action == GLFW_PRESS){
+                    snapshot.buttons.set(event.code);
+                    snapshot.buttonsPressed.set(event.code);
+                } else if (event.action == GLFW_RELEASE){
+                    snapshot.buttons.reset(event.code);
+                    snapshot.buttonsReleased.set(event.code);
+                }
+                break;
+            case InputEventType::CURSOR:
+                snapshot.cursorDeltaX += event.x - snapshot.cursorX;
+                snapshot.cursorDeltaY += event.y - snapshot.cursorY;
+                snapshot.cursorX = event.x;
+                snapshot.cursorY = event.y;
+                break;
+            case InputEventType::SCROLL:
+                snapshot.scrollX += event.x;
+                snapshot.scrollY += event.y;
+                break;
+        }
+        snapshot.lastEventTimestamp = event.timestamp;
+        snapshot.eventCount++;
+    }
+    snapshot.timestamp = now();
+}
+
+static_assert(std::is_trivially_copyable_v<InputSnapshot>, "InputSnapshot is published as raw words");
+
+void InputBehaviour::publish(const InputSnapshot& snapshot){
+    // seqlock write: odd sequence while copying
+    uint32_t s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    uint64_t words[INPUT_SNAPSHOT_WORDS]{};
+    std::memcpy(words, &snapshot, sizeof(InputSnapshot));
+    for (size_t i = 0; i < INPUT_SNAPSHOT_WORDS; i++){
+        shared[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence.store(s + 2, std::memory_order_release);
+}
+
+InputSnapshot InputBehaviour::latest() const {
+    uint64_t words[INPUT_SNAPSHOT_WORDS];
+    uint32_t before, after;
+    do {
+        before = sequence.load(std::memory_order_acquire);
+        for (size_t i = 0; i < INPUT_SNAPSHOT_WORDS; i++){
+            words[i] = shared[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    InputSnapshot copy;
+    std::memcpy(&copy, words, sizeof(InputSnapshot));
+    return copy;
+}
+
+void InputBehaviour::update(){
+    MemoryTagScope tag{MemoryTag::INPUT};
+    glfwPollEvents();
+
+    const InputSnapshot& previous = history[published];
+    uint32_t next = (published + 1) % INPUT_HISTORY;
+    InputSnapshot& snapshot = history[next];
+
+    // held state carries over, edges and deltas start from what sampleLate() drained
+    snapshot = InputSnapshot{};
+    snapshot.frame = ++frame;
+    snapshot.keys = previous.keys;
+    snapshot.buttons = previous.buttons;
+    snapshot.cursorX = previous.cursorX;
+    snapshot.cursorY = previous.cursorY;
+    snapshot.keysPressed = late.keysPressed;
+    snapshot.keysReleased = late.keysReleased;
+    snapshot.buttonsPressed = late.buttonsPressed;
+    snapshot.buttonsReleased = late.buttonsReleased;
+    snapshot.cursorDeltaX = late.cursorDeltaX;
+    snapshot.cursorDeltaY = late.cursorDeltaY;
+    snapshot.scrollX = late.scrollX;
+    snapshot.scrollY = late.scrollY;
+    late = InputSnapshot{};
+
+    drain(snapshot);
+    published = next;
+    publish(snapshot);
+}
+
+void InputBehaviour::sampleLate(){
+    glfwPollEvents();
+
+    // same frame, edges and deltas accumulate on top of update() snapshot
+    const InputSnapshot& previous = history[published];
+    uint32_t next = (published + 1) % INPUT_HISTORY;
+    InputSnapshot& snapshot = history[next];
+    snapshot = previous;
+
+    drain(snapshot);
+
+    // simulation already ran on previous, so only what was drained here is still unseen
+    late.keysPressed |= snapshot.keysPressed & ~previous.keysPressed;
+    late.keysReleased |= snapshot.keysReleased & ~previous.keysReleased;
+    late.buttonsPressed |= snapshot.buttonsPressed & ~previous.buttonsPressed;
+    late.buttonsReleased |= snapshot.buttonsReleased & ~previous.buttonsReleased;
+    late.cursorDeltaX += snapshot.cursorDeltaX - previous.cursorDeltaX;
+    late.cursorDeltaY += snapshot.cursorDeltaY - previous.cursorDeltaY;
+    late.scrollX += snapshot.scrollX - previous.scrollX;
+    late.scrollY += snapshot.scrollY - previous.scrollY;
+
+    published = next;
+    publish(snapshot);
+}
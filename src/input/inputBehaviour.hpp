@@ -0,0 +1,67 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <cstdint>
+#include "src/inputring.hpp"
+#include "src/inputsnapshot.hpp"
+
+#define INPUT_RING_SIZE 1024
+#define INPUT_HISTORY 4
+#define INPUT_SNAPSHOT_WORDS ((sizeof(InputSnapshot) + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+
+// GLFW events are timestamped in callbacks and pushed to a lock-free ring,
+// update() folds them into an immutable InputSnapshot once per frame
+class InputBehaviour {
+private:
+    GLFWwindow* window;
+    InputRing<InputEvent, INPUT_RING_SIZE> ring{};
+    std::atomic<uint64_t> dropped{0};
+
+    // Game thread snapshots, published one is never written until INPUT_HISTORY - 1 newer ones exist
+    InputSnapshot history[INPUT_HISTORY]{};
+    uint32_t published = 0;
+    uint64_t frame = 0;
+
+    // Edges and deltas drained by sampleLate(), no simulation step saw them yet.
+    // Next update() starts from these instead of zero.
+    InputSnapshot late{};
+
+    // Copy of newest snapshot for other threads (seqlock, writer never waits).
+    // Stored as relaxed atomic words so a reader racing the writer is not a data race.
+    std::atomic<uint64_t> shared[INPUT_SNAPSHOT_WORDS]{};
+    std::atomic<uint32_t> sequence{0};
+
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void cursorCallback(GLFWwindow* window, double x, double y);
+    static void scrollCallback(GLFWwindow* window, double x, double y);
+
+    void push(const InputEvent& event);
+    void drain(InputSnapshot& snapshot);
+    void publish(const InputSnapshot& snapshot);
+
+public:
+    InputBehaviour(GLFWwindow* window) : window(window) {}
+
+    // Installs GLFW callbacks (window user pointer is set to this)
+    void init();
+
+    // Start of frame: polls events and publishes a new snapshot (game thread)
+    void update();
+
+    // Just before recording: polls again and republishes current frame's snapshot with newest input (game thread)
+    void sampleLate();
+
+    // Snapshot for simulation, valid until next update() / sampleLate() pair (game thread)
+    const InputSnapshot& snapshot() const { return history[published]; }
+
+    // Newest snapshot from any thread
+    InputSnapshot latest() const;
+
+    uint64_t droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Steady clock in nanoseconds, shared time base for input and latency measurement
+    static uint64_t now();
+};
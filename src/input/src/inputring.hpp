@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Single producer / single consumer lock-free ring, Capacity must be power of two
+template<typename T, size_t Capacity>
+class InputRing {
+private:
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of two");
+
+    T items[Capacity];
+    alignas(64) std::atomic<size_t> head{0}; // written by producer
+    alignas(64) std::atomic<size_t> tail{0}; // written by consumer
+
+public:
+    // false when ring is full (event is dropped)
+    bool push(const T& item){
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity){
+            return false;
+        }
+        items[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item){
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)){
+            return false;
+        }
+        item = items[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+
+#define INPUT_KEY_COUNT 512
+#define INPUT_BUTTON_COUNT 8
+
+enum class InputEventType : uint8_t {
+    KEY,
+    MOUSE_BUTTON,
+    CURSOR,
+    SCROLL,
+};
+
+struct InputEvent {
+    uint64_t timestamp;   // steady clock, nanoseconds
+    InputEventType type;
+    int32_t code;         // key or mouse button
+    int32_t action;       // GLFW_PRESS, GLFW_RELEASE, GLFW_REPEAT
+    double x;             // cursor position / scroll offset
+    double y;
+};
+
+// Input state for one frame, never modified after it is published
+struct InputSnapshot {
+    uint64_t frame = 0;
+    uint64_t timestamp = 0;        // when input was sampled (steady clock, ns)
+    uint64_t lastEventTimestamp = 0;
+    uint32_t eventCount = 0;       // events folded into this snapshot
+
+    std::bitset<INPUT_KEY_COUNT> keys{};          // held
+    std::bitset<INPUT_KEY_COUNT> keysPressed{};   // went down since previous snapshot
+    std::bitset<INPUT_KEY_COUNT> keysReleased{};  // went up since previous snapshot
+    std::bitset<INPUT_BUTTON_COUNT> buttons{};
+    std::bitset<INPUT_BUTTON_COUNT> buttonsPressed{};
+    std::bitset<INPUT_BUTTON_COUNT> buttonsReleased{};
+
+    double cursorX = 0.0;
+    double cursorY = 0.0;
+    double cursorDeltaX = 0.0;
+    double cursorDeltaY = 0.0;
+    double scrollX = 0.0;
+    double scrollY = 0.0;
+
+    bool key(int code) const { return code >= 0 && code < INPUT_KEY_COUNT && keys[code]; }
+    bool pressed(int code) const { return code >= 0 && code < INPUT_KEY_COUNT && keysPressed[code]; }
+    bool released(int code) const { return code >= 0 && code < INPUT_KEY_COUNT && keysReleased[code]; }
+    bool button(int code) const { return code >= 0 && code < INPUT_BUTTON_COUNT && buttons[code]; }
+};
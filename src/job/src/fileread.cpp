@@ -0,0 +1,23 @@
+#include "fileread.hpp"
+#include <fstream>
+#include <stdexcept>
+
+std::vector<char> readFileBytes(const std::string& path){
+    if (path == ""){
+        throw std::runtime_error("Path is empty");
+    }
+    std::ifstream file{path, std::ios::ate | std::ios::binary};
+    if (!file){
+        throw std::runtime_error("File not found: " + path);
+    }
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<char> data(fileSize);
+    file.seekg(0);
+    file.read(data.data(), fileSize);
+    return data;
+}
+
+Task<std::vector<char>> readFileAsync(JobPool& jobs, std::string path){
+    co_await resumeOn(jobs);
+    co_return readFileBytes(path);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "task.hpp"
+
+// Whole file read on a JobPool worker, awaiting coroutine continues on that worker.
+// Throws std::runtime_error when file cannot be opened.
+Task<std::vector<char>> readFileAsync(JobPool& jobs, std::string path);
+
+// Same read, blocking calling thread
+std::vector<char> readFileBytes(const std::string& path);
@@ -0,0 +1,97 @@
+#include "jobpool.hpp"
+#include <memory>
+#include <algorithm>
+#include "../../memory/src/allocationtracker.hpp"
+
+JobPool::JobPool(uint32_t threadCount){
+    if (threadCount == 0){
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    for (uint32_t i = 0; i < threadCount; i++){
+        workers.emplace_back(&JobPool::workerLoop, this);
+    }
+}
+
+JobPool::~JobPool(){
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    condition.notify_all();
+
+    for (auto& worker : workers){
+        worker.join();
+    }
+}
+
+void JobPool::workerLoop(){
+    AllocationTracker::setCurrentTag(MemoryTag::JOB);
+
+    while (true){
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            condition.wait(lock, [this]{ return stopping || !jobs.empty(); });
+            if (stopping && jobs.empty()){
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void JobPool::submit(Job job){
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        jobs.push_back(std::move(job));
+    }
+    condition.notify_one();
+}
+
+void JobPool::parallelFor(uint32_t count, uint32_t batchSize, const RangeJob& body){
+    if (count == 0){
+        return;
+    }
+    batchSize = std::max(batchSize, 1u);
+    uint32_t batches = (count + batchSize - 1) / batchSize;
+
+    if (batches == 1 || workers.empty()){
+        body(0, count);
+        return;
+    }
+
+    // Shared with helper jobs, which may outlive this call by a few instructions
+    struct State {
+        std::atomic<uint32_t> next{0};
+        std::atomic<uint32_t> done{0};
+    };
+    auto state = std::make_shared<State>();
+    const RangeJob* function = &body;
+    MemoryTag tag = AllocationTracker::currentTag();
+
+    auto run = [state, function, count, batchSize, batches, tag](){
+        MemoryTagScope scope{tag};
+        uint32_t batch;
+        while ((batch = state->next.fetch_add(1)) < batches){
+            uint32_t begin = batch * batchSize;
+            (*function)(begin, std::min(begin + batchSize, count));
+            state->done.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    uint32_t helpers = std::min(batches - 1, threadCount());
+    for (uint32_t i = 0; i < helpers; i++){
+        submit(run);
+    }
+
+    run();
+
+    // body stays alive until every batch has finished
+    while (state->done.load(std::memory_order_acquire) < batches){
+        std::this_thread::yield();
+    }
+}
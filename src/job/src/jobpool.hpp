@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+using Job = std::function<void()>;
+using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+class JobPool {
+private:
+    std::vector<std::thread> workers{};
+    std::deque<Job> jobs{};
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+    // threadCount = 0: hardware threads - 1 (calling thread works too)
+    JobPool(uint32_t threadCount = 0);
+    ~JobPool();
+
+    void submit(Job job);
+
+    // Splits [0, count) into batches and runs them on workers and calling thread, returns when all are done
+    void parallelFor(uint32_t count, uint32_t batchSize, const RangeJob& body);
+
+    uint32_t threadCount() const { return static_cast<uint32_t>(workers.size()); }
+};
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include "jobpool.hpp"
+
+// C++20 coroutine tasks on top of JobPool.
+//
+//   Task<Shader> load(...){
+//       co_await resumeOn(jobs);                 // continue on a worker
+//       std::vector<char> code = co_await readFileAsync(jobs, path);
+//       co_await resumeOn(render->renderTasks);  // continue on render thread
+//       ...
+//   }
+//
+// Tasks are lazy: nothing runs until the task is awaited or spawned on a TaskScope. An awaiting
+// coroutine continues on whatever thread finished the awaited task; resumeOn() moves it.
+
+template<typename T = void>
+class Task;
+
+namespace taskdetail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr exception{};
+
+    // finished task resumes its awaiter directly (symmetric transfer, stack does not grow)
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept { return handle.promise().continuation; }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value{};
+
+    Task<T> get_return_object();
+    void return_value(T result) { value.emplace(std::move(result)); }
+
+    T take(){
+        if (exception){
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+
+    void take(){
+        if (exception){
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+// Coroutine that starts at once and frees itself when done, used to run tasks nobody awaits
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+} // namespace taskdetail
+
+template<typename T>
+class Task {
+public:
+    using promise_type = taskdetail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+private:
+    Handle handle{};
+
+public:
+    Task() = default;
+    explicit Task(Handle handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other){
+            if (handle){
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task(){
+        if (handle){
+            handle.destroy();
+        }
+    }
+
+    bool valid() const { return static_cast<bool>(handle); }
+    bool done() const { return handle && handle.done(); }
+
+    // Starts task, awaiting coroutine continues when it finishes; exceptions are rethrown there
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Handle handle;
+            bool await_ready() noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() { return handle.promise().take(); }
+        };
+        return Awaiter{handle};
+    }
+};
+
+template<typename T>
+Task<T> taskdetail::Promise<T>::get_return_object(){
+    return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+}
+
+inline Task<void> taskdetail::Promise<void>::get_return_object(){
+    return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+
+// Coroutines waiting to continue on one particular thread (render thread, main thread).
+// That thread calls drain() once per frame; budget keeps a frame from stalling when many are queued.
+class ResumeQueue {
+private:
+    std::mutex mutex;
+    std::deque<std::coroutine_handle<>> queue{};
+
+public:
+    void post(std::coroutine_handle<> handle){
+        std::lock_guard<std::mutex> lock{mutex};
+        queue.push_back(handle);
+    }
+
+    // Resumes queued coroutines on calling thread until queue is empty or budget is spent
+    uint32_t drain(double budgetSeconds = 1e9){
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start = Clock::now();
+        uint32_t resumed = 0;
+        while (true){
+            std::coroutine_handle<> handle;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (queue.empty()){
+                    break;
+                }
+                handle = queue.front();
+                queue.pop_front();
+            }
+            handle.resume();
+            resumed++;
+            if (std::chrono::duration<double>(Clock::now() - start).count() >= budgetSeconds){
+                break;
+            }
+        }
+        return resumed;
+    }
+
+    size_t size(){
+        std::lock_guard<std::mutex> lock{mutex};
+        return queue.size();
+    }
+};
+
+// co_await resumeOn(jobs): rest of coroutine runs on a JobPool worker
+inline auto resumeOn(JobPool& jobs){
+    struct Awaiter {
+        JobPool& jobs;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle){ jobs.submit([handle]{ handle.resume(); }); }
+        void await_resume() noexcept {}
+    };
+    return Awaiter{jobs};
+}
+
+// co_await resumeOn(queue): rest of coroutine runs on thread that drains queue
+inline auto resumeOn(ResumeQueue& queue){
+    struct Awaiter {
+        ResumeQueue& queue;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle){ queue.post(handle); }
+        void await_resume() noexcept {}
+    };
+    return Awaiter{queue};
+}
+
+// Runs tasks nobody awaits (loading hundreds of assets at once) and counts the ones still running.
+// Must outlive its tasks: destructor waits for them.
+class TaskScope {
+private:
+    std::mutex mutex;
+    std::condition_variable finished;
+    uint32_t running = 0;
+    uint32_t failures = 0;
+    std::exception_ptr firstError{};
+
+    static taskdetail::Detached run(TaskScope* scope, Task<void> task){
+        std::exception_ptr error{};
+        try {
+            co_await task;
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock{scope->mutex};
+        if (error){
+            scope->failures++;
+            if (!scope->firstError){
+                scope->firstError = error;
+            }
+        }
+        scope->running--;
+        // under lock: scope may be destroyed as soon as it sees running == 0
+        scope->finished.notify_all();
+    }
+
+public:
+    TaskScope() = default;
+    TaskScope(const TaskScope&) = delete;
+    TaskScope& operator=(const TaskScope&) = delete;
+    ~TaskScope() { wait(); }
+
+    // Starts task on calling thread, it runs until its first suspension before spawn returns
+    void spawn(Task<void> task){
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            running++;
+        }
+        run(this, std::move(task));
+    }
+
+    // Blocks until every task finished. Not on a thread that drains a ResumeQueue tasks wait for.
+    void wait(){
+        std::unique_lock<std::mutex> lock{mutex};
+        finished.wait(lock, [this]{ return running == 0; });
+    }
+
+    uint32_t pending(){
+        std::lock_guard<std::mutex> lock{mutex};
+        return running;
+    }
+
+    uint32_t failed(){
+        std::lock_guard<std::mutex> lock{mutex};
+        return failures;
+    }
+
+    // Rethrows first exception a task ended with, if any
+    void rethrow(){
+        std::lock_guard<std::mutex> lock{mutex};
+        if (firstError){
+            std::rethrow_exception(firstError);
+        }
+    }
+};
@@ -0,0 +1,229 @@
+#include "allocationtracker.hpp"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+
+#define TAG_COUNT static_cast<size_t>(MemoryTag::COUNT)
+
+// Counters are plain atomics with static storage, so they work before main() and
+// never allocate themselves
+struct TagCounters {
+    std::atomic<int64_t> currentBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> totalBytes{0};
+    std::atomic<uint64_t> frameAllocations{0};
+};
+
+static TagCounters counters[TAG_COUNT];
+static std::atomic<uint64_t> frameAllocations{0};
+static std::atomic<uint64_t> frameBytes{0};
+static std::atomic<uint64_t> frameAllowed{0};
+
+static thread_local MemoryTag threadTag = MemoryTag::GENERAL;
+static thread_local uint32_t threadAllowDepth = 0;
+
+static uint64_t frameIndex = 0;
+static bool steadyStateCheck = false;
+static uint32_t steadyStateWarmup = 0;
+static FrameAllocationStats previousFrame{};
+
+static const char* tagNames[TAG_COUNT] = {
+    "general", "render", "texture", "mesh", "animation", "event", "input", "job", "engine", "ecs"
+};
+
+const char* memoryTagName(MemoryTag tag){
+    size_t index = static_cast<size_t>(tag);
+    return index < TAG_COUNT ? tagNames[index] : "unknown";
+}
+
+#ifdef BOTTLE_TRACK_ALLOCATIONS
+static void recordAllocation(MemoryTag tag, size_t size){
+    TagCounters& tagCounters = counters[static_cast<size_t>(tag)];
+    int64_t current = tagCounters.currentBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+    int64_t peak = tagCounters.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !tagCounters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)){}
+    tagCounters.allocations.fetch_add(1, std::memory_order_relaxed);
+    tagCounters.totalBytes.fetch_add(size, std::memory_order_relaxed);
+    tagCounters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    frameBytes.fetch_add(size, std::memory_order_relaxed);
+    if (threadAllowDepth > 0){
+        frameAllowed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void recordFree(MemoryTag tag, size_t size){
+    counters[static_cast<size_t>(tag)].currentBytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+#endif
+
+bool AllocationTracker::enabled(){
+#ifdef BOTTLE_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+MemoryTag AllocationTracker::currentTag(){
+    return threadTag;
+}
+
+void AllocationTracker::setCurrentTag(MemoryTag tag){
+    threadTag = tag;
+}
+
+MemoryTagStats AllocationTracker::stats(MemoryTag tag){
+    const TagCounters& tagCounters = counters[static_cast<size_t>(tag)];
+    MemoryTagStats result{};
+    result.currentBytes = tagCounters.currentBytes.load(std::memory_order_relaxed);
+    result.peakBytes = tagCounters.peakBytes.load(std::memory_order_relaxed);
+    result.allocations = tagCounters.allocations.load(std::memory_order_relaxed);
+    result.totalBytes = tagCounters.totalBytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+void AllocationTracker::beginFrame(){
+    frameAllocations.store(0, std::memory_order_relaxed);
+    frameBytes.store(0, std::memory_order_relaxed);
+    frameAllowed.store(0, std::memory_order_relaxed);
+    for (auto& tagCounters : counters){
+        tagCounters.frameAllocations.store(0, std::memory_order_relaxed);
+    }
+}
+
+FrameAllocationStats AllocationTracker::endFrame(){
+    FrameAllocationStats result{};
+    result.frame = frameIndex++;
+    result.allocations = frameAllocations.load(std::memory_order_relaxed);
+    result.bytes = frameBytes.load(std::memory_order_relaxed);
+    result.allowed = frameAllowed.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < TAG_COUNT; i++){
+        result.tagAllocations[i] = counters[i].frameAllocations.load(std::memory_order_relaxed);
+    }
+    previousFrame = result;
+
+    if (enabled() && steadyStateCheck && result.frame >= steadyStateWarmup && result.allocations > result.allowed){
+        // fprintf, iostream could allocate while reporting an allocation
+        fprintf(stderr, "Steady state frame %llu allocated %llu times (%llu bytes):\n",
+                static_cast<unsigned long long>(result.frame),
+                static_cast<unsigned long long>(result.allocations - result.allowed),
+                static_cast<unsigned long long>(result.bytes));
+        for (size_t i = 0; i < TAG_COUNT; i++){
+            if (result.tagAllocations[i] > 0){
+                fprintf(stderr, "\t%s: %llu\n", tagNames[i], static_cast<unsigned long long>(result.tagAllocations[i]));
+            }
+        }
+        std::abort();
+    }
+    return result;
+}
+
+const FrameAllocationStats& AllocationTracker::lastFrame(){
+    return previousFrame;
+}
+
+void AllocationTracker::setSteadyStateCheck(bool check, uint32_t warmupFrames){
+    steadyStateCheck = check;
+    steadyStateWarmup = static_cast<uint32_t>(frameIndex) + warmupFrames;
+}
+
+void AllocationTracker::report(){
+    AllowAllocationsScope allow{};
+
+    std::cout << "Memory (" << (enabled() ? "tracked" : "tracking disabled") << "), last frame: "
+              << previousFrame.allocations << " allocations, " << previousFrame.bytes << " bytes" << std::endl;
+    for (size_t i = 0; i < TAG_COUNT; i++){
+        MemoryTagStats tagStats = stats(static_cast<MemoryTag>(i));
+        if (tagStats.allocations == 0){
+            continue;
+        }
+        std::cout << "\t" << std::left << std::setw(10) << tagNames[i] << std::right
+                  << " current: " << tagStats.currentBytes / 1024 << " KB"
+                  << ", peak: " << tagStats.peakBytes / 1024 << " KB"
+                  << ", allocations: " << tagStats.allocations << std::endl;
+    }
+}
+
+AllowAllocationsScope::AllowAllocationsScope(){
+    threadAllowDepth++;
+}
+
+AllowAllocationsScope::~AllowAllocationsScope(){
+    threadAllowDepth--;
+}
+
+#ifdef BOTTLE_TRACK_ALLOCATIONS
+
+// Every block is prefixed with a header, user pointer = base + offset
+struct alignas(16) AllocationHeader {
+    uint64_t size;
+    uint32_t offset;
+    MemoryTag tag;
+};
+
+static_assert(sizeof(AllocationHeader) == 16, "AllocationHeader must keep default new alignment");
+
+static void* trackedAllocate(size_t size, size_t alignment){
+    if (alignment < alignof(AllocationHeader)){
+        alignment = alignof(AllocationHeader);
+    }
+    size_t offset = sizeof(AllocationHeader) > alignment ? sizeof(AllocationHeader) : alignment;
+
+    void* base = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, ((offset + size + alignment - 1) / alignment) * alignment)
+                                                        : std::malloc(offset + size);
+    if (base == nullptr){
+        return nullptr;
+    }
+
+    auto* user = static_cast<uint8_t*>(base) + offset;
+    auto* header = reinterpret_cast<AllocationHeader*>(user) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32_t>(offset);
+    header->tag = threadTag;
+
+    recordAllocation(header->tag, size);
+    return user;
+}
+
+static void trackedFree(void* pointer){
+    if (pointer == nullptr){
+        return;
+    }
+    auto* header = static_cast<AllocationHeader*>(pointer) - 1;
+    recordFree(header->tag, header->size);
+    std::free(static_cast<uint8_t*>(pointer) - header->offset);
+}
+
+static void* trackedNew(size_t size, size_t alignment){
+    void* pointer = trackedAllocate(size, alignment);
+    if (pointer == nullptr){
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new(size_t size) { return trackedNew(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return trackedNew(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return trackedNew(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return trackedNew(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size, alignof(std::max_align_t)); }
+
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+
+#endif
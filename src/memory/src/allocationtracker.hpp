@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Heap instrumentation. Global operator new / delete are replaced when built with
+// BOTTLE_TRACK_ALLOCATIONS, every allocation is tagged with the calling thread's
+// current MemoryTag. Without the define all counters stay zero and scopes are free.
+
+enum class MemoryTag : uint8_t {
+    GENERAL,
+    RENDER,
+    TEXTURE,
+    MESH,
+    ANIMATION,
+    EVENT,
+    INPUT,
+    JOB,
+    ENGINE,
+    ECS,
+    COUNT
+};
+
+const char* memoryTagName(MemoryTag tag);
+
+struct MemoryTagStats {
+    int64_t currentBytes = 0;    // live bytes
+    int64_t peakBytes = 0;       // highest currentBytes seen
+    uint64_t allocations = 0;    // total allocations since start
+    uint64_t totalBytes = 0;     // total bytes allocated since start
+};
+
+struct FrameAllocationStats {
+    uint64_t frame = 0;
+    uint64_t allocations = 0;    // allocations between beginFrame and endFrame (all threads)
+    uint64_t bytes = 0;
+    uint64_t allowed = 0;        // of those, made inside AllowAllocationsScope
+    uint64_t tagAllocations[static_cast<size_t>(MemoryTag::COUNT)]{};
+};
+
+class AllocationTracker {
+public:
+    // true when global operator new is instrumented
+    static bool enabled();
+
+    static MemoryTag currentTag();
+    static void setCurrentTag(MemoryTag tag);
+
+    static MemoryTagStats stats(MemoryTag tag);
+
+    // Frame boundaries (game thread). endFrame() checks steady state when enabled.
+    static void beginFrame();
+    static FrameAllocationStats endFrame();
+    static const FrameAllocationStats& lastFrame();
+
+    // Debug mode: after warmupFrames, any frame that allocates (outside AllowAllocationsScope) aborts
+    static void setSteadyStateCheck(bool check, uint32_t warmupFrames = 60);
+
+    // Per tag current / peak table on std::cout
+    static void report();
+};
+
+// Tags allocations of this thread until scope ends
+class MemoryTagScope {
+private:
+    MemoryTag previous;
+public:
+    explicit MemoryTagScope(MemoryTag tag) : previous(AllocationTracker::currentTag()) { AllocationTracker::setCurrentTag(tag); }
+    ~MemoryTagScope() { AllocationTracker::setCurrentTag(previous); }
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+};
+
+// Allocations of this thread are still counted, but do not fail steady state check
+// (streaming, periodic reports, resize...)
+class AllowAllocationsScope {
+public:
+    AllowAllocationsScope();
+    ~AllowAllocationsScope();
+    AllowAllocationsScope(const AllowAllocationsScope&) = delete;
+    AllowAllocationsScope& operator=(const AllowAllocationsScope&) = delete;
+};
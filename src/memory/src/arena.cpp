@@ -0,0 +1,154 @@
+#include "arena.hpp"
+#include "allocationtracker.hpp"
+#include <new>
+#include <algorithm>
+
+static size_t alignUp(size_t value, size_t alignment){
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+LinearArena::~LinearArena(){
+    freeBlocks();
+}
+
+void LinearArena::addBlock(size_t capacity){
+    uint8_t* data = static_cast<uint8_t*>(::operator new(capacity, std::align_val_t{alignof(std::max_align_t)}));
+    blocks.push_back({data, capacity});
+    offset = 0;
+}
+
+void LinearArena::freeBlocks(){
+    for (auto& block : blocks){
+        ::operator delete(block.data, std::align_val_t{alignof(std::max_align_t)});
+    }
+    blocks.clear();
+}
+
+void* LinearArena::allocate(size_t size, size_t alignment){
+    if (blocks.empty()){
+        blocks.reserve(4);
+        addBlock(std::max(initialCapacity, size + alignment));
+    }
+
+    size_t start = alignUp(offset, alignment);
+    if (start + size > blocks.back().capacity){
+        // growth is a warmup cost, next reset merges blocks
+        AllowAllocationsScope allow{};
+        addBlock(std::max(blocks.back().capacity, size + alignment));
+        start = 0;
+    }
+
+    used += start - offset + size; // offset is 0 after addBlock
+    offset = start + size;
+    peak = std::max(peak, used);
+    return blocks.back().data + start;
+}
+
+void LinearArena::reset(){
+    if (blocks.size() > 1){
+        size_t merged = alignUp(peak, 4096);
+        freeBlocks();
+        AllowAllocationsScope allow{};
+        addBlock(merged);
+    }
+    offset = 0;
+    used = 0;
+}
+
+size_t LinearArena::capacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks){
+        total += block.capacity;
+    }
+    return total;
+}
+
+void* FrameArenaResource::do_allocate(size_t bytes, size_t alignment){
+    return allocator->allocate(bytes, alignment);
+}
+
+// Small dense index per thread, shared by every FrameAllocator. Indices of exited
+// threads are reused, so only more than FRAME_ALLOCATOR_THREADS live threads share.
+namespace {
+struct FrameThreadIndices {
+    std::mutex mutex;
+    std::vector<uint32_t> free{};
+    uint32_t next = 0;
+};
+
+// never destroyed, thread_local destructors may run after static destructors
+FrameThreadIndices& frameThreadIndices(){
+    static FrameThreadIndices* indices = new FrameThreadIndices();
+    return *indices;
+}
+
+struct FrameThreadIndex {
+    uint32_t index;
+
+    FrameThreadIndex(){
+        FrameThreadIndices& indices = frameThreadIndices();
+        std::lock_guard<std::mutex> lock{indices.mutex};
+        if (indices.free.empty()){
+            index = indices.next++;
+        } else {
+            index = indices.free.back();
+            indices.free.pop_back();
+        }
+    }
+
+    ~FrameThreadIndex(){
+        FrameThreadIndices& indices = frameThreadIndices();
+        std::lock_guard<std::mutex> lock{indices.mutex};
+        indices.free.push_back(index);
+    }
+};
+}
+
+static uint32_t frameThreadIndex(){
+    thread_local FrameThreadIndex thread{};
+    return thread.index;
+}
+
+FrameAllocator::Slot::Slot(size_t arenaSize) : shared(arenaSize) {
+    for (auto& arena : threads){
+        arena.setInitialCapacity(arenaSize);
+    }
+}
+
+FrameAllocator::FrameAllocator(uint32_t framesInFlight, size_t threadArenaSize){
+    for (uint32_t i = 0; i < framesInFlight; i++){
+        slots.push_back(std::make_unique<Slot>(threadArenaSize));
+    }
+}
+
+void FrameAllocator::beginFrame(uint32_t slot){
+    Slot& frame = *slots[slot % slots.size()];
+    for (auto& arena : frame.threads){
+        arena.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock{frame.sharedMutex};
+        frame.shared.reset();
+    }
+    current.store(slot % slots.size(), std::memory_order_release);
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment){
+    Slot& frame = *slots[current.load(std::memory_order_acquire)];
+    uint32_t thread = frameThreadIndex();
+    if (thread < FRAME_ALLOCATOR_THREADS){
+        return frame.threads[thread].allocate(size, alignment);
+    }
+
+    std::lock_guard<std::mutex> lock{frame.sharedMutex};
+    return frame.shared.allocate(size, alignment);
+}
+
+size_t FrameAllocator::bytesUsed(uint32_t slot) const {
+    const Slot& frame = *slots[slot % slots.size()];
+    size_t total = frame.shared.bytesUsed();
+    for (const auto& arena : frame.threads){
+        total += arena.bytesUsed();
+    }
+    return total;
+}
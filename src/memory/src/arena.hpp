@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+
+#define FRAME_ALLOCATOR_THREADS 32
+#define FRAME_ARENA_SIZE (256 * 1024)
+
+// Bump allocator, memory is released all at once by reset().
+// Overflow goes to extra blocks; on reset they are merged into one bigger block,
+// so after a few frames the arena fits the frame and never allocates again.
+class LinearArena {
+private:
+    struct Block {
+        uint8_t* data;
+        size_t capacity;
+    };
+
+    std::vector<Block> blocks{};
+    size_t offset = 0;        // in blocks.back()
+    size_t used = 0;          // bytes handed out since reset (with padding)
+    size_t peak = 0;
+    size_t initialCapacity;
+
+    void addBlock(size_t capacity);
+    void freeBlocks();
+
+public:
+    explicit LinearArena(size_t capacity = FRAME_ARENA_SIZE) : initialCapacity(capacity) {}
+    ~LinearArena();
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    void reset();
+
+    // size of first block, memory is only reserved on first allocate()
+    void setInitialCapacity(size_t capacity) { initialCapacity = capacity; }
+
+    size_t bytesUsed() const { return used; }
+    size_t peakBytes() const { return peak; }
+    size_t capacity() const;
+};
+
+class FrameAllocator;
+
+// std::pmr adapter, deallocate is a no-op (memory goes back on frame reset)
+class FrameArenaResource : public std::pmr::memory_resource {
+private:
+    FrameAllocator* allocator;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+public:
+    explicit FrameArenaResource(FrameAllocator* allocator) : allocator(allocator) {}
+};
+
+// One set of arenas per frame in flight. beginFrame(slot) is called once the slot's
+// fence has signaled and resets every arena of that slot. Each thread bumps its own
+// sub-arena, so workers never contend. Memory stays valid until the same slot begins
+// again (frames in flight - 1 frames later). Only trivially destructible data belongs here.
+// The slot is per allocator: every producer thread (render thread, game thread) owns
+// its own FrameAllocator and only jobs working for that producer's frame allocate from it.
+class FrameAllocator {
+private:
+    struct Slot {
+        LinearArena threads[FRAME_ALLOCATOR_THREADS];
+        LinearArena shared;    // live threads above FRAME_ALLOCATOR_THREADS
+        std::mutex sharedMutex;
+
+        explicit Slot(size_t arenaSize);
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots{};
+    std::atomic<uint32_t> current{0};
+    FrameArenaResource memoryResource{this};
+
+public:
+    explicit FrameAllocator(uint32_t framesInFlight = 2, size_t threadArenaSize = FRAME_ARENA_SIZE);
+
+    // Resets and activates slot (producer thread, once nothing reads that slot's memory)
+    void beginFrame(uint32_t slot);
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* allocateArray(size_t count){
+        static_assert(std::is_trivially_destructible<T>::value, "Frame memory is never destructed");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args){
+        static_assert(std::is_trivially_destructible<T>::value, "Frame memory is never destructed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // For allocator aware containers: std::pmr::vector<T> list{frameAllocator.resource()}
+    std::pmr::memory_resource* resource() { return &memoryResource; }
+
+    uint32_t currentSlot() const { return current.load(std::memory_order_acquire); }
+    size_t bytesUsed(uint32_t slot) const;
+};
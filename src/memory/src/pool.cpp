@@ -0,0 +1,69 @@
+#include "pool.hpp"
+#include <new>
+#include <algorithm>
+
+FixedPool::FixedPool(size_t blockSize, size_t alignment, size_t blocksPerChunk)
+    : alignment(std::max(alignment, alignof(FreeBlock))), blocksPerChunk(std::max<size_t>(blocksPerChunk, 1)) {
+    // every block must hold free list link and keep next block aligned
+    size_t size = std::max(blockSize, sizeof(FreeBlock));
+    this->blockSize = (size + this->alignment - 1) & ~(this->alignment - 1);
+}
+
+FixedPool::~FixedPool(){
+    for (void* chunk : chunks){
+        ::operator delete(chunk, std::align_val_t{alignment});
+    }
+}
+
+void FixedPool::grow(){
+    uint8_t* chunk = static_cast<uint8_t*>(::operator new(blockSize * blocksPerChunk, std::align_val_t{alignment}));
+    chunks.push_back(chunk);
+
+    // thread new blocks into free list, lowest address first
+    for (size_t i = blocksPerChunk; i > 0; i--){
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * blockSize);
+        block->next = freeList;
+        freeList = block;
+    }
+}
+
+void* FixedPool::allocate(){
+    if (freeList == nullptr){
+        grow();
+    }
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    live++;
+    return block;
+}
+
+void FixedPool::deallocate(void* block){
+    if (block == nullptr){
+        return;
+    }
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeList;
+    freeList = freed;
+    live--;
+}
+
+void FixedPool::reserve(size_t blocks){
+    while (capacity() < blocks){
+        grow();
+    }
+}
+
+void* PoolResource::do_allocate(size_t bytes, size_t alignment){
+    if (bytes <= pool.size() && alignment <= pool.align()){
+        return pool.allocate();
+    }
+    return upstream->allocate(bytes, alignment);
+}
+
+void PoolResource::do_deallocate(void* pointer, size_t bytes, size_t alignment){
+    if (bytes <= pool.size() && alignment <= pool.align()){
+        pool.deallocate(pointer);
+        return;
+    }
+    upstream->deallocate(pointer, bytes, alignment);
+}
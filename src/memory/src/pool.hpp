@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+#include <utility>
+
+// Fixed size block allocator with intrusive free list. Memory is taken from the heap
+// in chunks of blocksPerChunk blocks and only returned when the pool is destroyed.
+// Not thread safe, one pool per owner.
+class FixedPool {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t blockSize;
+    size_t alignment;
+    size_t blocksPerChunk;
+    FreeBlock* freeList = nullptr;
+    std::vector<void*> chunks{};
+    size_t live = 0;
+
+    void grow();
+
+public:
+    FixedPool(size_t blockSize, size_t alignment = alignof(std::max_align_t), size_t blocksPerChunk = 64);
+    ~FixedPool();
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    void* allocate();
+    void deallocate(void* block);
+
+    // Reserve chunks up front, so first frames do not allocate
+    void reserve(size_t blocks);
+
+    size_t size() const { return blockSize; }
+    size_t align() const { return alignment; }
+    size_t liveCount() const { return live; }
+    size_t capacity() const { return chunks.size() * blocksPerChunk; }
+};
+
+// Typed pool for Parts and other fixed size objects
+template<typename T>
+class ObjectPool {
+private:
+    FixedPool pool;
+
+public:
+    explicit ObjectPool(size_t objectsPerChunk = 64) : pool(sizeof(T), alignof(T), objectsPerChunk) {}
+
+    template<typename... Args>
+    T* create(Args&&... args){
+        void* memory = pool.allocate();
+        try {
+            return new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(memory);
+            throw;
+        }
+    }
+
+    void destroy(T* object){
+        if (object == nullptr){
+            return;
+        }
+        object->~T();
+        pool.deallocate(object);
+    }
+
+    void reserve(size_t count) { pool.reserve(count); }
+    size_t size() const { return pool.liveCount(); }
+};
+
+// std::pmr adapter: requests that fit a block come from the pool, others go upstream.
+// Good fit for node containers (std::pmr::list, std::pmr::map, std::pmr::unordered_map nodes).
+class PoolResource : public std::pmr::memory_resource {
+private:
+    FixedPool pool;
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+public:
+    PoolResource(size_t blockSize, size_t blocksPerChunk = 64, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : pool(blockSize, alignof(std::max_align_t), blocksPerChunk), upstream(upstream) {}
+
+    size_t liveCount() const { return pool.liveCount(); }
+};
@@ -0,0 +1,191 @@
+#include "occlusionBehaviour.hpp"
+#include "../graphics/src/mesh/mesh.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+void OcclusionBehaviour::init(){
+    parts.reserve(1024);
+    std::cout << "Occlusion: up to " << (culler != nullptr ? culler->maxObjects() : OCCLUSION_MAX_OBJECTS) << " objects" << std::endl;
+}
+
+void OcclusionBehaviour::update(){
+}
+
+void OcclusionBehaviour::add(OcclusionPart* component){
+    add(creatures->create(), *component);
+}
+
+OcclusionPart& OcclusionBehaviour::add(Creature creature, const OcclusionPart& part){
+    uint32_t limit = culler != nullptr ? culler->maxObjects() : OCCLUSION_MAX_OBJECTS;
+    if (!parts.contains(creature) && parts.size() == limit){
+        throw std::runtime_error("Too many occlusion objects");
+    }
+    if (culler != nullptr && part.mesh >= culler->meshCount()){
+        throw std::runtime_error("Occlusion part uses unknown mesh");
+    }
+    return parts.add(creature, part);
+}
+
+void OcclusionBehaviour::remove(Creature creature){
+    parts.remove(creature);
+}
+
+OcclusionPart* OcclusionBehaviour::get(Creature creature){
+    if (!creatures->alive(creature)){
+        return nullptr;
+    }
+    return parts.modify(creature);
+}
+
+const OcclusionPart* OcclusionBehaviour::find(Creature creature) const {
+    if (!creatures->alive(creature)){
+        return nullptr;
+    }
+    return parts.get(creature);
+}
+
+void OcclusionBehaviour::setView(const float view[16], const float projection[16]){
+    // viewProjection = projection * view
+    for (uint32_t column = 0; column < 4; column++){
+        for (uint32_t row = 0; row < 4; row++){
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < 4; i++){
+                sum += projection[i * 4 + row] * view[column * 4 + i];
+            }
+            viewProjection[column * 4 + row] = sum;
+        }
+    }
+
+    // position is -R^T * translation
+    for (uint32_t axis = 0; axis < 3; axis++){
+        cameraPosition[axis] = -(view[axis * 4 + 0] * view[12] + view[axis * 4 + 1] * view[13] + view[axis * 4 + 2] * view[14]);
+    }
+    focalLength = projection[5];
+}
+
+OcclusionStats OcclusionBehaviour::stats() const {
+    return culler != nullptr ? culler->stats() : OcclusionStats{};
+}
+
+bool OcclusionBehaviour::layoutChanged(){
+    if (parts.structureChangedSince(layoutTick) || layoutGeneration == 0 || meshCounts.size() != culler->meshCount()){
+        return true;
+    }
+    bool changed = false;
+    parts.forEachChanged(layoutTick, [&](uint32_t dense){
+        changed = changed || (dense < slotMeshes.size() && parts.data()[dense].mesh != slotMeshes[dense]);
+    });
+    return changed;
+}
+
+void OcclusionBehaviour::buildLayout(uint32_t objectCount){
+    // counting sort by mesh: one range per mesh, first object of each range
+    // mesh may have been changed through get() or added before culler was set
+    meshCounts.assign(culler->meshCount(), 0);
+    for (uint32_t i = 0; i < objectCount; i++){
+        uint16_t mesh = parts.data()[i].mesh;
+        if (mesh >= meshCounts.size()){
+            throw std::runtime_error("Occlusion part uses unknown mesh");
+        }
+        meshCounts[mesh]++;
+    }
+    layoutRanges.clear();
+    uint32_t first = 0;
+    for (uint32_t mesh = 0; mesh < meshCounts.size(); mesh++){
+        if (meshCounts[mesh] != 0){
+            layoutRanges.push_back({static_cast<uint16_t>(mesh), first, meshCounts[mesh]});
+        }
+        uint32_t count = meshCounts[mesh];
+        meshCounts[mesh] = first;
+        first += count;
+    }
+
+    objectSlots.resize(objectCount);
+    slotMeshes.resize(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++){
+        uint16_t mesh = parts.data()[i].mesh;
+        objectSlots[i] = meshCounts[mesh]++;
+        slotMeshes[i] = mesh;
+    }
+    layoutGeneration++;
+}
+
+void OcclusionBehaviour::writeObject(OcclusionObject* objects, uint32_t dense){
+    const OcclusionPart& part = parts.data()[dense];
+    const MeshHeader& header = culler->mesh(part.mesh)->header;
+    OcclusionObject& object = objects[objectSlots[dense]];
+
+    // world box of transformed mesh box: center moves, extent grows by |rotation|
+    for (uint32_t row = 0; row < 3; row++){
+        const float* m = &part.model[row * 4];
+        float center = m[3];
+        float extent = 0.0f;
+        for (uint32_t k = 0; k < 3; k++){
+            center += m[k] * 0.5f * (header.boundsMin[k] + header.boundsMax[k]);
+            extent += std::fabs(m[k]) * 0.5f * (header.boundsMax[k] - header.boundsMin[k]);
+        }
+        object.boundsMin[row] = center - extent;
+        object.boundsMax[row] = center + extent;
+    }
+    for (uint32_t k = 0; k < 12; k++){
+        object.model[k] = part.model[k];
+    }
+    object.mesh = part.mesh;
+}
+
+void OcclusionBehaviour::submit(RenderCommandBuffer& commands){
+    if (culler == nullptr){
+        return;
+    }
+
+    uint32_t buffer = culler->acquire();
+    OcclusionObject* objects = culler->objects(buffer);
+    std::vector<OcclusionRange>& ranges = culler->ranges(buffer);
+    uint32_t objectCount = static_cast<uint32_t>(std::min<size_t>(parts.size(), culler->maxObjects()));
+
+    ChangeTick now = parts.advanceTick();
+    if (layoutChanged()){
+        buildLayout(objectCount);
+    }
+    layoutTick = now;
+
+    if (buffer >= bufferLayouts.size()){
+        bufferLayouts.resize(static_cast<size_t>(buffer) + 1, 0);
+        bufferTicks.resize(static_cast<size_t>(buffer) + 1, 0);
+    }
+    if (bufferLayouts[buffer] != layoutGeneration){
+        ranges = layoutRanges;
+        for (uint32_t i = 0; i < objectCount; i++){
+            writeObject(objects, i);
+        }
+        bufferLayouts[buffer] = layoutGeneration;
+    } else {
+        // same grouping as when buffer was last written, only objects changed since then
+        parts.forEachChanged(bufferTicks[buffer], [&](uint32_t dense){
+            if (dense < objectCount){
+                writeObject(objects, dense);
+            }
+        });
+    }
+    bufferTicks[buffer] = now;
+
+    OcclusionCullCommand command{};
+    command.buffer = buffer;
+    command.objectCount = objectCount;
+    for (uint32_t k = 0; k < 16; k++){
+        command.viewProjection[k] = viewProjection[k];
+    }
+    Frustum frustum = Frustum::fromMatrix(viewProjection);
+    for (uint32_t plane = 0; plane < 6; plane++){
+        for (uint32_t k = 0; k < 4; k++){
+            command.planes[plane][k] = frustum.planes[plane][k];
+        }
+    }
+    for (uint32_t k = 0; k < 3; k++){
+        command.cameraPosition[k] = cameraPosition[k];
+    }
+    command.focalLength = focalLength;
+    commands.push(OCCLUSION_CULL_COMMAND, command);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <System.hpp>
+#include <Creature.hpp>
+#include <SparseSet.hpp>
+#include "src/occlusionculler.hpp"
+#include "../spatial/src/bounds.hpp"
+#include "../graphics/src/commandstream.hpp"
+
+// Mesh instance that takes part in occlusion culling, occludes and can be occluded
+class OcclusionPart {
+public:
+    uint16_t mesh = 0;      // OcclusionCuller::addMesh id
+    float model[12]{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0}; // rows of 3x4 object to world transform
+};
+
+// Occlusion culled meshes of creatures. Objects are grouped by mesh into consecutive ranges,
+// world bounds come from mesh bounds and transform; culling itself is on GPU (OcclusionCuller).
+// Object buffers are rewritten incrementally: only Parts changed since buffer was last written,
+// whole buffer when the mesh grouping changed (add, remove, mesh switch).
+class OcclusionBehaviour : public System<OcclusionPart> {
+private:
+    CreatureRegistry<>* creatures;
+    OcclusionCuller* culler = nullptr;
+    SparseSet<OcclusionPart> parts{};
+    std::vector<uint32_t> meshCounts{};
+
+    // grouping by mesh, rebuilt when structure changes
+    std::vector<uint32_t> objectSlots{};        // dense slot -> object index
+    std::vector<uint16_t> slotMeshes{};         // dense slot -> mesh it was grouped with
+    std::vector<OcclusionRange> layoutRanges{};
+    uint32_t layoutGeneration = 0;
+    ChangeTick layoutTick = 0;
+    // per object buffer: layout generation it holds (0 none) and change tick it was written at
+    std::vector<uint32_t> bufferLayouts{};
+    std::vector<ChangeTick> bufferTicks{};
+
+    bool layoutChanged();
+    void buildLayout(uint32_t objectCount);
+    void writeObject(OcclusionObject* objects, uint32_t dense);
+    float viewProjection[16]{};
+    float cameraPosition[3]{};
+    float focalLength = 1.0f;
+
+public:
+    OcclusionBehaviour(CreatureRegistry<>* creatures) : creatures(creatures) {}
+
+    void init();
+    void update();
+
+    // Part without creature, gets a new creature from registry
+    void add(OcclusionPart* component);
+    OcclusionPart& add(Creature creature, const OcclusionPart& part);
+    void remove(Creature creature);
+    // For writing: Part is uploaded again at next submit
+    OcclusionPart* get(Creature creature);
+    const OcclusionPart* find(Creature creature) const;
+
+    void setCuller(OcclusionCuller* occlusionCuller) { culler = occlusionCuller; bufferLayouts.clear(); }
+    // column major matrices, camera position for level of detail comes from view
+    void setView(const float view[16], const float projection[16]);
+
+    // Game thread, once per rendered frame: writes objects to free buffer, pushes cull command
+    void submit(RenderCommandBuffer& commands);
+    OcclusionStats stats() const;
+
+    size_t size() const { return parts.size(); }
+};
@@ -0,0 +1,855 @@
+#include "occlusionculler.hpp"
+#include "../../graphics/src/render.hpp"
+#include "../../graphics/src/pipeline/shader.hpp"
+#include "../../graphics/src/mesh/mesh.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cmath>
+
+// one more than frames in flight: game thread writes next frame while GPU reads the others
+#define OCCLUSION_OBJECT_BUFFERS (MAX_FRAMES_IN_FLIGHT + 1)
+#define OCCLUSION_GROUP_SIZE 64
+#define OCCLUSION_DOWNSAMPLE_GROUP_SIZE 8
+#define OCCLUSION_DEPTH_FORMAT VK_FORMAT_D32_SFLOAT
+#define OCCLUSION_COUNTERS 5
+
+// cull phases, also index of argument array in drawArgs
+#define OCCLUSION_PHASE_EARLY 0
+#define OCCLUSION_PHASE_LATE 1
+#define OCCLUSION_PHASE_VISIBLE 2
+
+// Uniform of cull kernel (std140)
+struct OcclusionFrame {
+    float viewProjection[16];
+    float planes[6][4];
+    float cameraPosition[4];    // w: pixels per mesh unit at distance 1
+    float extent[2];
+    uint32_t levelCount;
+    uint32_t objectCount;
+    uint32_t capacity;
+    float lodThreshold;
+    float lodHysteresis;
+    uint32_t padding;
+};
+
+static_assert(OCCLUSION_MAX_LODS == MESH_MAX_LODS, "Occlusion level table must hold every mesh level");
+
+struct OcclusionDepthConstants {
+    float viewProjection[16];
+    MeshQuantization quantization;
+    uint32_t objectBase;
+};
+
+OcclusionCuller::OcclusionCuller(Render* render, uint32_t maxObjects){
+    std::cout << "Creating occlusion culler" << std::endl;
+
+    _render = render;
+    capacity = maxObjects;
+    firstInstance = render->capabilities.drawIndirectFirstInstance;
+    multiDraw = firstInstance && render->capabilities.multiDrawIndirect;
+
+    VkDeviceSize argsSize = VkDeviceSize(capacity) * 3 * sizeof(VkDrawIndexedIndirectCommand);
+    visibility = createStorage(VkDeviceSize(capacity) * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    drawArgs = createStorage(argsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    counters = createStorage(OCCLUSION_COUNTERS * sizeof(uint32_t),
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    lods.resize(OCCLUSION_MAX_MESHES * OCCLUSION_MAX_LODS);
+    lodTable = createStorage(lods.size() * sizeof(OcclusionLod), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    // nothing was visible before first frame
+    std::vector<uint32_t> hidden(capacity, 0);
+    render->uploadBuffer(visibility, hidden.data(), VkDeviceSize(capacity) * sizeof(uint32_t));
+
+    VkMemoryPropertyFlags mappable = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VkDeviceSize objectsSize = VkDeviceSize(capacity) * sizeof(OcclusionObject);
+    objectBuffers.resize(OCCLUSION_OBJECT_BUFFERS);
+    frameBuffers.resize(OCCLUSION_OBJECT_BUFFERS);
+    objectMemories.resize(OCCLUSION_OBJECT_BUFFERS * 2);
+    objectMapped.resize(OCCLUSION_OBJECT_BUFFERS);
+    frameMapped.resize(OCCLUSION_OBJECT_BUFFERS);
+    bufferRanges.resize(OCCLUSION_OBJECT_BUFFERS);
+    bufferOwners.assign(OCCLUSION_OBJECT_BUFFERS, FREE);
+    for (uint32_t i = 0; i < OCCLUSION_OBJECT_BUFFERS; i++){
+        render->createBuffer(objectsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, mappable, &objectBuffers[i], &objectMemories[i * 2]);
+        render->createBuffer(sizeof(OcclusionFrame), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, mappable, &frameBuffers[i], &objectMemories[i * 2 + 1]);
+        void* mapped;
+        vkMapMemory(render->device, objectMemories[i * 2], 0, objectsSize, 0, &mapped);
+        objectMapped[i] = static_cast<OcclusionObject*>(mapped);
+        vkMapMemory(render->device, objectMemories[i * 2 + 1], 0, sizeof(OcclusionFrame), 0, &frameMapped[i]);
+    }
+
+    slotBuffers.assign(MAX_FRAMES_IN_FLIGHT, FREE);
+    readbackBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    readbackMemories.resize(MAX_FRAMES_IN_FLIGHT);
+    readbackMapped.resize(MAX_FRAMES_IN_FLIGHT);
+    readbackWritten.assign(MAX_FRAMES_IN_FLIGHT, false);
+    readbackObjects.assign(MAX_FRAMES_IN_FLIGHT, 0);
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        render->createBuffer(OCCLUSION_COUNTERS * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, mappable,
+                             &readbackBuffers[i], &readbackMemories[i]);
+        void* mapped;
+        vkMapMemory(render->device, readbackMemories[i], 0, OCCLUSION_COUNTERS * sizeof(uint32_t), 0, &mapped);
+        readbackMapped[i] = static_cast<uint32_t*>(mapped);
+    }
+
+    createRenderPasses();
+    createDescriptors();
+    createPipelines();
+    createTargets(render->extent);
+
+    render->registerPrePassCommand(OCCLUSION_CULL_COMMAND, [this](VkCommandBuffer commandBuffer, const void* payload){
+        OcclusionCullCommand command;
+        memcpy(&command, payload, sizeof(command));
+        cull(commandBuffer, command);
+    });
+
+    std::cout << "\tObjects: " << capacity << ", pyramid: " << levelCount << " levels"
+              << (multiDraw ? " (multi draw indirect)" : firstInstance ? " (draw per object)" : " (draw per object, index in push constant)") << std::endl;
+    std::cout << "Occlusion culler created successfully" << std::endl << std::endl;
+}
+
+VkBuffer OcclusionCuller::createStorage(VkDeviceSize size, VkBufferUsageFlags usage){
+    VkBuffer buffer;
+    VkDeviceMemory memory;
+    _render->createBuffer(size, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &buffer, &memory);
+    memories.push_back(memory);
+    return buffer;
+}
+
+// Depth only passes: early one clears, late one keeps early depth. Pyramid downsample reads result.
+void OcclusionCuller::createRenderPasses(){
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = OCCLUSION_DEPTH_FORMAT;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference depthReference{};
+    depthReference.attachment = 0;
+    depthReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpassDescription{};
+    subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpassDescription.pDepthStencilAttachment = &depthReference;
+
+    VkSubpassDependency dependencies[2]{};
+    // previous pyramid downsample read depth before it is cleared / written again
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    // depth -> pyramid downsample
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    VkRenderPassCreateInfo renderPassCreateInfo{};
+    renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassCreateInfo.attachmentCount = 1;
+    renderPassCreateInfo.pAttachments = &depthAttachment;
+    renderPassCreateInfo.subpassCount = 1;
+    renderPassCreateInfo.pSubpasses = &subpassDescription;
+    renderPassCreateInfo.dependencyCount = 2;
+    renderPassCreateInfo.pDependencies = dependencies;
+
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (vkCreateRenderPass(_render->device, &renderPassCreateInfo, nullptr, &clearPass) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion depth render pass");
+    }
+
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    if (vkCreateRenderPass(_render->device, &renderPassCreateInfo, nullptr, &loadPass) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion depth render pass");
+    }
+}
+
+void OcclusionCuller::createDescriptors(){
+    // 0 frame, 1 objects, 2 visibility, 3 draw arguments, 4 counters, 5 pyramid, 6 level table
+    VkDescriptorType types[7] = {
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+    };
+    VkDescriptorSetLayoutBinding bindings[7]{};
+    for (uint32_t i = 0; i < 7; i++){
+        bindings[i].binding = i;
+        bindings[i].descriptorType = types[i];
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.bindingCount = 7;
+    layoutCreateInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(_render->device, &layoutCreateInfo, nullptr, &cullSetLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion descriptor set layout");
+    }
+
+    // downsample: 0 source level (or depth), 1 destination level
+    VkDescriptorSetLayoutBinding levelBindings[2]{};
+    levelBindings[0].binding = 0;
+    levelBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    levelBindings[0].descriptorCount = 1;
+    levelBindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    levelBindings[1].binding = 1;
+    levelBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    levelBindings[1].descriptorCount = 1;
+    levelBindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    layoutCreateInfo.bindingCount = 2;
+    layoutCreateInfo.pBindings = levelBindings;
+    if (vkCreateDescriptorSetLayout(_render->device, &layoutCreateInfo, nullptr, &downsampleSetLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create pyramid descriptor set layout");
+    }
+
+    VkDescriptorPoolSize poolSizes[3]{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[0].descriptorCount = OCCLUSION_OBJECT_BUFFERS;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = 5 * OCCLUSION_OBJECT_BUFFERS;
+    poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[2].descriptorCount = OCCLUSION_OBJECT_BUFFERS;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo{};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.maxSets = OCCLUSION_OBJECT_BUFFERS;
+    poolCreateInfo.poolSizeCount = 3;
+    poolCreateInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(_render->device, &poolCreateInfo, nullptr, &descriptorPool) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion descriptor pool");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(OCCLUSION_OBJECT_BUFFERS, cullSetLayout);
+    cullSets.resize(OCCLUSION_OBJECT_BUFFERS);
+    cullSetGenerations.resize(OCCLUSION_OBJECT_BUFFERS, 0);
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = descriptorPool;
+    allocateInfo.descriptorSetCount = OCCLUSION_OBJECT_BUFFERS;
+    allocateInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(_render->device, &allocateInfo, cullSets.data()) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate occlusion descriptor sets");
+    }
+
+    // pyramid (binding 5) is written with targets
+    for (uint32_t buffer = 0; buffer < OCCLUSION_OBJECT_BUFFERS; buffer++){
+        VkDescriptorBufferInfo bufferInfos[6]{
+            {frameBuffers[buffer], 0, VK_WHOLE_SIZE},
+            {objectBuffers[buffer], 0, VK_WHOLE_SIZE},
+            {visibility, 0, VK_WHOLE_SIZE},
+            {drawArgs, 0, VK_WHOLE_SIZE},
+            {counters, 0, VK_WHOLE_SIZE},
+            {lodTable, 0, VK_WHOLE_SIZE},
+        };
+        uint32_t bufferBindings[6] = {0, 1, 2, 3, 4, 6};
+        VkWriteDescriptorSet writes[6]{};
+        for (uint32_t i = 0; i < 6; i++){
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = cullSets[buffer];
+            writes[i].dstBinding = bufferBindings[i];
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = types[bufferBindings[i]];
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets(_render->device, 6, writes, 0, nullptr);
+    }
+
+    VkSamplerCreateInfo samplerCreateInfo{};
+    samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerCreateInfo.magFilter = VK_FILTER_NEAREST;
+    samplerCreateInfo.minFilter = VK_FILTER_NEAREST;
+    samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(_render->device, &samplerCreateInfo, nullptr, &sampler) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion sampler");
+    }
+}
+
+void OcclusionCuller::createPipelines(){
+    VkDevice device = _render->device;
+
+    // Cull kernel, phase in push constant
+    VkPushConstantRange cullRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t)};
+    VkPipelineLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &cullSetLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &cullRange;
+    if (vkCreatePipelineLayout(device, &layoutCreateInfo, nullptr, &cullLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion cull pipeline layout");
+    }
+
+    layoutCreateInfo.pSetLayouts = &downsampleSetLayout;
+    layoutCreateInfo.pushConstantRangeCount = 0;
+    layoutCreateInfo.pPushConstantRanges = nullptr;
+    if (vkCreatePipelineLayout(device, &layoutCreateInfo, nullptr, &downsampleLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create pyramid pipeline layout");
+    }
+
+    VkPushConstantRange depthRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(OcclusionDepthConstants)};
+    layoutCreateInfo.pSetLayouts = &cullSetLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &depthRange;
+    if (vkCreatePipelineLayout(device, &layoutCreateInfo, nullptr, &depthLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion depth pipeline layout");
+    }
+
+    // object index travels in firstInstance only when device allows it in indirect draws
+    VkBool32 useFirstInstance = firstInstance ? VK_TRUE : VK_FALSE;
+    VkSpecializationMapEntry specializationEntry{0, 0, sizeof(VkBool32)};
+    VkSpecializationInfo specialization{};
+    specialization.mapEntryCount = 1;
+    specialization.pMapEntries = &specializationEntry;
+    specialization.dataSize = sizeof(VkBool32);
+    specialization.pData = &useFirstInstance;
+
+    Shader cullShader{_render, "shaders/occlusion_cull.comp.spv", ShaderType::COMPUTE};
+    Shader downsampleShader{_render, "shaders/hiz_downsample.comp.spv", ShaderType::COMPUTE};
+
+    VkComputePipelineCreateInfo computeCreateInfos[2]{};
+    for (uint32_t i = 0; i < 2; i++){
+        computeCreateInfos[i].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        computeCreateInfos[i].stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        computeCreateInfos[i].stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        computeCreateInfos[i].stage.pName = "main";
+    }
+    computeCreateInfos[0].stage.module = cullShader.shadermodule;
+    computeCreateInfos[0].stage.pSpecializationInfo = &specialization;
+    computeCreateInfos[0].layout = cullLayout;
+    computeCreateInfos[1].stage.module = downsampleShader.shadermodule;
+    computeCreateInfos[1].layout = downsampleLayout;
+
+    VkPipeline computePipelines[2];
+    VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 2, computeCreateInfos, nullptr, computePipelines);
+    cullShader.cleanup();
+    downsampleShader.cleanup();
+    if (result != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion compute pipelines");
+    }
+    cullPipeline = computePipelines[0];
+    downsamplePipeline = computePipelines[1];
+
+    // Depth only mesh pipeline, no fragment shader
+    Shader vertexShader{_render, "shaders/occlusion_depth.vert.spv", ShaderType::VERTEX};
+
+    VkPipelineShaderStageCreateInfo stage{};
+    stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stage.stage = vertexShader.bits;
+    stage.module = vertexShader.shadermodule;
+    stage.pName = "main";
+
+    VertexInputDescription vertexInput = Mesh::vertexInputDescription();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState{};
+    inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkDynamicState dynamicStateList[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStateList;
+
+    // winding of meshes is not known, back faces write depth too
+    VkPipelineRasterizationStateCreateInfo rasterizationState{};
+    rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizationState.cullMode = VK_CULL_MODE_NONE;
+    rasterizationState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizationState.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampleState{};
+    multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencilState{};
+    depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencilState.depthTestEnable = VK_TRUE;
+    depthStencilState.depthWriteEnable = VK_TRUE;
+    depthStencilState.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    VkPipelineColorBlendStateCreateInfo blendState{};
+    blendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+
+    VkGraphicsPipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    createInfo.stageCount = 1;
+    createInfo.pStages = &stage;
+    createInfo.pVertexInputState = vertexInput.get();
+    createInfo.pInputAssemblyState = &inputAssemblyState;
+    createInfo.pViewportState = &viewportState;
+    createInfo.pRasterizationState = &rasterizationState;
+    createInfo.pMultisampleState = &multisampleState;
+    createInfo.pDepthStencilState = &depthStencilState;
+    createInfo.pColorBlendState = &blendState;
+    createInfo.pDynamicState = &dynamicState;
+    createInfo.layout = depthLayout;
+    createInfo.renderPass = clearPass;
+    createInfo.subpass = 0;
+    createInfo.basePipelineIndex = -1;
+
+    result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &depthPipeline);
+    vertexShader.cleanup();
+    if (result != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion depth pipeline");
+    }
+}
+
+// Depth at full extent, pyramid level 0 is half of it rounded up, each next level half again down to 1x1.
+// Texel t of level i then covers pixels [t * 2^(i+1), (t+1) * 2^(i+1)) exactly.
+void OcclusionCuller::createTargets(VkExtent2D extent){
+    VkDevice device = _render->device;
+    targetExtent = extent;
+
+    uint32_t width = (extent.width + 1) / 2;
+    uint32_t height = (extent.height + 1) / 2;
+    levelCount = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size = (size + 1) / 2){
+        levelCount++;
+    }
+
+    auto createImage = [&](VkFormat format, uint32_t w, uint32_t h, uint32_t levels, VkImageUsageFlags usage, VkImage* image, VkDeviceMemory* memory){
+        VkImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageCreateInfo.format = format;
+        imageCreateInfo.extent = {w, h, 1};
+        imageCreateInfo.mipLevels = levels;
+        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCreateInfo.usage = usage;
+        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (vkCreateImage(device, &imageCreateInfo, nullptr, image) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create occlusion image");
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(device, *image, &memoryRequirements);
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = memoryRequirements.size;
+        allocateInfo.memoryTypeIndex = _render->findMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (vkAllocateMemory(device, &allocateInfo, nullptr, memory) != VK_SUCCESS){
+            throw std::runtime_error("Failed to allocate occlusion image memory");
+        }
+        vkBindImageMemory(device, *image, *memory, 0);
+    };
+
+    auto createView = [&](VkImage image, VkFormat format, VkImageAspectFlags aspect, uint32_t baseLevel, uint32_t levels){
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = image;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = format;
+        viewCreateInfo.subresourceRange.aspectMask = aspect;
+        viewCreateInfo.subresourceRange.baseMipLevel = baseLevel;
+        viewCreateInfo.subresourceRange.levelCount = levels;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+        VkImageView view;
+        if (vkCreateImageView(device, &viewCreateInfo, nullptr, &view) != VK_SUCCESS){
+            throw std::runtime_error("Failed to create occlusion image view");
+        }
+        return view;
+    };
+
+    createImage(OCCLUSION_DEPTH_FORMAT, extent.width, extent.height, 1,
+                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, &depthImage, &depthMemory);
+    depthView = createView(depthImage, OCCLUSION_DEPTH_FORMAT, VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1);
+
+    createImage(VK_FORMAT_R32_SFLOAT, width, height, levelCount,
+                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT, &pyramidImage, &pyramidMemory);
+    pyramidView = createView(pyramidImage, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount);
+    pyramidLevelViews.resize(levelCount);
+    for (uint32_t level = 0; level < levelCount; level++){
+        pyramidLevelViews[level] = createView(pyramidImage, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, level, 1);
+    }
+
+    VkFramebufferCreateInfo framebufferCreateInfo{};
+    framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferCreateInfo.renderPass = clearPass;
+    framebufferCreateInfo.attachmentCount = 1;
+    framebufferCreateInfo.pAttachments = &depthView;
+    framebufferCreateInfo.width = extent.width;
+    framebufferCreateInfo.height = extent.height;
+    framebufferCreateInfo.layers = 1;
+    if (vkCreateFramebuffer(device, &framebufferCreateInfo, nullptr, &depthFramebuffer) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create occlusion framebuffer");
+    }
+
+    // pyramid stays in general layout, it is written and sampled by compute only
+    VkCommandBuffer commandBuffer = _render->beginSingleTimeCommands();
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = pyramidImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount, 0, 1};
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                   0, 0, nullptr, 0, nullptr, 1, &barrier);
+    _render->endSingleTimeCommands(commandBuffer);
+
+    // one downsample set per level: source is previous level, depth for level 0
+    VkDescriptorPoolSize poolSizes[2]{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = levelCount;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = levelCount;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo{};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.maxSets = levelCount;
+    poolCreateInfo.poolSizeCount = 2;
+    poolCreateInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(device, &poolCreateInfo, nullptr, &levelPool) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create pyramid descriptor pool");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(levelCount, downsampleSetLayout);
+    levelSets.resize(levelCount);
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = levelPool;
+    allocateInfo.descriptorSetCount = levelCount;
+    allocateInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(device, &allocateInfo, levelSets.data()) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate pyramid descriptor sets");
+    }
+
+    for (uint32_t level = 0; level < levelCount; level++){
+        VkDescriptorImageInfo source{sampler, level == 0 ? depthView : pyramidLevelViews[level - 1],
+                                     level == 0 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL};
+        VkDescriptorImageInfo destination{VK_NULL_HANDLE, pyramidLevelViews[level], VK_IMAGE_LAYOUT_GENERAL};
+
+        VkWriteDescriptorSet writes[2]{};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = levelSets[level];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorCount = 1;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].pImageInfo = &source;
+        writes[1] = writes[0];
+        writes[1].dstBinding = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &destination;
+        vkUpdateDescriptorSets(device, 2, writes, 0, nullptr);
+    }
+
+    // cull sets of buffers in flight must not change, each is pointed at new pyramid in cull()
+    targetGeneration++;
+}
+
+void OcclusionCuller::destroyTargets(){
+    DeletionQueue& deletionQueue = _render->deletionQueue;
+    deletionQueue.destroy(levelPool);
+    deletionQueue.destroy(depthFramebuffer);
+    for (VkImageView view : pyramidLevelViews){
+        deletionQueue.destroy(view);
+    }
+    pyramidLevelViews.clear();
+    deletionQueue.destroy(pyramidView);
+    deletionQueue.destroy(pyramidImage);
+    deletionQueue.destroy(pyramidMemory);
+    deletionQueue.destroy(depthView);
+    deletionQueue.destroy(depthImage);
+    deletionQueue.destroy(depthMemory);
+}
+
+OcclusionCuller::~OcclusionCuller(){
+    VkDevice device = _render->device;
+
+    _render->prePassHandlers.erase(OCCLUSION_CULL_COMMAND);
+
+    destroyTargets();
+
+    for (uint32_t i = 0; i < objectBuffers.size(); i++){
+        vkUnmapMemory(device, objectMemories[i * 2]);
+        vkUnmapMemory(device, objectMemories[i * 2 + 1]);
+        vkDestroyBuffer(device, objectBuffers[i], nullptr);
+        vkDestroyBuffer(device, frameBuffers[i], nullptr);
+    }
+    for (VkDeviceMemory memory : objectMemories){
+        vkFreeMemory(device, memory, nullptr);
+    }
+    for (uint32_t i = 0; i < readbackBuffers.size(); i++){
+        vkUnmapMemory(device, readbackMemories[i]);
+        vkDestroyBuffer(device, readbackBuffers[i], nullptr);
+        vkFreeMemory(device, readbackMemories[i], nullptr);
+    }
+    for (VkBuffer buffer : {visibility, drawArgs, counters, lodTable}){
+        vkDestroyBuffer(device, buffer, nullptr);
+    }
+    for (VkDeviceMemory memory : memories){
+        vkFreeMemory(device, memory, nullptr);
+    }
+
+    vkDestroySampler(device, sampler, nullptr);
+    vkDestroyPipeline(device, cullPipeline, nullptr);
+    vkDestroyPipeline(device, downsamplePipeline, nullptr);
+    vkDestroyPipeline(device, depthPipeline, nullptr);
+    vkDestroyPipelineLayout(device, cullLayout, nullptr);
+    vkDestroyPipelineLayout(device, downsampleLayout, nullptr);
+    vkDestroyPipelineLayout(device, depthLayout, nullptr);
+    vkDestroyRenderPass(device, clearPass, nullptr);
+    vkDestroyRenderPass(device, loadPass, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, cullSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, downsampleSetLayout, nullptr);
+}
+
+uint16_t OcclusionCuller::addMesh(Mesh* mesh){
+    if (meshes.size() == OCCLUSION_MAX_MESHES){
+        throw std::runtime_error("Too many occlusion meshes");
+    }
+    uint16_t id = static_cast<uint16_t>(meshes.size());
+    meshes.push_back(mesh);
+
+    uint32_t levelCount = std::min(mesh->lodCount(), OCCLUSION_MAX_LODS);
+    for (uint32_t level = 0; level < levelCount; level++){
+        const MeshLod& lod = mesh->lods[level];
+        lods[id * OCCLUSION_MAX_LODS + level] = {lod.firstIndex, lod.indexCount, lod.error, levelCount};
+    }
+    _render->uploadBuffer(lodTable, lods.data(), lods.size() * sizeof(OcclusionLod));
+    return id;
+}
+
+uint32_t OcclusionCuller::acquire(){
+    std::unique_lock<std::mutex> lock{mutex};
+    uint32_t buffer = FREE;
+    released.wait(lock, [&]{
+        auto found = std::find(bufferOwners.begin(), bufferOwners.end(), FREE);
+        buffer = static_cast<uint32_t>(found - bufferOwners.begin());
+        return found != bufferOwners.end();
+    });
+    bufferOwners[buffer] = WRITING;
+    return buffer;
+}
+
+OcclusionStats OcclusionCuller::stats(){
+    std::lock_guard<std::mutex> lock{mutex};
+    return lastStats;
+}
+
+// Slot's fence was waited on, counters its last frame copied back are final
+void OcclusionCuller::readStats(uint32_t frame){
+    if (!readbackWritten[frame]){
+        return;
+    }
+    const uint32_t* values = readbackMapped[frame];
+    lastStats.objects = readbackObjects[frame];
+    lastStats.frustumCulled = values[0];
+    lastStats.occluded = values[1];
+    lastStats.drawnEarly = values[2];
+    lastStats.drawnLate = values[3];
+    lastStats.triangles = values[4];
+}
+
+void OcclusionCuller::dispatchCull(VkCommandBuffer commandBuffer, uint32_t phase, uint32_t objectCount){
+    _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline);
+    vkCmdPushConstants(commandBuffer, cullLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(phase), &phase);
+    _render->stats.dispatch(commandBuffer, (objectCount + OCCLUSION_GROUP_SIZE - 1) / OCCLUSION_GROUP_SIZE, 1, 1);
+
+    // arguments -> indirect draws, visibility and counters -> late cull and readback copy
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                   VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                   0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+// One indirect draw per mesh range, or per object when object index can not travel in firstInstance
+void OcclusionCuller::drawRanges(VkCommandBuffer commandBuffer, uint32_t buffer, uint32_t phase, VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t pushOffset){
+    const VkDeviceSize stride = sizeof(VkDrawIndexedIndirectCommand);
+    VkDeviceSize base = VkDeviceSize(phase) * capacity * stride;
+    uint32_t maxDrawCount = std::max(1u, _render->capabilities.maxDrawIndirectCount);
+
+    for (const OcclusionRange& range : bufferRanges[buffer]){
+        Mesh* mesh = meshes[range.mesh];
+        mesh->bind(commandBuffer);
+        MeshQuantization quantization = mesh->quantization();
+        vkCmdPushConstants(commandBuffer, layout, stages, pushOffset, sizeof(quantization), &quantization);
+
+        uint32_t objectBase = 0;
+        vkCmdPushConstants(commandBuffer, layout, stages, pushOffset + sizeof(quantization), sizeof(objectBase), &objectBase);
+        if (multiDraw){
+            for (uint32_t first = 0; first < range.objectCount; first += maxDrawCount){
+                uint32_t drawCount = std::min(maxDrawCount, range.objectCount - first);
+                _render->stats.drawIndexedIndirect(commandBuffer, drawArgs, base + (range.firstObject + first) * stride, drawCount, stride);
+            }
+            continue;
+        }
+        for (uint32_t object = range.firstObject; object < range.firstObject + range.objectCount; object++){
+            if (!firstInstance){
+                objectBase = object;
+                vkCmdPushConstants(commandBuffer, layout, stages, pushOffset + sizeof(quantization), sizeof(objectBase), &objectBase);
+            }
+            _render->stats.drawIndexedIndirect(commandBuffer, drawArgs, base + object * stride, 1, stride);
+        }
+    }
+}
+
+void OcclusionCuller::drawDepth(VkCommandBuffer commandBuffer, uint32_t buffer, const OcclusionCullCommand& command, uint32_t phase){
+    VkClearValue clearValue{};
+    clearValue.depthStencil = {1.0f, 0};
+
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = phase == OCCLUSION_PHASE_EARLY ? clearPass : loadPass;
+    renderPassInfo.framebuffer = depthFramebuffer;
+    renderPassInfo.renderArea.extent = targetExtent;
+    renderPassInfo.clearValueCount = 1;
+    renderPassInfo.pClearValues = &clearValue;
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(targetExtent.width), static_cast<float>(targetExtent.height), 0.0f, 1.0f};
+    VkRect2D scissor{{0, 0}, targetExtent};
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, depthPipeline);
+    _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, depthLayout, 0, 1, &cullSets[buffer], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, depthLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(command.viewProjection), command.viewProjection);
+    drawRanges(commandBuffer, buffer, phase, depthLayout, VK_SHADER_STAGE_VERTEX_BIT, offsetof(OcclusionDepthConstants, quantization));
+
+    vkCmdEndRenderPass(commandBuffer);
+}
+
+void OcclusionCuller::buildPyramid(VkCommandBuffer commandBuffer){
+    _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, downsamplePipeline);
+
+    uint32_t width = targetExtent.width;
+    uint32_t height = targetExtent.height;
+    for (uint32_t level = 0; level < levelCount; level++){
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, downsampleLayout, 0, 1, &levelSets[level], 0, nullptr);
+        _render->stats.dispatch(commandBuffer, (width + OCCLUSION_DOWNSAMPLE_GROUP_SIZE - 1) / OCCLUSION_DOWNSAMPLE_GROUP_SIZE,
+                                (height + OCCLUSION_DOWNSAMPLE_GROUP_SIZE - 1) / OCCLUSION_DOWNSAMPLE_GROUP_SIZE, 1);
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                       0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+}
+
+void OcclusionCuller::cull(VkCommandBuffer commandBuffer, const OcclusionCullCommand& command){
+    uint32_t frame = _render->currentFrame;
+    {
+        // buffer this slot culled last time is retired now, hand it back to game thread
+        std::lock_guard<std::mutex> lock{mutex};
+        if (slotBuffers[frame] != FREE){
+            bufferOwners[slotBuffers[frame]] = FREE;
+        }
+        bufferOwners[command.buffer] = frame;
+        slotBuffers[frame] = command.buffer;
+        readStats(frame);
+    }
+    released.notify_all();
+
+    // swapchain was resized; frames in flight still use old targets, deletion queue keeps them until they retire
+    if (targetExtent.width != _render->extent.width || targetExtent.height != _render->extent.height){
+        destroyTargets();
+        createTargets(_render->extent);
+    }
+
+    uint32_t buffer = command.buffer;
+    visibleBuffer = buffer;
+
+    // no frame in flight uses this buffer's set, its slot retired before game thread got it
+    if (cullSetGenerations[buffer] != targetGeneration){
+        VkDescriptorImageInfo pyramidInfo{sampler, pyramidView, VK_IMAGE_LAYOUT_GENERAL};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = cullSets[buffer];
+        write.dstBinding = 5;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &pyramidInfo;
+        vkUpdateDescriptorSets(_render->device, 1, &write, 0, nullptr);
+        cullSetGenerations[buffer] = targetGeneration;
+    }
+
+    OcclusionFrame* uniform = static_cast<OcclusionFrame*>(frameMapped[buffer]);
+    memcpy(uniform->viewProjection, command.viewProjection, sizeof(uniform->viewProjection));
+    memcpy(uniform->planes, command.planes, sizeof(uniform->planes));
+    memcpy(uniform->cameraPosition, command.cameraPosition, sizeof(command.cameraPosition));
+    uniform->cameraPosition[3] = std::fabs(command.focalLength) * 0.5f * static_cast<float>(targetExtent.height);
+    uniform->extent[0] = static_cast<float>(targetExtent.width);
+    uniform->extent[1] = static_cast<float>(targetExtent.height);
+    uniform->levelCount = levelCount;
+    uniform->objectCount = command.objectCount;
+    uniform->capacity = capacity;
+    uniform->lodThreshold = lodThreshold;
+    uniform->lodHysteresis = lodHysteresis;
+
+    // previous frame's late cull, indirect draws and counters copy are done with shared buffers
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    vkCmdFillBuffer(commandBuffer, counters, 0, OCCLUSION_COUNTERS * sizeof(uint32_t), 0);
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullLayout, 0, 1, &cullSets[buffer], 0, nullptr);
+    dispatchCull(commandBuffer, OCCLUSION_PHASE_EARLY, command.objectCount);
+    drawDepth(commandBuffer, buffer, command, OCCLUSION_PHASE_EARLY);
+
+    buildPyramid(commandBuffer);
+
+    _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullLayout, 0, 1, &cullSets[buffer], 0, nullptr);
+    dispatchCull(commandBuffer, OCCLUSION_PHASE_LATE, command.objectCount);
+    drawDepth(commandBuffer, buffer, command, OCCLUSION_PHASE_LATE);
+
+    VkBufferCopy region{0, 0, OCCLUSION_COUNTERS * sizeof(uint32_t)};
+    vkCmdCopyBuffer(commandBuffer, counters, readbackBuffers[frame], 1, &region);
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    readbackWritten[frame] = true;
+    readbackObjects[frame] = command.objectCount;
+}
+
+void OcclusionCuller::drawVisible(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t pushOffset){
+    if (visibleBuffer == FREE){
+        return;
+    }
+    _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &cullSets[visibleBuffer], 0, nullptr);
+    drawRanges(commandBuffer, visibleBuffer, OCCLUSION_PHASE_VISIBLE, layout, VK_SHADER_STAGE_VERTEX_BIT, pushOffset);
+}
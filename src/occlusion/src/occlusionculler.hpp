@@ -0,0 +1,195 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// Render command type of OcclusionCullCommand
+#define OCCLUSION_CULL_COMMAND 0x0300
+#define OCCLUSION_MAX_OBJECTS (1u << 16)
+#define OCCLUSION_MAX_MESHES 256u
+#define OCCLUSION_MAX_LODS 8u
+#define OCCLUSION_LOD_THRESHOLD 1.0f      // pixels
+#define OCCLUSION_LOD_HYSTERESIS 0.25f
+
+// forward declaration
+class Render;
+class Mesh;
+
+// Object as culling and depth shaders read it (std430)
+struct OcclusionObject {
+    float model[12];        // rows of 3x4 object to world transform
+    float boundsMin[3];     // world space
+    uint32_t mesh;          // OcclusionCuller::addMesh id
+    float boundsMax[3];
+    uint32_t padding;
+};
+static_assert(sizeof(OcclusionObject) == 80, "OcclusionObject must match occlusion shaders");
+
+// Consecutive objects of one mesh, drawn with one indirect call
+struct OcclusionRange {
+    uint16_t mesh;
+    uint32_t firstObject;
+    uint32_t objectCount;
+};
+
+// Game thread -> render thread: cull objects written to buffer
+struct OcclusionCullCommand {
+    uint32_t buffer;
+    uint32_t objectCount;
+    float viewProjection[16];   // column major
+    float planes[6][4];         // Frustum::fromMatrix(viewProjection)
+    float cameraPosition[3];
+    float focalLength;          // projection[1][1], LOD error is projected with it
+};
+
+// Level of detail table entry as cull shader reads it (std430)
+struct OcclusionLod {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;            // mesh units
+    uint32_t levelCount;    // of mesh, same in all its entries
+};
+
+// Results of culling, read back when frame slot retires (a few frames late)
+struct OcclusionStats {
+    uint32_t objects = 0;
+    uint32_t frustumCulled = 0;
+    uint32_t occluded = 0;
+    uint32_t drawnEarly = 0;    // visible last frame, drawn before pyramid was built
+    uint32_t drawnLate = 0;     // passed test against pyramid, were not drawn early
+    uint32_t triangles = 0;     // of drawn objects at selected level of detail
+};
+
+// Two phase hierarchical Z occlusion culling, before render pass:
+//   early cull  - objects visible last frame and inside frustum get indirect draw arguments
+//   early depth - they are drawn into culler's depth target
+//   pyramid     - compute downsample of depth, each texel is max (farthest) of 2x2 below it
+//   late cull   - every object in frustum is tested against pyramid, visibility is stored for next frame
+//   late depth  - newly visible objects are drawn into depth target too
+// Only last frame's visible set occludes in late cull, but anything that became visible is
+// still drawn in the same frame, so depth never misses a visible object.
+// Both cull phases also select level of detail per object: coarsest level whose error, projected
+// to screen, is under threshold. Moving to a coarser level needs error below threshold * (1 - hysteresis),
+// so objects near a switch distance do not pop back and forth. Level is kept with visibility.
+// drawVisible() then draws the visible set inside render pass with caller's pipeline.
+// Object buffers are persistently mapped and written by game thread, one more than frames in flight.
+class OcclusionCuller {
+private:
+    static constexpr uint32_t FREE = UINT32_MAX;
+    static constexpr uint32_t WRITING = UINT32_MAX - 1;
+
+    Render* _render;
+    uint32_t capacity;
+    bool firstInstance;     // object index travels in firstInstance, else one draw per object
+    bool multiDraw;         // one indirect call per mesh range
+    float lodThreshold = OCCLUSION_LOD_THRESHOLD;
+    float lodHysteresis = OCCLUSION_LOD_HYSTERESIS;
+
+    std::vector<Mesh*> meshes{};
+    std::vector<OcclusionLod> lods{};
+
+    // depth target and pyramid, sized to swapchain extent
+    VkExtent2D targetExtent{};
+    uint32_t levelCount = 0;
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+    VkImageView depthView = VK_NULL_HANDLE;
+    VkFramebuffer depthFramebuffer = VK_NULL_HANDLE;
+    VkImage pyramidImage = VK_NULL_HANDLE;
+    VkDeviceMemory pyramidMemory = VK_NULL_HANDLE;
+    VkImageView pyramidView = VK_NULL_HANDLE;               // all levels, sampled by cull
+    std::vector<VkImageView> pyramidLevelViews{};           // one level each, downsample
+    VkRenderPass clearPass = VK_NULL_HANDLE;                // early depth
+    VkRenderPass loadPass = VK_NULL_HANDLE;                 // late depth
+    VkSampler sampler = VK_NULL_HANDLE;
+
+    // GPU only state
+    VkBuffer visibility = VK_NULL_HANDLE;       // uint per object, written by late cull: bit 0 visible, level from bit 8
+    VkBuffer lodTable = VK_NULL_HANDLE;         // OCCLUSION_MAX_LODS levels per mesh
+    VkBuffer drawArgs = VK_NULL_HANDLE;         // early, late and visible VkDrawIndexedIndirectCommand arrays
+    VkBuffer counters = VK_NULL_HANDLE;
+    std::vector<VkDeviceMemory> memories{};
+
+    // per object buffer, persistently mapped
+    std::vector<VkBuffer> objectBuffers{};
+    std::vector<VkBuffer> frameBuffers{};
+    std::vector<VkDeviceMemory> objectMemories{};
+    std::vector<OcclusionObject*> objectMapped{};
+    std::vector<void*> frameMapped{};                       // OcclusionFrame uniform
+    std::vector<std::vector<OcclusionRange>> bufferRanges{};
+
+    // per frame slot, counters copied here at end of cull
+    std::vector<VkBuffer> readbackBuffers{};
+    std::vector<VkDeviceMemory> readbackMemories{};
+    std::vector<uint32_t*> readbackMapped{};
+    std::vector<bool> readbackWritten{};
+    std::vector<uint32_t> readbackObjects{};
+
+    // ownership, guarded by mutex: FREE, WRITING or frame slot culling with buffer
+    std::mutex mutex;
+    std::condition_variable released;
+    std::vector<uint32_t> bufferOwners{};
+    std::vector<uint32_t> slotBuffers{};
+    OcclusionStats lastStats{};
+
+    VkDescriptorSetLayout cullSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout downsampleSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorPool levelPool = VK_NULL_HANDLE;            // recreated with pyramid
+    std::vector<VkDescriptorSet> cullSets{};                // per object buffer
+    std::vector<VkDescriptorSet> levelSets{};               // per pyramid level
+    uint32_t targetGeneration = 0;                          // incremented when pyramid is recreated
+    std::vector<uint32_t> cullSetGenerations{};             // pyramid each cull set samples, rewritten when buffer is next culled
+    VkPipelineLayout cullLayout = VK_NULL_HANDLE;
+    VkPipelineLayout downsampleLayout = VK_NULL_HANDLE;
+    VkPipelineLayout depthLayout = VK_NULL_HANDLE;
+    VkPipeline cullPipeline = VK_NULL_HANDLE;
+    VkPipeline downsamplePipeline = VK_NULL_HANDLE;
+    VkPipeline depthPipeline = VK_NULL_HANDLE;
+    uint32_t visibleBuffer = FREE;                          // object buffer of last cull, drawVisible reads it
+
+    VkBuffer createStorage(VkDeviceSize size, VkBufferUsageFlags usage);
+    void createRenderPasses();
+    void createDescriptors();
+    void createPipelines();
+    void createTargets(VkExtent2D extent);
+    void destroyTargets();
+
+    void readStats(uint32_t frame);
+    void dispatchCull(VkCommandBuffer commandBuffer, uint32_t phase, uint32_t objectCount);
+    void drawDepth(VkCommandBuffer commandBuffer, uint32_t buffer, const OcclusionCullCommand& command, uint32_t phase);
+    void drawRanges(VkCommandBuffer commandBuffer, uint32_t buffer, uint32_t phase, VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t pushOffset);
+    void buildPyramid(VkCommandBuffer commandBuffer);
+    void cull(VkCommandBuffer commandBuffer, const OcclusionCullCommand& command);
+
+public:
+    OcclusionCuller(Render* render, uint32_t maxObjects = OCCLUSION_MAX_OBJECTS);
+    ~OcclusionCuller();
+
+    uint32_t maxObjects() const { return capacity; }
+
+    // Mesh must outlive culler, returns id used by objects. Uploads its level table, call before frames are in flight.
+    uint16_t addMesh(Mesh* mesh);
+    Mesh* mesh(uint16_t id) const { return meshes[id]; }
+    uint32_t meshCount() const { return static_cast<uint32_t>(meshes.size()); }
+
+    // Game thread: waits for free object buffer
+    uint32_t acquire();
+    OcclusionObject* objects(uint32_t buffer) { return objectMapped[buffer]; }
+    std::vector<OcclusionRange>& ranges(uint32_t buffer) { return bufferRanges[buffer]; }
+
+    // Inside render pass, after cull command of this frame: visible objects with bound pipeline.
+    // Set 0 of layout must be objectSetLayout(); vertex push constants at pushOffset are
+    // MeshQuantization, then uint object base: object index is gl_InstanceIndex + base.
+    void drawVisible(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t pushOffset);
+    VkDescriptorSetLayout objectSetLayout() const { return cullSetLayout; }
+
+    // pixels of projected error allowed, fraction of threshold needed to switch to coarser level
+    void setLodThreshold(float pixels, float hysteresis = OCCLUSION_LOD_HYSTERESIS) { lodThreshold = pixels; lodHysteresis = hysteresis; }
+
+    // Any thread
+    OcclusionStats stats();
+};
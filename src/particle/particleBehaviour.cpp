@@ -0,0 +1,92 @@
+#include "particleBehaviour.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+void ParticleBehaviour::init(){
+    emitters.reserve(64);
+    std::cout << "Particles: up to " << PARTICLE_MAX_EMITTERS << " emitters" << std::endl;
+}
+
+void ParticleBehaviour::update(){
+}
+
+void ParticleBehaviour::add(EmitterPart* component){
+    add(creatures->create(), *component);
+}
+
+EmitterPart& ParticleBehaviour::add(Creature creature, const EmitterPart& emitter){
+    if (!emitters.contains(creature) && emitters.size() == PARTICLE_MAX_EMITTERS){
+        throw std::runtime_error("Too many particle emitters");
+    }
+    return emitters.add(creature, emitter);
+}
+
+void ParticleBehaviour::remove(Creature creature){
+    emitters.remove(creature);
+}
+
+EmitterPart* ParticleBehaviour::get(Creature creature){
+    if (!creatures->alive(creature)){
+        return nullptr;
+    }
+    return emitters.get(creature);
+}
+
+void ParticleBehaviour::setView(const float view[16], const float projection[16]){
+    // viewProjection = projection * view
+    for (uint32_t column = 0; column < 4; column++){
+        for (uint32_t row = 0; row < 4; row++){
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < 4; i++){
+                sum += projection[i * 4 + row] * view[column * 4 + i];
+            }
+            frame.viewProjection[column * 4 + row] = sum;
+        }
+    }
+
+    // rows of view rotation are camera axes, position is -R^T * translation
+    for (uint32_t axis = 0; axis < 3; axis++){
+        frame.cameraRight[axis] = view[axis * 4 + 0];
+        frame.cameraUp[axis] = view[axis * 4 + 1];
+        frame.cameraPosition[axis] = -(view[axis * 4 + 0] * view[12] + view[axis * 4 + 1] * view[13] + view[axis * 4 + 2] * view[14]);
+    }
+}
+
+void ParticleBehaviour::submit(RenderCommandBuffer& commands, float dt){
+    if (particles == nullptr){
+        return;
+    }
+
+    for (EmitterPart& part : emitters){
+        part.pending += part.rate * dt;
+        float count = std::floor(part.pending);
+        if (count < 1.0f){
+            continue;
+        }
+        part.pending -= count;
+
+        ParticleEmitter emitter{};
+        for (uint32_t i = 0; i < 3; i++){
+            emitter.position[i] = part.position[i];
+            emitter.velocity[i] = part.velocity[i];
+        }
+        emitter.position[3] = part.radius;
+        emitter.velocity[3] = part.spread;
+        emitter.lifetime[0] = part.lifetime[0];
+        emitter.lifetime[1] = part.lifetime[1];
+        emitter.size[0] = part.size[0];
+        emitter.size[1] = part.size[1];
+        emitter.color[0] = part.color[0];
+        emitter.color[1] = part.color[1];
+        emitter.drag = part.drag;
+        emitter.gravity = part.gravity;
+        emitter.emitCount = static_cast<uint32_t>(std::min(count, static_cast<float>(particles->maxParticles())));
+        emitter.seed = ++seed;
+        commands.push(PARTICLE_EMITTER_COMMAND, emitter);
+    }
+
+    frame.cameraPosition[3] = dt;
+    commands.push(PARTICLE_FRAME_COMMAND, frame);
+}
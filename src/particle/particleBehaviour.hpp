@@ -0,0 +1,56 @@
+#pragma once
+
+#include <System.hpp>
+#include <Creature.hpp>
+#include <SparseSet.hpp>
+#include "src/particlesystem.hpp"
+#include "../graphics/src/commandstream.hpp"
+
+// Emitter attached to creature, spawns rate particles per second
+class EmitterPart {
+public:
+    float position[3]{};
+    float radius = 0.0f;        // spawn sphere
+    float velocity[3]{};
+    float spread = 0.0f;        // random speed in random direction
+    float lifetime[2]{1.0f, 1.0f};
+    float size[2]{0.1f, 0.1f};  // start, end
+    uint32_t color[2]{0xffffffffu, 0x00ffffffu};
+    float drag = 0.0f;
+    float gravity = 1.0f;
+    float rate = 0.0f;
+    float pending = 0.0f;       // fraction of particle carried to next frame
+};
+
+// Particle emitters of creatures. Simulation lives on GPU (ParticleSystem), so per frame CPU cost
+// is one small command per active emitter, independent of particle count.
+class ParticleBehaviour : public System<EmitterPart> {
+private:
+    CreatureRegistry<>* creatures;
+    ParticleSystem* particles = nullptr;
+    SparseSet<EmitterPart> emitters{};
+    ParticleFrame frame{};
+    uint32_t seed = 0;
+
+public:
+    ParticleBehaviour(CreatureRegistry<>* creatures) : creatures(creatures) { frame.gravity[1] = -9.81f; }
+
+    void init();
+    void update();
+
+    // Part without creature, gets a new creature from registry
+    void add(EmitterPart* component);
+    EmitterPart& add(Creature creature, const EmitterPart& emitter);
+    void remove(Creature creature);
+    EmitterPart* get(Creature creature);
+
+    void setRenderer(ParticleSystem* particleSystem) { particles = particleSystem; }
+    // column major matrices, camera basis for billboards comes from view
+    void setView(const float view[16], const float projection[16]);
+    void setGravity(float x, float y, float z) { frame.gravity[0] = x; frame.gravity[1] = y; frame.gravity[2] = z; }
+
+    // Game thread, once per rendered frame: emitter commands, then frame command that simulates dt seconds
+    void submit(RenderCommandBuffer& commands, float dt);
+
+    size_t size() const { return emitters.size(); }
+};
@@ -0,0 +1,471 @@
+#include "particlesystem.hpp"
+#include "../../graphics/src/render.hpp"
+#include "../../graphics/src/pipeline/shader.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+#include <string>
+
+// entries one sort group holds in shared memory
+#define PARTICLE_SORT_LOCAL_SIZE 512
+
+// Byte offsets of indirect arguments in counters buffer, must match particle shaders
+#define PARTICLE_EMIT_ARGS 32
+#define PARTICLE_SIMULATE_ARGS 44
+#define PARTICLE_SORT_ARGS 56     // both sort kernels: 512 entries per group
+#define PARTICLE_DRAW_ARGS 68
+#define PARTICLE_ARGS_SIZE 84
+
+#define PARTICLE_BINDINGS 9
+
+struct ParticleSortEntry {
+    float key;
+    uint32_t index;
+};
+
+ParticleSystem::ParticleSystem(Render* render, uint32_t maxParticles, ParticleBlend blend) : blend(blend){
+    std::cout << "Creating particle system" << std::endl;
+
+    _render = render;
+    capacity = maxParticles;
+    sortCapacity = PARTICLE_SORT_LOCAL_SIZE;
+    while (sortCapacity < capacity){
+        sortCapacity *= 2;
+    }
+
+    VkBufferUsageFlags storage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    positions = createStorage(VkDeviceSize(capacity) * 4 * sizeof(float), storage);
+    velocities = createStorage(VkDeviceSize(capacity) * 4 * sizeof(float), storage);
+    appearance = createStorage(VkDeviceSize(capacity) * 4 * sizeof(uint32_t), storage);
+    deadList = createStorage(VkDeviceSize(capacity) * sizeof(uint32_t), storage | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    aliveLists = createStorage(VkDeviceSize(capacity) * 2 * sizeof(uint32_t), storage);
+    counters = createStorage(PARTICLE_ARGS_SIZE, storage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    sortEntries = createStorage(VkDeviceSize(sortCapacity) * sizeof(ParticleSortEntry), storage);
+
+    frameBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    emitterBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    frameMemories.resize(MAX_FRAMES_IN_FLIGHT * 2);
+    frameMapped.resize(MAX_FRAMES_IN_FLIGHT);
+    emitterMapped.resize(MAX_FRAMES_IN_FLIGHT);
+    emitterCounts.assign(MAX_FRAMES_IN_FLIGHT, 0);
+    VkMemoryPropertyFlags mappable = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        render->createBuffer(sizeof(ParticleFrame), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, mappable,
+                             &frameBuffers[i], &frameMemories[i * 2], true);
+        render->createBuffer(PARTICLE_MAX_EMITTERS * sizeof(ParticleEmitter), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, mappable,
+                             &emitterBuffers[i], &frameMemories[i * 2 + 1], true);
+        void* mapped;
+        vkMapMemory(render->device, frameMemories[i * 2], 0, sizeof(ParticleFrame), 0, &mapped);
+        frameMapped[i] = static_cast<ParticleFrame*>(mapped);
+        vkMapMemory(render->device, frameMemories[i * 2 + 1], 0, PARTICLE_MAX_EMITTERS * sizeof(ParticleEmitter), 0, &mapped);
+        emitterMapped[i] = static_cast<ParticleEmitter*>(mapped);
+    }
+
+    createDescriptors();
+    createPipelines();
+    reset();
+
+    // emitters are collected into frame slot's buffer, frame command simulates before and draws inside render pass
+    render->registerPrePassCommand(PARTICLE_EMITTER_COMMAND, [this](VkCommandBuffer, const void* payload){
+        ParticleEmitter emitter;
+        memcpy(&emitter, payload, sizeof(emitter));
+        addEmitter(emitter);
+    });
+    render->registerPrePassCommand(PARTICLE_FRAME_COMMAND, [this](VkCommandBuffer commandBuffer, const void* payload){
+        ParticleFrame frame;
+        memcpy(&frame, payload, sizeof(frame));
+        if (_render->asyncCompute == nullptr){
+            simulate(commandBuffer, frame, true);
+            return;
+        }
+        // overlaps graphics until draw: waits for last frame's draw of buffers it rewrites
+        _render->asyncCompute->schedule(_render->currentFrame, commandBuffer,
+            [this, &frame](VkCommandBuffer computeCommands, bool graphicsStages){ simulate(computeCommands, frame, graphicsStages); },
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+    });
+    render->registerCommand(PARTICLE_FRAME_COMMAND, [this](VkCommandBuffer commandBuffer, const void*){
+        draw(commandBuffer);
+    });
+
+    std::cout << "\tParticles: " << capacity << ", sort size: " << sortCapacity
+              << (blend == ParticleBlend::ALPHA ? " (sorted alpha blend)" : " (additive, unsorted)") << std::endl;
+    std::cout << "Particle system created successfully" << std::endl << std::endl;
+}
+
+VkBuffer ParticleSystem::createStorage(VkDeviceSize size, VkBufferUsageFlags usage){
+    VkBuffer buffer;
+    VkDeviceMemory memory;
+    _render->createBuffer(size, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &buffer, &memory, true);
+    memories.push_back(memory);
+    return buffer;
+}
+
+void ParticleSystem::createDescriptors(){
+    // 0 frame, 1 emitters, 2 positions, 3 velocities, 4 appearance, 5 dead, 6 alive, 7 counters, 8 sort
+    VkDescriptorSetLayoutBinding bindings[PARTICLE_BINDINGS]{};
+    for (uint32_t i = 0; i < PARTICLE_BINDINGS; i++){
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.bindingCount = PARTICLE_BINDINGS;
+    layoutCreateInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(_render->device, &layoutCreateInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create particle descriptor set layout");
+    }
+
+    VkDescriptorPoolSize poolSizes[2]{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[0].descriptorCount = MAX_FRAMES_IN_FLIGHT;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = (PARTICLE_BINDINGS - 1) * MAX_FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo{};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    poolCreateInfo.poolSizeCount = 2;
+    poolCreateInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(_render->device, &poolCreateInfo, nullptr, &descriptorPool) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create particle descriptor pool");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
+    descriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = descriptorPool;
+    allocateInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    allocateInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(_render->device, &allocateInfo, descriptorSets.data()) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate particle descriptor sets");
+    }
+
+    // only frame uniform and emitters differ between slots
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; frame++){
+        VkDescriptorBufferInfo bufferInfos[PARTICLE_BINDINGS]{
+            {frameBuffers[frame], 0, VK_WHOLE_SIZE},
+            {emitterBuffers[frame], 0, VK_WHOLE_SIZE},
+            {positions, 0, VK_WHOLE_SIZE},
+            {velocities, 0, VK_WHOLE_SIZE},
+            {appearance, 0, VK_WHOLE_SIZE},
+            {deadList, 0, VK_WHOLE_SIZE},
+            {aliveLists, 0, VK_WHOLE_SIZE},
+            {counters, 0, VK_WHOLE_SIZE},
+            {sortEntries, 0, VK_WHOLE_SIZE},
+        };
+        VkWriteDescriptorSet writes[PARTICLE_BINDINGS]{};
+        for (uint32_t i = 0; i < PARTICLE_BINDINGS; i++){
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = descriptorSets[frame];
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = bindings[i].descriptorType;
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets(_render->device, PARTICLE_BINDINGS, writes, 0, nullptr);
+    }
+}
+
+VkPipeline ParticleSystem::createComputePipeline(const char* path){
+    Shader shader{_render, path, ShaderType::COMPUTE};
+
+    // SORTED, kernels without the constant ignore it
+    VkBool32 sorted = blend == ParticleBlend::ALPHA ? VK_TRUE : VK_FALSE;
+    VkSpecializationMapEntry specializationEntry{0, 0, sizeof(VkBool32)};
+    VkSpecializationInfo specialization{};
+    specialization.mapEntryCount = 1;
+    specialization.pMapEntries = &specializationEntry;
+    specialization.dataSize = sizeof(VkBool32);
+    specialization.pData = &sorted;
+
+    VkComputePipelineCreateInfo pipelineCreateInfo{};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCreateInfo.stage.stage = shader.bits;
+    pipelineCreateInfo.stage.module = shader.shadermodule;
+    pipelineCreateInfo.stage.pName = "main";
+    pipelineCreateInfo.stage.pSpecializationInfo = &specialization;
+    pipelineCreateInfo.layout = pipelineLayout;
+
+    VkPipeline computePipeline;
+    VkResult result = vkCreateComputePipelines(_render->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &computePipeline);
+    shader.cleanup();
+    if (result != VK_SUCCESS){
+        throw std::runtime_error(std::string("Failed to create particle pipeline ") + path);
+    }
+    return computePipeline;
+}
+
+void ParticleSystem::createPipelines(){
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PassConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(_render->device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create particle pipeline layout");
+    }
+
+    beginPipeline = createComputePipeline("shaders/particle_begin.comp.spv");
+    emitPipeline = createComputePipeline("shaders/particle_emit.comp.spv");
+    simulatePipeline = createComputePipeline("shaders/particle_simulate.comp.spv");
+    finishPipeline = createComputePipeline("shaders/particle_finish.comp.spv");
+    if (blend == ParticleBlend::ALPHA){
+        sortPipeline = createComputePipeline("shaders/particle_sort.comp.spv");
+        sortLocalPipeline = createComputePipeline("shaders/particle_sort_local.comp.spv");
+    }
+
+    Shader vertexShader{_render, "shaders/particle.vert.spv", ShaderType::VERTEX};
+    Shader fragmentShader{_render, "shaders/particle.frag.spv", ShaderType::FRAGMENT};
+
+    // sorted: instance reads sort entries instead of alive list
+    VkBool32 sorted = blend == ParticleBlend::ALPHA ? VK_TRUE : VK_FALSE;
+    VkSpecializationMapEntry specializationEntry{0, 0, sizeof(VkBool32)};
+    VkSpecializationInfo specialization{};
+    specialization.mapEntryCount = 1;
+    specialization.pMapEntries = &specializationEntry;
+    specialization.dataSize = sizeof(VkBool32);
+    specialization.pData = &sorted;
+
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = vertexShader.bits;
+    stages[0].module = vertexShader.shadermodule;
+    stages[0].pName = "main";
+    stages[0].pSpecializationInfo = &specialization;
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = fragmentShader.bits;
+    stages[1].module = fragmentShader.shadermodule;
+    stages[1].pName = "main";
+
+    // everything is read from storage buffers
+    VkPipelineVertexInputStateCreateInfo vertexInputState{};
+    vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState{};
+    inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkDynamicState dynamicStateList[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStateList;
+
+    VkPipelineRasterizationStateCreateInfo rasterizationState{};
+    rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizationState.cullMode = VK_CULL_MODE_NONE;
+    rasterizationState.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterizationState.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampleState{};
+    multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState blendAttachment{};
+    blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    blendAttachment.blendEnable = VK_TRUE;
+    blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blendAttachment.dstColorBlendFactor = blend == ParticleBlend::ADDITIVE ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo blendState{};
+    blendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    blendState.attachmentCount = 1;
+    blendState.pAttachments = &blendAttachment;
+
+    VkGraphicsPipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    createInfo.stageCount = 2;
+    createInfo.pStages = stages;
+    createInfo.pVertexInputState = &vertexInputState;
+    createInfo.pInputAssemblyState = &inputAssemblyState;
+    createInfo.pViewportState = &viewportState;
+    createInfo.pRasterizationState = &rasterizationState;
+    createInfo.pMultisampleState = &multisampleState;
+    createInfo.pColorBlendState = &blendState;
+    createInfo.pDynamicState = &dynamicState;
+    createInfo.layout = pipelineLayout;
+    createInfo.renderPass = _render->renderpass;
+    createInfo.subpass = 0;
+    createInfo.basePipelineIndex = -1;
+
+    VkResult result = vkCreateGraphicsPipelines(_render->device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &drawPipeline);
+    vertexShader.cleanup();
+    fragmentShader.cleanup();
+    if (result != VK_SUCCESS){
+        throw std::runtime_error("Failed to create particle draw pipeline");
+    }
+}
+
+// Every particle dead: dead stack holds all indices, both alive lists are empty
+void ParticleSystem::reset(){
+    std::vector<uint32_t> indices(capacity);
+    for (uint32_t i = 0; i < capacity; i++){
+        indices[i] = capacity - 1 - i;
+    }
+    _render->uploadBuffer(deadList, indices.data(), VkDeviceSize(capacity) * sizeof(uint32_t));
+
+    // indirect dispatches need y = z = 1, draw has 4 vertices per instance
+    uint32_t args[PARTICLE_ARGS_SIZE / sizeof(uint32_t)]{};
+    args[0] = capacity;
+    for (uint32_t offset : {PARTICLE_EMIT_ARGS, PARTICLE_SIMULATE_ARGS, PARTICLE_SORT_ARGS}){
+        args[offset / sizeof(uint32_t) + 1] = 1;
+        args[offset / sizeof(uint32_t) + 2] = 1;
+    }
+    args[PARTICLE_DRAW_ARGS / sizeof(uint32_t)] = 4;
+    _render->uploadBuffer(counters, args, sizeof(args));
+    current = 0;
+}
+
+ParticleSystem::~ParticleSystem(){
+    VkDevice device = _render->device;
+
+    _render->prePassHandlers.erase(PARTICLE_EMITTER_COMMAND);
+    _render->prePassHandlers.erase(PARTICLE_FRAME_COMMAND);
+    _render->commandHandlers.erase(PARTICLE_FRAME_COMMAND);
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+        vkUnmapMemory(device, frameMemories[i * 2]);
+        vkUnmapMemory(device, frameMemories[i * 2 + 1]);
+        vkDestroyBuffer(device, frameBuffers[i], nullptr);
+        vkDestroyBuffer(device, emitterBuffers[i], nullptr);
+    }
+    for (VkDeviceMemory memory : frameMemories){
+        vkFreeMemory(device, memory, nullptr);
+    }
+
+    for (VkBuffer buffer : {positions, velocities, appearance, deadList, aliveLists, counters, sortEntries}){
+        vkDestroyBuffer(device, buffer, nullptr);
+    }
+    for (VkDeviceMemory memory : memories){
+        vkFreeMemory(device, memory, nullptr);
+    }
+
+    for (VkPipeline pipeline : {beginPipeline, emitPipeline, simulatePipeline, finishPipeline, sortPipeline, sortLocalPipeline, drawPipeline}){
+        vkDestroyPipeline(device, pipeline, nullptr);
+    }
+    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+}
+
+// Slot's emitter buffer is not read by GPU anymore, its fence was waited on
+void ParticleSystem::addEmitter(const ParticleEmitter& emitter){
+    uint32_t frame = _render->currentFrame;
+    if (emitterCounts[frame] == PARTICLE_MAX_EMITTERS || emitter.emitCount == 0){
+        return;
+    }
+    emitterMapped[frame][emitterCounts[frame]++] = emitter;
+}
+
+// Writes of previous kernel visible to next kernel and to indirect argument reads
+static void computeBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags dstStage){
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void ParticleSystem::dispatch(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkDeviceSize argsOffset, const PassConstants& constants){
+    _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    // offset 0 are counters, not arguments: single thread kernel
+    if (argsOffset == 0){
+        _render->stats.dispatch(commandBuffer, 1, 1, 1);
+    } else {
+        _render->stats.dispatchIndirect(commandBuffer, counters, argsOffset);
+    }
+    computeBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+}
+
+void ParticleSystem::simulate(VkCommandBuffer commandBuffer, const ParticleFrame& command, bool graphicsStages){
+    uint32_t frame = _render->currentFrame;
+
+    // emission offsets, GPU finds emitter of particle by binary search over firstEmit
+    ParticleEmitter* emitters = emitterMapped[frame];
+    uint32_t totalEmit = 0;
+    for (uint32_t i = 0; i < emitterCounts[frame]; i++){
+        emitters[i].firstEmit = totalEmit;
+        totalEmit += emitters[i].emitCount;
+    }
+
+    ParticleFrame* uniform = frameMapped[frame];
+    *uniform = command;
+    uniform->emitterCount = emitterCounts[frame];
+    uniform->totalEmit = totalEmit;
+    uniform->seed = ++seed;
+    uniform->capacity = capacity;
+    emitterCounts[frame] = 0;
+
+    // previous frame drew from and simulated into buffers this frame rewrites
+    // (on compute family the draw is covered by semaphore wait of AsyncCompute::schedule)
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    VkPipelineStageFlags previousStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    if (graphicsStages){
+        previousStages |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+    }
+    _render->stats.pipelineBarrier(commandBuffer, previousStages, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSets[frame], 0, nullptr);
+
+    PassConstants constants{current, 0, 0, 0};
+    dispatch(commandBuffer, beginPipeline, 0, constants);
+    dispatch(commandBuffer, emitPipeline, PARTICLE_EMIT_ARGS, constants);
+    dispatch(commandBuffer, simulatePipeline, PARTICLE_SIMULATE_ARGS, constants);
+    dispatch(commandBuffer, finishPipeline, 0, constants);
+
+    if (blend == ParticleBlend::ALPHA){
+        // Bitonic sort of sortCapacity entries, entries past alive count act as +inf.
+        // Steps with compare distance below 512 run in shared memory, one dispatch for all of them;
+        // k = 0 sorts each 512 block completely.
+        dispatch(commandBuffer, sortLocalPipeline, PARTICLE_SORT_ARGS, {current, 0, 0, 0});
+        for (uint32_t k = PARTICLE_SORT_LOCAL_SIZE * 2; k <= sortCapacity; k *= 2){
+            dispatch(commandBuffer, sortPipeline, PARTICLE_SORT_ARGS, {current, k, k / 2, 1});
+            for (uint32_t j = k / 4; j >= PARTICLE_SORT_LOCAL_SIZE; j /= 2){
+                dispatch(commandBuffer, sortPipeline, PARTICLE_SORT_ARGS, {current, k, j, 0});
+            }
+            dispatch(commandBuffer, sortLocalPipeline, PARTICLE_SORT_ARGS, {current, k, 0, 0});
+        }
+    }
+
+    // survivors were compacted into other list, it is drawn now and simulated next frame
+    current ^= 1;
+    if (graphicsStages){
+        computeBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+    }
+}
+
+void ParticleSystem::draw(VkCommandBuffer commandBuffer){
+    uint32_t frame = _render->currentFrame;
+    PassConstants constants{current, 0, 0, 0};
+
+    _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawPipeline);
+    _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets[frame], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    _render->stats.drawIndirect(commandBuffer, counters, PARTICLE_DRAW_ARGS, 1, 0);
+}
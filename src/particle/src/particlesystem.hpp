@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+// Render command types: emitters of frame, then one frame command that simulates and draws them
+#define PARTICLE_EMITTER_COMMAND 0x0200
+#define PARTICLE_FRAME_COMMAND 0x0201
+#define PARTICLE_MAX_EMITTERS 1024u
+
+// forward declaration
+class Render;
+
+enum class ParticleBlend : uint8_t {
+    ADDITIVE,   // order independent, not sorted
+    ALPHA       // sorted back to front on GPU
+};
+
+// Emitter parameters as shaders read them (std430), uploaded every frame
+struct ParticleEmitter {
+    float position[4];      // xyz, w: spawn sphere radius
+    float velocity[4];      // xyz, w: random speed added in random direction
+    float lifetime[2];      // min, max seconds
+    float size[2];          // start, end
+    uint32_t color[2];      // start, end, 0xAABBGGRR
+    float drag;             // velocity lost per second, fraction
+    float gravity;          // scale of ParticleFrame::gravity
+    uint32_t emitCount;     // particles spawned this frame
+    uint32_t firstEmit;     // prefix sum of emitCount, filled by ParticleSystem
+    uint32_t seed;
+    uint32_t padding;
+};
+static_assert(sizeof(ParticleEmitter) == 80, "ParticleEmitter must match particle shaders");
+
+// Per frame uniform (std140)
+struct ParticleFrame {
+    float viewProjection[16];   // column major
+    float cameraPosition[4];    // w: delta time
+    float cameraRight[4];
+    float cameraUp[4];
+    float gravity[4];
+    uint32_t emitterCount;      // filled by ParticleSystem
+    uint32_t totalEmit;         // filled by ParticleSystem
+    uint32_t seed;              // filled by ParticleSystem
+    uint32_t capacity;          // filled by ParticleSystem
+};
+
+// Particles that live entirely on GPU. State is SoA storage buffers (position + age,
+// velocity + lifetime, packed appearance), a dead index stack and two alive lists.
+// Every frame, in compute before render pass:
+//   begin    - clamps emission to free particles, writes indirect dispatch sizes
+//   emit     - pops dead indices, initializes particles from emitters, appends them to alive list
+//   simulate - integrates alive list; dead ones go back to stack, live ones are compacted into other list
+//   finish   - indirect draw and sort dispatch sizes from new alive count
+//   sort     - bitonic sort back to front (ALPHA only)
+// then one indirect draw of instanced quads. CPU only uploads emitters and camera.
+// Compute runs on Render::asyncCompute: it waits for previous frame's draw, the draw waits for it.
+class ParticleSystem {
+private:
+    // push constants of every kernel and of draw
+    struct PassConstants {
+        uint32_t list;      // alive list read (compute) or drawn
+        uint32_t k;         // bitonic block size
+        uint32_t j;         // bitonic compare distance
+        uint32_t flip;      // 1: flip step, 0: disperse step
+    };
+
+    Render* _render;
+    uint32_t capacity;
+    uint32_t sortCapacity;      // capacity rounded up to power of two
+    ParticleBlend blend;
+    uint32_t current = 0;       // alive list simulated next, the other one was drawn last
+    uint32_t seed = 0;
+
+    VkBuffer positions = VK_NULL_HANDLE;
+    VkBuffer velocities = VK_NULL_HANDLE;
+    VkBuffer appearance = VK_NULL_HANDLE;
+    VkBuffer deadList = VK_NULL_HANDLE;
+    VkBuffer aliveLists = VK_NULL_HANDLE;
+    VkBuffer counters = VK_NULL_HANDLE;    // counters + indirect arguments
+    VkBuffer sortEntries = VK_NULL_HANDLE;
+    std::vector<VkDeviceMemory> memories{};
+
+    // per frame slot, persistently mapped
+    std::vector<VkBuffer> frameBuffers{};
+    std::vector<VkBuffer> emitterBuffers{};
+    std::vector<VkDeviceMemory> frameMemories{};
+    std::vector<ParticleFrame*> frameMapped{};
+    std::vector<ParticleEmitter*> emitterMapped{};
+    std::vector<uint32_t> emitterCounts{};
+
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets{};
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline beginPipeline = VK_NULL_HANDLE;
+    VkPipeline emitPipeline = VK_NULL_HANDLE;
+    VkPipeline simulatePipeline = VK_NULL_HANDLE;
+    VkPipeline finishPipeline = VK_NULL_HANDLE;
+    VkPipeline sortPipeline = VK_NULL_HANDLE;
+    VkPipeline sortLocalPipeline = VK_NULL_HANDLE;
+    VkPipeline drawPipeline = VK_NULL_HANDLE;
+
+    VkBuffer createStorage(VkDeviceSize size, VkBufferUsageFlags usage);
+    void createDescriptors();
+    void createPipelines();
+    VkPipeline createComputePipeline(const char* path);
+    void reset();
+    void dispatch(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkDeviceSize argsOffset, const PassConstants& constants);
+
+    void addEmitter(const ParticleEmitter& emitter);
+    // graphicsStages: false on compute queue family, cross queue dependencies are semaphores there
+    void simulate(VkCommandBuffer commandBuffer, const ParticleFrame& frame, bool graphicsStages);
+    void draw(VkCommandBuffer commandBuffer);
+
+public:
+    ParticleSystem(Render* render, uint32_t maxParticles, ParticleBlend blend = ParticleBlend::ADDITIVE);
+    ~ParticleSystem();
+
+    uint32_t maxParticles() const { return capacity; }
+};
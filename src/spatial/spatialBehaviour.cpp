@@ -0,0 +1,115 @@
+#include "spatialBehaviour.hpp"
+#include <iostream>
+#include <algorithm>
+#include "../memory/src/allocationtracker.hpp"
+
+void SpatialBehaviour::init(){
+    std::cout << "Spatial index: " << spatialSimdPath() << " culling" << std::endl;
+}
+
+bool SpatialBehaviour::needsRebuild() const {
+    uint32_t built = static_cast<uint32_t>(objects.size() - pending.size());
+    if (bvh.empty()){
+        return !pending.empty();
+    }
+    return pending.size() > std::max<size_t>(64, built / 16)
+        || removedSinceBuild > std::max<uint32_t>(64, built / 4)
+        || bvh.quality() > SPATIAL_REBUILD_QUALITY;
+}
+
+void SpatialBehaviour::update(){
+    MemoryTagScope tag{MemoryTag::ECS};
+    bvh.refit();
+    if (needsRebuild()){
+        rebuild();
+    }
+}
+
+void SpatialBehaviour::add(SpatialPart* component){
+    add(component->creature, component->bounds);
+}
+
+void SpatialBehaviour::add(Creature creature, const Aabb& bounds){
+    if (objects.contains(creature)){
+        move(creature, bounds);
+        return;
+    }
+    objects.add(creature, SpatialObject{bounds, BVH_INVALID});
+    pending.push_back(creature);
+}
+
+void SpatialBehaviour::move(Creature creature, const Aabb& bounds){
+    SpatialObject* object = objects.get(creature);
+    if (object == nullptr){
+        return;
+    }
+    object->bounds = bounds;
+    if (object->slot != BVH_INVALID){
+        bvh.update(object->slot, bounds);
+    }
+}
+
+void SpatialBehaviour::remove(Creature creature){
+    SpatialObject* object = objects.get(creature);
+    if (object == nullptr){
+        return;
+    }
+    if (object->slot != BVH_INVALID){
+        bvh.invalidate(object->slot);
+        removedSinceBuild++;
+    } else {
+        auto it = std::find(pending.begin(), pending.end(), creature);
+        if (it != pending.end()){
+            *it = pending.back();
+            pending.pop_back();
+        }
+    }
+    objects.remove(creature);
+}
+
+void SpatialBehaviour::rebuild(){
+    uint32_t count = static_cast<uint32_t>(objects.size());
+    std::vector<Aabb> bounds(count);
+    std::vector<uint32_t> slots(count, BVH_INVALID);
+    SpatialObject* data = objects.data();
+    for (uint32_t i = 0; i < count; i++){
+        bounds[i] = data[i].bounds;
+    }
+
+    bvh.build(objects.owners(), bounds.data(), count, jobs, slots.data());
+
+    for (uint32_t i = 0; i < count; i++){
+        data[i].slot = slots[i];
+    }
+    pending.clear();
+    removedSinceBuild = 0;
+    rebuilds++;
+}
+
+void SpatialBehaviour::queryFrustum(const Frustum& frustum, std::pmr::vector<Creature>& out) const {
+    bvh.queryFrustum(frustum, out);
+    for (Creature creature : pending){
+        if (testFrustum(objects.get(creature)->bounds, frustum) != Containment::OUTSIDE){
+            out.push_back(creature);
+        }
+    }
+}
+
+void SpatialBehaviour::querySphere(const float center[3], float radius, std::pmr::vector<Creature>& out) const {
+    bvh.querySphere(center, radius, out);
+    for (Creature creature : pending){
+        if (testSphere(objects.get(creature)->bounds, center, radius)){
+            out.push_back(creature);
+        }
+    }
+}
+
+SpatialStats SpatialBehaviour::stats() const {
+    SpatialStats result{};
+    result.objects = static_cast<uint32_t>(objects.size());
+    result.pending = static_cast<uint32_t>(pending.size());
+    result.nodes = bvh.nodeCount();
+    result.rebuilds = rebuilds;
+    result.quality = bvh.quality();
+    return result;
+}
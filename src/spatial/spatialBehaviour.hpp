@@ -0,0 +1,66 @@
+#pragma once
+
+#include <System.hpp>
+#include <Creature.hpp>
+#include <SparseSet.hpp>
+#include <vector>
+#include <memory_resource>
+#include "src/bounds.hpp"
+#include "src/bvh.hpp"
+#include "../job/src/jobpool.hpp"
+
+// Rebuild when refit tree is this much worse than freshly built one
+#define SPATIAL_REBUILD_QUALITY 1.5f
+
+class SpatialPart {
+public:
+    Creature creature;
+    Aabb bounds;
+};
+
+struct SpatialStats {
+    uint32_t objects = 0;
+    uint32_t pending = 0;       // added after last build, tested brute force
+    uint32_t nodes = 0;
+    uint32_t rebuilds = 0;
+    float quality = 1.0f;       // Bvh::quality()
+};
+
+// Creature bounds in a dynamic BVH. Moves are refit in update(); full rebuild
+// (parallel, on JobPool) only when quality drops or many creatures were added / removed.
+class SpatialBehaviour : public System<SpatialPart> {
+private:
+    struct SpatialObject {
+        Aabb bounds;
+        uint32_t slot;          // BVH slot, BVH_INVALID while pending
+    };
+
+    JobPool* jobs;
+    Bvh bvh{};
+    SparseSet<SpatialObject> objects{};
+    std::vector<Creature> pending{};
+    uint32_t removedSinceBuild = 0;
+    uint32_t rebuilds = 0;
+
+    bool needsRebuild() const;
+
+public:
+    SpatialBehaviour(JobPool* jobs) : jobs(jobs) {}
+
+    void init();
+    // refit moved creatures, rebuild if needed
+    void update();
+    void add(SpatialPart* component);
+
+    void add(Creature creature, const Aabb& bounds);
+    // queries see new bounds after next update()
+    void move(Creature creature, const Aabb& bounds);
+    void remove(Creature creature);
+    void rebuild();
+
+    // Results are appended to out (use frame allocator resource for per frame lists)
+    void queryFrustum(const Frustum& frustum, std::pmr::vector<Creature>& out) const;
+    void querySphere(const float center[3], float radius, std::pmr::vector<Creature>& out) const;
+
+    SpatialStats stats() const;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#define SPATIAL_EMPTY_MIN 1e30f
+#define SPATIAL_EMPTY_MAX -1e30f
+
+struct Aabb {
+    float min[3]{SPATIAL_EMPTY_MIN, SPATIAL_EMPTY_MIN, SPATIAL_EMPTY_MIN};
+    float max[3]{SPATIAL_EMPTY_MAX, SPATIAL_EMPTY_MAX, SPATIAL_EMPTY_MAX};
+
+    void grow(const Aabb& other){
+        for (int k = 0; k < 3; k++){
+            min[k] = std::min(min[k], other.min[k]);
+            max[k] = std::max(max[k], other.max[k]);
+        }
+    }
+
+    bool empty() const { return min[0] > max[0]; }
+
+    float surfaceArea() const {
+        if (empty()){
+            return 0.0f;
+        }
+        float x = max[0] - min[0], y = max[1] - min[1], z = max[2] - min[2];
+        return 2.0f * (x * y + y * z + z * x);
+    }
+
+    float centroid(int axis) const { return 0.5f * (min[axis] + max[axis]); }
+};
+
+// Planes point inside: a*x + b*y + c*z + d >= 0 for visible points
+struct Frustum {
+    float planes[6][4]{};
+
+    // Column major view-projection, Vulkan clip space (0 <= z <= w)
+    static Frustum fromMatrix(const float* m){
+        Frustum frustum{};
+        auto row = [&](int i, float out[4]){
+            out[0] = m[i]; out[1] = m[4 + i]; out[2] = m[8 + i]; out[3] = m[12 + i];
+        };
+        float r0[4], r1[4], r2[4], r3[4];
+        row(0, r0); row(1, r1); row(2, r2); row(3, r3);
+
+        for (int k = 0; k < 4; k++){
+            frustum.planes[0][k] = r3[k] + r0[k]; // left
+            frustum.planes[1][k] = r3[k] - r0[k]; // right
+            frustum.planes[2][k] = r3[k] + r1[k]; // bottom
+            frustum.planes[3][k] = r3[k] - r1[k]; // top
+            frustum.planes[4][k] = r2[k];         // near
+            frustum.planes[5][k] = r3[k] - r2[k]; // far
+        }
+        for (auto& plane : frustum.planes){
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f){
+                for (int k = 0; k < 4; k++){
+                    plane[k] /= length;
+                }
+            }
+        }
+        return frustum;
+    }
+};
+
+enum class Containment : uint8_t {
+    OUTSIDE,
+    INTERSECTS,
+    INSIDE
+};
+
+inline Containment testFrustum(const Aabb& box, const Frustum& frustum){
+    Containment result = Containment::INSIDE;
+    for (const auto& plane : frustum.planes){
+        // p-vertex: box corner furthest along plane normal
+        float p = plane[3], n = plane[3];
+        for (int k = 0; k < 3; k++){
+            p += plane[k] * (plane[k] > 0.0f ? box.max[k] : box.min[k]);
+            n += plane[k] * (plane[k] > 0.0f ? box.min[k] : box.max[k]);
+        }
+        if (p < 0.0f){
+            return Containment::OUTSIDE;
+        }
+        if (n < 0.0f){
+            result = Containment::INTERSECTS;
+        }
+    }
+    return result;
+}
+
+inline bool testSphere(const Aabb& box, const float center[3], float radius){
+    float distance = 0.0f;
+    for (int k = 0; k < 3; k++){
+        float d = std::max(std::max(box.min[k] - center[k], center[k] - box.max[k]), 0.0f);
+        distance += d * d;
+    }
+    return distance <= radius * radius;
+}
@@ -0,0 +1,393 @@
+#include "bvh.hpp"
+#include <algorithm>
+#include <bit>
+
+#define BVH_BINS 12
+#define BVH_TASK_OBJECTS 8192   // subtree size handed to one job
+#define BVH_MAX_DEPTH 64        // past this only median splits: depth stays under 64 + 32
+#define BVH_STACK_SIZE 128      // traversal holds at most depth + 1 nodes
+static_assert(BVH_MAX_DEPTH + 32 + 1 <= BVH_STACK_SIZE, "traversal stack too small for max tree depth");
+
+struct BuildRef {
+    Aabb bounds;
+    float centroid[3];
+    uint32_t object;
+};
+
+struct BuildTask {
+    uint32_t node;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t depth;
+};
+
+// Builds into its own node / slot arrays, so subtrees can be built on different threads
+struct SubtreeBuilder {
+    BuildRef* refs = nullptr;
+    std::vector<BvhNode> nodes{};
+    std::vector<uint32_t> leafObjects{};
+    std::vector<BuildTask>* tasks = nullptr;   // top level only: stop at task sized ranges
+
+    void build(uint32_t index, uint32_t begin, uint32_t end, uint32_t depth);
+};
+
+// SAH over BVH_BINS centroid bins on widest axis, median when bins can not separate
+// or when tree got too deep (SAH may keep cutting off a few objects)
+static uint32_t split(BuildRef* refs, uint32_t begin, uint32_t end, bool median){
+    Aabb centroids{};
+    for (uint32_t i = begin; i < end; i++){
+        for (int k = 0; k < 3; k++){
+            centroids.min[k] = std::min(centroids.min[k], refs[i].centroid[k]);
+            centroids.max[k] = std::max(centroids.max[k], refs[i].centroid[k]);
+        }
+    }
+
+    int axis = 0;
+    for (int k = 1; k < 3; k++){
+        if (centroids.max[k] - centroids.min[k] > centroids.max[axis] - centroids.min[axis]){
+            axis = k;
+        }
+    }
+    float extent = centroids.max[axis] - centroids.min[axis];
+    uint32_t middle = begin + (end - begin) / 2;
+
+    if (extent > 0.0f && !median){
+        Aabb binBounds[BVH_BINS]{};
+        uint32_t binCounts[BVH_BINS]{};
+        float scale = BVH_BINS / extent;
+        auto binOf = [&](const BuildRef& ref){
+            return std::min(static_cast<int>((ref.centroid[axis] - centroids.min[axis]) * scale), BVH_BINS - 1);
+        };
+        for (uint32_t i = begin; i < end; i++){
+            int bin = binOf(refs[i]);
+            binBounds[bin].grow(refs[i].bounds);
+            binCounts[bin]++;
+        }
+
+        // sweep from right, then from left
+        float rightCost[BVH_BINS]{};
+        Aabb right{};
+        uint32_t rightCount = 0;
+        for (int b = BVH_BINS - 1; b > 0; b--){
+            right.grow(binBounds[b]);
+            rightCount += binCounts[b];
+            rightCost[b] = right.surfaceArea() * rightCount;
+        }
+
+        Aabb left{};
+        uint32_t leftCount = 0;
+        float bestCost = 0.0f;
+        int bestBin = -1;
+        for (int b = 1; b < BVH_BINS; b++){
+            left.grow(binBounds[b - 1]);
+            leftCount += binCounts[b - 1];
+            if (leftCount == 0 || leftCount == end - begin){
+                continue;
+            }
+            float cost = left.surfaceArea() * leftCount + rightCost[b];
+            if (bestBin < 0 || cost < bestCost){
+                bestCost = cost;
+                bestBin = b;
+            }
+        }
+
+        if (bestBin > 0){
+            BuildRef* mid = std::partition(refs + begin, refs + end, [&](const BuildRef& ref){ return binOf(ref) < bestBin; });
+            return static_cast<uint32_t>(mid - refs);
+        }
+    }
+
+    std::nth_element(refs + begin, refs + middle, refs + end, [axis](const BuildRef& a, const BuildRef& b){
+        return a.centroid[axis] < b.centroid[axis];
+    });
+    return middle;
+}
+
+void SubtreeBuilder::build(uint32_t index, uint32_t begin, uint32_t end, uint32_t depth){
+    uint32_t count = end - begin;
+
+    if (tasks != nullptr && count > BVH_LEAF_SIZE && count <= BVH_TASK_OBJECTS){
+        tasks->push_back({index, begin, end, depth});
+        return;
+    }
+
+    Aabb bounds{};
+    for (uint32_t i = begin; i < end; i++){
+        bounds.grow(refs[i].bounds);
+    }
+    nodes[index].bounds = bounds;
+
+    if (count <= BVH_LEAF_SIZE){
+        nodes[index].left = static_cast<uint32_t>(leafObjects.size());
+        nodes[index].count = count;
+        for (uint32_t i = begin; i < end; i++){
+            leafObjects.push_back(refs[i].object);
+        }
+        leafObjects.resize(leafObjects.size() + BVH_LEAF_SIZE - count, BVH_INVALID);
+        return;
+    }
+
+    uint32_t mid = split(refs, begin, end, depth >= BVH_MAX_DEPTH);
+    uint32_t left = static_cast<uint32_t>(nodes.size());
+    nodes.resize(nodes.size() + 2);
+    nodes[left].parent = index;
+    nodes[left + 1].parent = index;
+    nodes[index].left = left;
+    nodes[index].count = 0;
+
+    build(left, begin, mid, depth + 1);
+    build(left + 1, mid, end, depth + 1);
+}
+
+void Bvh::build(const Creature* creatures, const Aabb* bounds, uint32_t count, JobPool* jobs, uint32_t* slots){
+    nodes.clear();
+    slotCreatures.clear();
+    slotLeaf.clear();
+    dirtyLeaves.clear();
+    for (int k = 0; k < 3; k++){
+        boxMin[k].clear();
+        boxMax[k].clear();
+    }
+    areaSum = 0.0f;
+    builtQuality = 0.0f;
+    if (count == 0){
+        return;
+    }
+
+    std::vector<BuildRef> refs(count);
+    for (uint32_t i = 0; i < count; i++){
+        refs[i].bounds = bounds[i];
+        refs[i].object = i;
+        for (int k = 0; k < 3; k++){
+            refs[i].centroid[k] = bounds[i].centroid(k);
+        }
+    }
+
+    // Top of tree on this thread, stops at subtrees small enough for one job
+    std::vector<BuildTask> tasks{};
+    SubtreeBuilder top{};
+    top.refs = refs.data();
+    top.nodes.resize(1);
+    top.tasks = jobs ? &tasks : nullptr;
+    top.build(0, 0, count, 0);
+
+    std::vector<SubtreeBuilder> subtrees(tasks.size());
+    auto buildSubtrees = [&](uint32_t begin, uint32_t end){
+        for (uint32_t i = begin; i < end; i++){
+            subtrees[i].refs = refs.data();
+            subtrees[i].nodes.resize(1);
+            subtrees[i].build(0, tasks[i].begin, tasks[i].end, tasks[i].depth);
+        }
+    };
+    if (jobs){
+        jobs->parallelFor(static_cast<uint32_t>(tasks.size()), 1, buildSubtrees);
+    } else {
+        buildSubtrees(0, static_cast<uint32_t>(tasks.size()));
+    }
+
+    // Stitch: subtree root replaces its placeholder, other nodes are appended
+    nodes = std::move(top.nodes);
+    std::vector<uint32_t> leafObjects = std::move(top.leafObjects);
+    for (size_t i = 0; i < subtrees.size(); i++){
+        const BuildTask& task = tasks[i];
+        const SubtreeBuilder& subtree = subtrees[i];
+        uint32_t base = static_cast<uint32_t>(nodes.size());
+        uint32_t slotBase = static_cast<uint32_t>(leafObjects.size());
+        auto map = [&](uint32_t local){ return local == 0 ? task.node : base + local - 1; };
+
+        uint32_t rootParent = nodes[task.node].parent;
+        for (size_t local = 0; local < subtree.nodes.size(); local++){
+            BvhNode node = subtree.nodes[local];
+            node.left = node.count > 0 ? node.left + slotBase : map(node.left);
+            node.parent = local == 0 ? rootParent : map(node.parent);
+            if (local == 0){
+                nodes[task.node] = node;
+            } else {
+                nodes.push_back(node);
+            }
+        }
+        leafObjects.insert(leafObjects.end(), subtree.leafObjects.begin(), subtree.leafObjects.end());
+    }
+
+    // SoA leaf blocks
+    size_t slotCount = leafObjects.size();
+    for (int k = 0; k < 3; k++){
+        boxMin[k].resize(slotCount);
+        boxMax[k].resize(slotCount);
+    }
+    slotCreatures.resize(slotCount);
+    for (size_t slot = 0; slot < slotCount; slot++){
+        uint32_t object = leafObjects[slot];
+        const Aabb box = object == BVH_INVALID ? Aabb{} : bounds[object];
+        for (int k = 0; k < 3; k++){
+            boxMin[k][slot] = box.min[k];
+            boxMax[k][slot] = box.max[k];
+        }
+        if (object != BVH_INVALID){
+            slotCreatures[slot] = creatures[object];
+            slots[object] = static_cast<uint32_t>(slot);
+        }
+    }
+
+    slotLeaf.resize(slotCount / BVH_LEAF_SIZE);
+    for (uint32_t i = 0; i < nodes.size(); i++){
+        if (nodes[i].count > 0){
+            slotLeaf[nodes[i].left / BVH_LEAF_SIZE] = i;
+        }
+        areaSum += nodes[i].bounds.surfaceArea();
+    }
+    dirtyFlags.assign(nodes.size(), 0);
+    builtQuality = areaSum / std::max(rootArea(), 1e-20f);
+}
+
+float Bvh::rootArea() const {
+    return nodes.empty() ? 0.0f : nodes[0].bounds.surfaceArea();
+}
+
+float Bvh::quality() const {
+    if (nodes.empty() || builtQuality <= 0.0f){
+        return 1.0f;
+    }
+    return (areaSum / std::max(rootArea(), 1e-20f)) / builtQuality;
+}
+
+LeafBounds Bvh::leafBounds(uint32_t slot) const {
+    return LeafBounds{
+        {boxMin[0].data() + slot, boxMin[1].data() + slot, boxMin[2].data() + slot},
+        {boxMax[0].data() + slot, boxMax[1].data() + slot, boxMax[2].data() + slot}
+    };
+}
+
+void Bvh::update(uint32_t slot, const Aabb& bounds){
+    for (int k = 0; k < 3; k++){
+        boxMin[k][slot] = bounds.min[k];
+        boxMax[k][slot] = bounds.max[k];
+    }
+    dirtyLeaves.push_back(slotLeaf[slot / BVH_LEAF_SIZE]);
+}
+
+void Bvh::invalidate(uint32_t slot){
+    update(slot, Aabb{});
+    slotCreatures[slot] = Creature{};
+}
+
+void Bvh::refitNode(BvhNode& node){
+    areaSum -= node.bounds.surfaceArea();
+    Aabb bounds{};
+    if (node.count > 0){
+        for (uint32_t slot = node.left; slot < node.left + node.count; slot++){
+            for (int k = 0; k < 3; k++){
+                bounds.min[k] = std::min(bounds.min[k], boxMin[k][slot]);
+                bounds.max[k] = std::max(bounds.max[k], boxMax[k][slot]);
+            }
+        }
+    } else {
+        bounds = nodes[node.left].bounds;
+        bounds.grow(nodes[node.left + 1].bounds);
+    }
+    node.bounds = bounds;
+    areaSum += node.bounds.surfaceArea();
+}
+
+void Bvh::refit(){
+    if (dirtyLeaves.empty()){
+        return;
+    }
+
+    // mark paths to root once, shared ancestors are visited one time
+    std::vector<uint32_t> dirty{};
+    dirty.reserve(dirtyLeaves.size() * 2);
+    for (uint32_t leaf : dirtyLeaves){
+        for (uint32_t node = leaf; node != BVH_INVALID && !dirtyFlags[node]; node = nodes[node].parent){
+            dirtyFlags[node] = 1;
+            dirty.push_back(node);
+        }
+    }
+    dirtyLeaves.clear();
+
+    // children before parents
+    std::sort(dirty.begin(), dirty.end(), std::greater<uint32_t>());
+    for (uint32_t node : dirty){
+        refitNode(nodes[node]);
+        dirtyFlags[node] = 0;
+    }
+}
+
+void Bvh::emitLeaf(const BvhNode& node, uint32_t mask, std::pmr::vector<Creature>& out) const {
+    while (mask){
+        uint32_t lane = static_cast<uint32_t>(std::countr_zero(mask));
+        mask &= mask - 1;
+        Creature creature = slotCreatures[node.left + lane];
+        if (creature.valid()){
+            out.push_back(creature);
+        }
+    }
+}
+
+void Bvh::emitSubtree(uint32_t root, std::pmr::vector<Creature>& out) const {
+    uint32_t stack[BVH_STACK_SIZE];
+    uint32_t size = 0;
+    stack[size++] = root;
+    while (size > 0){
+        const BvhNode& node = nodes[stack[--size]];
+        if (node.count > 0){
+            emitLeaf(node, (1u << node.count) - 1, out);
+        } else {
+            stack[size++] = node.left;
+            stack[size++] = node.left + 1;
+        }
+    }
+}
+
+void Bvh::queryFrustum(const Frustum& frustum, std::pmr::vector<Creature>& out) const {
+    if (nodes.empty()){
+        return;
+    }
+
+    uint32_t stack[BVH_STACK_SIZE];
+    uint32_t size = 0;
+    stack[size++] = 0;
+    while (size > 0){
+        uint32_t index = stack[--size];
+        const BvhNode& node = nodes[index];
+
+        Containment containment = testFrustum(node.bounds, frustum);
+        if (containment == Containment::OUTSIDE){
+            continue;
+        }
+        if (containment == Containment::INSIDE){
+            emitSubtree(index, out);
+            continue;
+        }
+
+        if (node.count > 0){
+            emitLeaf(node, cullLeafFrustum(leafBounds(node.left), frustum) & ((1u << node.count) - 1), out);
+        } else {
+            stack[size++] = node.left;
+            stack[size++] = node.left + 1;
+        }
+    }
+}
+
+void Bvh::querySphere(const float center[3], float radius, std::pmr::vector<Creature>& out) const {
+    if (nodes.empty()){
+        return;
+    }
+
+    uint32_t stack[BVH_STACK_SIZE];
+    uint32_t size = 0;
+    stack[size++] = 0;
+    while (size > 0){
+        const BvhNode& node = nodes[stack[--size]];
+        if (!testSphere(node.bounds, center, radius)){
+            continue;
+        }
+
+        if (node.count > 0){
+            emitLeaf(node, cullLeafSphere(leafBounds(node.left), center, radius) & ((1u << node.count) - 1), out);
+        } else {
+            stack[size++] = node.left;
+            stack[size++] = node.left + 1;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory_resource>
+#include <Creature.hpp>
+#include "bounds.hpp"
+#include "cullkernels.hpp"
+#include "../../job/src/jobpool.hpp"
+
+#define BVH_INVALID 0xFFFFFFFFu
+
+// count == 0: inner node, children are nodes[left] and nodes[left + 1]
+// count > 0:  leaf, objects are SoA slots [left, left + count), left is multiple of BVH_LEAF_SIZE
+// Children always have bigger index than parent, so reverse order is a valid refit order.
+struct BvhNode {
+    Aabb bounds;
+    uint32_t left = 0;
+    uint32_t count = 0;
+    uint32_t parent = BVH_INVALID;
+};
+
+// Bounding volume hierarchy over creature boxes. Build is SAH binned; top of tree is
+// split on calling thread and subtrees are built on JobPool. Moves update leaf bounds
+// in place and refit() walks only dirty paths; quality() tells when rebuild pays off.
+class Bvh {
+private:
+    std::vector<BvhNode> nodes{};
+
+    // leaf object bounds, SoA, BVH_LEAF_SIZE slots per leaf (unused slots are empty boxes)
+    std::vector<float> boxMin[3]{};
+    std::vector<float> boxMax[3]{};
+    std::vector<Creature> slotCreatures{};
+    std::vector<uint32_t> slotLeaf{};      // leaf node per block of BVH_LEAF_SIZE slots
+
+    std::vector<uint32_t> dirtyLeaves{};
+    std::vector<uint8_t> dirtyFlags{};
+    float areaSum = 0.0f;                  // sum of node surface areas, tracks quality after refit
+    float builtQuality = 0.0f;
+
+    LeafBounds leafBounds(uint32_t slot) const;
+    void refitNode(BvhNode& node);
+    void emitSubtree(uint32_t node, std::pmr::vector<Creature>& out) const;
+    void emitLeaf(const BvhNode& node, uint32_t mask, std::pmr::vector<Creature>& out) const;
+    float rootArea() const;
+
+public:
+    // slots[i] receives SoA slot of object i (needed for update / invalidate)
+    void build(const Creature* creatures, const Aabb* bounds, uint32_t count, JobPool* jobs, uint32_t* slots);
+
+    void update(uint32_t slot, const Aabb& bounds);
+    void invalidate(uint32_t slot);
+    void refit();
+
+    // Sum of node areas relative to root, compared to value right after build (1.0 = as built)
+    float quality() const;
+
+    void queryFrustum(const Frustum& frustum, std::pmr::vector<Creature>& out) const;
+    void querySphere(const float center[3], float radius, std::pmr::vector<Creature>& out) const;
+
+    bool empty() const { return nodes.empty(); }
+    uint32_t nodeCount() const { return static_cast<uint32_t>(nodes.size()); }
+    uint32_t slotCount() const { return static_cast<uint32_t>(slotCreatures.size()); }
+};
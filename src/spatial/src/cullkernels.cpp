@@ -0,0 +1,100 @@
+#include "cullkernels.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// Same idea as animation kernels: one wrapper per instruction set, kernels written once
+namespace {
+
+#if defined(__AVX2__)
+struct SimdFloat {
+    static constexpr uint32_t width = 8;
+    __m256 v;
+    static SimdFloat load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static SimdFloat set(float x) { return {_mm256_set1_ps(x)}; }
+    friend SimdFloat operator+(SimdFloat a, SimdFloat b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend SimdFloat operator-(SimdFloat a, SimdFloat b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend SimdFloat operator*(SimdFloat a, SimdFloat b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    static SimdFloat max(SimdFloat a, SimdFloat b) { return {_mm256_max_ps(a.v, b.v)}; }
+    // bit per lane
+    static uint32_t less(SimdFloat a, SimdFloat b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ))); }
+    static uint32_t lessEqual(SimdFloat a, SimdFloat b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ))); }
+};
+static const char* simdPath = "avx2";
+#elif defined(__SSE2__) || defined(_M_X64)
+struct SimdFloat {
+    static constexpr uint32_t width = 4;
+    __m128 v;
+    static SimdFloat load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static SimdFloat set(float x) { return {_mm_set1_ps(x)}; }
+    friend SimdFloat operator+(SimdFloat a, SimdFloat b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend SimdFloat operator-(SimdFloat a, SimdFloat b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend SimdFloat operator*(SimdFloat a, SimdFloat b) { return {_mm_mul_ps(a.v, b.v)}; }
+    static SimdFloat max(SimdFloat a, SimdFloat b) { return {_mm_max_ps(a.v, b.v)}; }
+    static uint32_t less(SimdFloat a, SimdFloat b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a.v, b.v))); }
+    static uint32_t lessEqual(SimdFloat a, SimdFloat b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(a.v, b.v))); }
+};
+static const char* simdPath = "sse2";
+#else
+struct SimdFloat {
+    static constexpr uint32_t width = 1;
+    float v;
+    static SimdFloat load(const float* p) { return {*p}; }
+    static SimdFloat set(float x) { return {x}; }
+    friend SimdFloat operator+(SimdFloat a, SimdFloat b) { return {a.v + b.v}; }
+    friend SimdFloat operator-(SimdFloat a, SimdFloat b) { return {a.v - b.v}; }
+    friend SimdFloat operator*(SimdFloat a, SimdFloat b) { return {a.v * b.v}; }
+    static SimdFloat max(SimdFloat a, SimdFloat b) { return {a.v > b.v ? a.v : b.v}; }
+    static uint32_t less(SimdFloat a, SimdFloat b) { return a.v < b.v ? 1u : 0u; }
+    static uint32_t lessEqual(SimdFloat a, SimdFloat b) { return a.v <= b.v ? 1u : 0u; }
+};
+static const char* simdPath = "scalar";
+#endif
+
+} // namespace
+
+static_assert(BVH_LEAF_SIZE % SimdFloat::width == 0, "Leaf size must be multiple of SIMD width");
+
+const char* spatialSimdPath(){
+    return simdPath;
+}
+
+uint32_t cullLeafFrustum(const LeafBounds& bounds, const Frustum& frustum){
+    const SimdFloat zero = SimdFloat::set(0.0f);
+    uint32_t visible = 0;
+
+    for (uint32_t j = 0; j < BVH_LEAF_SIZE; j += SimdFloat::width){
+        uint32_t outside = 0;
+        for (const auto& plane : frustum.planes){
+            // p-vertex per lane: normal sign is same for all lanes, so pick whole array
+            SimdFloat distance = SimdFloat::set(plane[3]);
+            for (int k = 0; k < 3; k++){
+                const float* corner = plane[k] > 0.0f ? bounds.max[k] : bounds.min[k];
+                distance = distance + SimdFloat::load(corner + j) * SimdFloat::set(plane[k]);
+            }
+            outside |= SimdFloat::less(distance, zero);
+        }
+        visible |= (~outside & ((1u << SimdFloat::width) - 1)) << j;
+    }
+    return visible;
+}
+
+uint32_t cullLeafSphere(const LeafBounds& bounds, const float center[3], float radius){
+    const SimdFloat zero = SimdFloat::set(0.0f);
+    const SimdFloat radiusSquared = SimdFloat::set(radius * radius);
+    uint32_t visible = 0;
+
+    for (uint32_t j = 0; j < BVH_LEAF_SIZE; j += SimdFloat::width){
+        SimdFloat distance = zero;
+        for (int k = 0; k < 3; k++){
+            SimdFloat c = SimdFloat::set(center[k]);
+            SimdFloat d = SimdFloat::max(SimdFloat::max(SimdFloat::load(bounds.min[k] + j) - c, c - SimdFloat::load(bounds.max[k] + j)), zero);
+            distance = distance + d * d;
+        }
+        visible |= SimdFloat::lessEqual(distance, radiusSquared) << j;
+    }
+    return visible;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include "bounds.hpp"
+
+// Objects per BVH leaf. Leaf bounds are SoA blocks of this many floats, so one leaf
+// is one AVX2 register (or two SSE registers) per component.
+#define BVH_LEAF_SIZE 8
+
+// Pointers to one leaf block of each SoA component
+struct LeafBounds {
+    const float* min[3];
+    const float* max[3];
+};
+
+// bit i set = box i is not fully outside frustum
+uint32_t cullLeafFrustum(const LeafBounds& bounds, const Frustum& frustum);
+
+// bit i set = box i touches sphere
+uint32_t cullLeafSphere(const LeafBounds& bounds, const float center[3], float radius);
+
+// "avx2", "sse2" or "scalar"
+const char* spatialSimdPath();
@@ -0,0 +1,71 @@
+#include "spriteBehaviour.hpp"
+#include "src/spriterenderer.hpp"
+#include <iostream>
+#include <stdexcept>
+#include "../memory/src/allocationtracker.hpp"
+
+void SpriteBehaviour::init(){
+    sprites.reserve(1024);
+    std::cout << "Sprites: " << jobs->threadCount() << " worker threads" << std::endl;
+}
+
+void SpriteBehaviour::update(){
+}
+
+void SpriteBehaviour::add(SpritePart* component){
+    add(creatures->create(), *component);
+}
+
+SpritePart& SpriteBehaviour::add(Creature creature, const SpritePart& sprite){
+    batcher.invalidate();
+    return sprites.add(creature, sprite);
+}
+
+void SpriteBehaviour::remove(Creature creature){
+    if (sprites.remove(creature)){
+        batcher.invalidate();
+    }
+}
+
+SpritePart* SpriteBehaviour::get(Creature creature){
+    if (!creatures->alive(creature)){
+        return nullptr;
+    }
+    return sprites.get(creature);
+}
+
+void SpriteBehaviour::setRenderer(SpriteRenderer* spriteRenderer){
+    renderer = spriteRenderer;
+    batcher.setSplitTextures(renderer != nullptr && !renderer->isBindless());
+}
+
+const std::vector<SpriteBatch>& SpriteBehaviour::pack(SpriteInstance* out){
+    uint32_t count = static_cast<uint32_t>(sprites.size());
+    // parts are kept in draw order, so steady state packing reads them linearly
+    if (batcher.sort(sprites.data(), count, jobs)){
+        sprites.reorder(batcher.drawOrder());
+    }
+    return batcher.pack(sprites.data(), count, out, jobs);
+}
+
+void SpriteBehaviour::submit(RenderCommandBuffer& commands){
+    if (renderer == nullptr){
+        return;
+    }
+    MemoryTagScope tag{MemoryTag::RENDER};
+
+    if (sprites.size() > renderer->maxSprites()){
+        throw std::runtime_error("Sprite instance buffer is full");
+    }
+
+    uint32_t buffer = renderer->acquire();
+    // batches stay with buffer, render thread reads them when it replays command
+    renderer->batches(buffer) = pack(renderer->instances(buffer));
+
+    SpriteDrawCommand command{};
+    command.buffer = buffer;
+    command.camera[0] = camera[0];
+    command.camera[1] = camera[1];
+    command.zoom = zoom;
+    commands.push(SPRITE_RENDER_COMMAND, command);
+}
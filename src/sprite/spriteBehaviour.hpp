@@ -0,0 +1,54 @@
+#pragma once
+
+#include <System.hpp>
+#include <Creature.hpp>
+#include <SparseSet.hpp>
+#include <vector>
+#include "src/spritebatch.hpp"
+#include "../graphics/src/commandstream.hpp"
+#include "../job/src/jobpool.hpp"
+
+// forward declaration
+class SpriteRenderer;
+
+// 2D sprites of creatures. Parts are stored packed in draw order; submit() packs them straight
+// into renderer's mapped instance buffer, one instanced draw per batch.
+class SpriteBehaviour : public System<SpritePart> {
+private:
+    CreatureRegistry<>* creatures;
+    JobPool* jobs;
+    SpriteRenderer* renderer = nullptr;
+    SparseSet<SpritePart> sprites{};
+    SpriteBatcher batcher{};
+    float camera[2]{};
+    float zoom = 1.0f;
+
+public:
+    SpriteBehaviour(CreatureRegistry<>* creatures, JobPool* jobs) : creatures(creatures), jobs(jobs) {}
+
+    void init();
+    void update();
+
+    // Part without creature, gets a new creature from registry
+    void add(SpritePart* component);
+    SpritePart& add(Creature creature, const SpritePart& sprite);
+    void remove(Creature creature);
+
+    // nullptr for stale creature or creature without sprite; position, size, color etc. can be
+    // changed freely, changes of layer, blend or texture make next submit re-sort
+    SpritePart* get(Creature creature);
+
+    void setRenderer(SpriteRenderer* spriteRenderer);
+    // camera: world position at screen center, zoom: screen pixels per world unit
+    void setView(float x, float y, float pixelsPerUnit) { camera[0] = x; camera[1] = y; zoom = pixelsPerUnit; }
+
+    // Game thread, once per rendered frame: packs sprites and pushes draw command.
+    // Blocks only while every instance buffer is still in use by GPU.
+    void submit(RenderCommandBuffer& commands);
+
+    // Without renderer (tests, benchmarks): sort and pack into out, which holds size() instances
+    const std::vector<SpriteBatch>& pack(SpriteInstance* out);
+
+    size_t size() const { return sprites.size(); }
+    const SpriteBatchStats& stats() const { return batcher.stats(); }
+};
@@ -0,0 +1,119 @@
+#include "spritebatch.hpp"
+#include <atomic>
+#include <algorithm>
+
+void SpriteBatcher::setSplitTextures(bool split){
+    if (split != splitTextures){
+        splitTextures = split;
+        dirty = true;
+    }
+}
+
+// LSD radix sort of (key, dense index), stable, so equal keys keep dense order.
+// Bytes that are equal for every key (texture bytes when bindless, usually blend) are skipped.
+void SpriteBatcher::radixSort(uint32_t count){
+    uint32_t histograms[4][256]{};
+    for (uint32_t i = 0; i < count; i++){
+        uint32_t k = keys[i];
+        histograms[0][k & 0xff]++;
+        histograms[1][(k >> 8) & 0xff]++;
+        histograms[2][(k >> 16) & 0xff]++;
+        histograms[3][k >> 24]++;
+    }
+
+    order.resize(count);
+    for (uint32_t i = 0; i < count; i++){
+        order[i] = i;
+    }
+    scratchKeys.resize(count);
+    scratchOrder.resize(count);
+
+    for (uint32_t pass = 0; pass < 4; pass++){
+        uint32_t shift = pass * 8;
+        uint32_t* histogram = histograms[pass];
+        if (histogram[(keys[0] >> shift) & 0xff] == count){
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b < 256; b++){
+            uint32_t n = histogram[b];
+            histogram[b] = offset;
+            offset += n;
+        }
+        for (uint32_t i = 0; i < count; i++){
+            uint32_t k = keys[i];
+            uint32_t position = histogram[(k >> shift) & 0xff]++;
+            scratchKeys[position] = k;
+            scratchOrder[position] = order[i];
+        }
+        keys.swap(scratchKeys);
+        order.swap(scratchOrder);
+    }
+}
+
+void SpriteBatcher::buildBatches(uint32_t count){
+    batches.clear();
+    // layer is not part of batch: instances draw in order, so layers stay ordered inside one draw
+    const uint32_t batchMask = 0x00ffffff;
+    for (uint32_t i = 0; i < count; i++){
+        uint32_t k = keys[i] & batchMask;
+        if (batches.empty() || (keys[i - 1] & batchMask) != k){
+            SpriteBatch batch{};
+            batch.blend = static_cast<SpriteBlend>(k >> 16);
+            batch.texture = static_cast<uint16_t>(k & 0xffff);
+            batch.firstInstance = i;
+            batches.push_back(batch);
+        }
+        batches.back().instanceCount++;
+    }
+}
+
+bool SpriteBatcher::sort(const SpritePart* parts, uint32_t count, JobPool* jobs){
+    if (keys.size() != count){
+        keys.resize(count);
+        dirty = true;
+    }
+
+    // moved sprites keep their keys, parts then are still in draw order
+    std::atomic<bool> changed{false};
+    jobs->parallelFor(count, SPRITE_PACK_BATCH_SIZE, [&](uint32_t begin, uint32_t end){
+        bool differs = false;
+        for (uint32_t i = begin; i < end; i++){
+            uint32_t k = key(parts[i]);
+            differs |= keys[i] != k;
+            keys[i] = k;
+        }
+        if (differs){
+            changed.store(true, std::memory_order_relaxed);
+        }
+    });
+
+    currentStats.sorted = false;
+    if (!dirty && !changed.load(std::memory_order_relaxed)){
+        return false;
+    }
+    dirty = false;
+
+    bool reorder = !std::is_sorted(keys.begin(), keys.end());
+    if (reorder){
+        // keys are left in draw order, which is dense order once caller moved parts
+        radixSort(count);
+        currentStats.sorted = true;
+    }
+    buildBatches(count);
+    currentStats.batches = static_cast<uint32_t>(batches.size());
+    return reorder;
+}
+
+const std::vector<SpriteBatch>& SpriteBatcher::pack(const SpritePart* parts, uint32_t count, SpriteInstance* out, JobPool* jobs){
+    // sequential reads and writes, out is usually write combined mapped memory
+    jobs->parallelFor(count, SPRITE_PACK_BATCH_SIZE, [&](uint32_t begin, uint32_t end){
+        for (uint32_t i = begin; i < end; i++){
+            packSprite(parts[i], out[i]);
+        }
+    });
+
+    currentStats.sprites = count;
+    return batches;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include "../../job/src/jobpool.hpp"
+
+// sprites per pack job
+#define SPRITE_PACK_BATCH_SIZE 4096
+
+// Blend mode is a pipeline, sprites of one mode in one layer share a draw
+enum class SpriteBlend : uint8_t {
+    SOLID,      // no blending
+    ALPHA,      // src alpha, one minus src alpha
+    ADDITIVE,   // src alpha, one
+    COUNT
+};
+
+class SpritePart {
+public:
+    float position[2]{};            // center, world units
+    float size[2]{1.0f, 1.0f};
+    float rotation = 0.0f;          // radians, around center
+    float uv[4]{0.0f, 0.0f, 1.0f, 1.0f}; // min xy, max xy
+    uint32_t color = 0xffffffff;    // 0xAABBGGRR, multiplies texture
+    uint16_t texture = 0;           // SpriteRenderer texture slot, 0 is white
+    uint8_t layer = 0;              // draw order, higher layers on top
+    SpriteBlend blend = SpriteBlend::ALPHA;
+};
+
+// Instance vertex layout consumed by shaders/sprite.vert, 32 bytes
+struct SpriteInstance {
+    float position[2];
+    float size[2];
+    uint16_t uv[4];      // unorm16
+    uint32_t color;      // unorm8 x 4
+    int16_t rotation;    // snorm16, angle / pi
+    uint16_t texture;
+};
+static_assert(sizeof(SpriteInstance) == 32, "SpriteInstance must match shaders/sprite.vert");
+
+// One instanced draw
+struct SpriteBatch {
+    SpriteBlend blend;
+    uint16_t texture;           // only meaningful when batcher splits by texture
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+struct SpriteBatchStats {
+    uint32_t sprites = 0;
+    uint32_t batches = 0;
+    bool sorted = false;        // parts were reordered this frame
+};
+
+inline uint16_t packUnorm16(float value){
+    return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+inline void packSprite(const SpritePart& part, SpriteInstance& out){
+    out.position[0] = part.position[0];
+    out.position[1] = part.position[1];
+    out.size[0] = part.size[0];
+    out.size[1] = part.size[1];
+    for (int k = 0; k < 4; k++){
+        out.uv[k] = packUnorm16(part.uv[k]);
+    }
+    out.color = part.color;
+    // wrap to [-1, 1) half turns
+    float turns = part.rotation * 0.318309886f;
+    turns -= 2.0f * std::floor(turns * 0.5f + 0.5f);
+    out.rotation = static_cast<int16_t>(std::lround(turns * 32767.0f));
+    out.texture = part.texture;
+}
+
+// Sorts sprites into draw order (layer, blend, texture) and packs them as instances.
+// Owner keeps its parts in draw order (reorders them when sort() asks), so packing is one
+// linear parallel pass and moving sprites never re-sort; only changed keys or added / removed
+// sprites do. With bindless textures texture is left out of key, one batch then covers whole blend run.
+class SpriteBatcher {
+private:
+    std::vector<uint32_t> keys{};          // dense index -> key
+    std::vector<uint32_t> order{};         // draw position -> dense index, after sort()
+    std::vector<uint32_t> scratchKeys{};
+    std::vector<uint32_t> scratchOrder{};
+    std::vector<SpriteBatch> batches{};
+    bool splitTextures = false;
+    bool dirty = true;
+    SpriteBatchStats currentStats{};
+
+    uint32_t key(const SpritePart& part) const {
+        return (uint32_t(part.layer) << 24) | (uint32_t(part.blend) << 16) | (splitTextures ? part.texture : 0u);
+    }
+    void radixSort(uint32_t count);
+    void buildBatches(uint32_t count);
+
+public:
+    // true without descriptor indexing: texture index must then be uniform within a draw
+    void setSplitTextures(bool split);
+    // sprites were added or removed, dense indices changed
+    void invalidate() { dirty = true; }
+
+    // Updates sort keys. True when parts are out of draw order: caller must then move
+    // part drawOrder()[i] to dense index i before pack()
+    bool sort(const SpritePart* parts, uint32_t count, JobPool* jobs);
+    const uint32_t* drawOrder() const { return order.data(); }
+
+    // parts in draw order; returns batches to draw out with
+    const std::vector<SpriteBatch>& pack(const SpritePart* parts, uint32_t count, SpriteInstance* out, JobPool* jobs);
+
+    const SpriteBatchStats& stats() const { return currentStats; }
+};
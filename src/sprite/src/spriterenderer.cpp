@@ -0,0 +1,436 @@
+#include "spriterenderer.hpp"
+#include "../../graphics/src/render.hpp"
+#include "../../graphics/src/pipeline/shader.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+// one more than frames in flight: game thread writes next frame while GPU reads the others
+#define SPRITE_INSTANCE_BUFFERS (MAX_FRAMES_IN_FLIGHT + 1)
+
+struct SpriteView {
+    float offset[2];
+    float scale[2];
+};
+
+SpriteRenderer::SpriteRenderer(Render* render, uint32_t maxSprites){
+    std::cout << "Creating sprite renderer" << std::endl;
+
+    _render = render;
+    capacity = maxSprites;
+    bindless = render->capabilities.descriptorIndexing;
+    // only the bindless array counts against per stage sampler limit
+    textureSlots = bindless ? std::min(SPRITE_MAX_TEXTURES, render->capabilities.maxPerStageDescriptorSamplers) : SPRITE_MAX_TEXTURES;
+    setsPerFrame = bindless ? 1 : textureSlots;
+
+    createDescriptors();
+    createPipelines();
+    createWhiteTexture();
+
+    textures.assign(textureSlots, whiteView);
+    textureChanged.assign(textureSlots, 1);
+    setUpdated.assign(MAX_FRAMES_IN_FLIGHT, 0);
+    textureChanges = 1;
+
+    VkDeviceSize bufferSize = VkDeviceSize(capacity) * sizeof(SpriteInstance);
+    instanceBuffers.resize(SPRITE_INSTANCE_BUFFERS);
+    instanceMemories.resize(SPRITE_INSTANCE_BUFFERS);
+    instanceMapped.resize(SPRITE_INSTANCE_BUFFERS);
+    bufferBatches.resize(SPRITE_INSTANCE_BUFFERS);
+    bufferOwners.assign(SPRITE_INSTANCE_BUFFERS, FREE);
+    slotBuffers.assign(MAX_FRAMES_IN_FLIGHT, FREE);
+    for (uint32_t i = 0; i < SPRITE_INSTANCE_BUFFERS; i++){
+        render->createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                             &instanceBuffers[i], &instanceMemories[i]);
+        void* mapped;
+        vkMapMemory(render->device, instanceMemories[i], 0, bufferSize, 0, &mapped);
+        instanceMapped[i] = static_cast<SpriteInstance*>(mapped);
+    }
+
+    render->registerCommand(SPRITE_RENDER_COMMAND, [this](VkCommandBuffer commandBuffer, const void* payload){
+        SpriteDrawCommand command;
+        memcpy(&command, payload, sizeof(command));
+        draw(commandBuffer, command);
+    });
+
+    std::cout << "\tInstances: " << capacity << " x " << SPRITE_INSTANCE_BUFFERS << " buffers, texture slots: " << textureSlots
+              << (bindless ? " (bindless)" : " (batches split by texture)") << std::endl;
+    std::cout << "Sprite renderer created successfully" << std::endl << std::endl;
+}
+
+void SpriteRenderer::createDescriptors(){
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = bindless ? textureSlots : 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutCreateInfo{};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.bindingCount = 1;
+    layoutCreateInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(_render->device, &layoutCreateInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create sprite descriptor set layout");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = textureSlots * MAX_FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo{};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.maxSets = setsPerFrame * MAX_FRAMES_IN_FLIGHT;
+    poolCreateInfo.poolSizeCount = 1;
+    poolCreateInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(_render->device, &poolCreateInfo, nullptr, &descriptorPool) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create sprite descriptor pool");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(setsPerFrame * MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
+    descriptorSets.resize(layouts.size());
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = descriptorPool;
+    allocateInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocateInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(_render->device, &allocateInfo, descriptorSets.data()) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate sprite descriptor sets");
+    }
+
+    VkSamplerCreateInfo samplerCreateInfo{};
+    samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+    samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+    samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(_render->device, &samplerCreateInfo, nullptr, &sampler) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create sprite sampler");
+    }
+}
+
+void SpriteRenderer::createPipelines(){
+    // non uniform texture index needs descriptor indexing, otherwise one texture set per batch
+    Shader vertexShader{_render, "shaders/sprite.vert.spv", ShaderType::VERTEX};
+    Shader fragmentShader{_render, bindless ? "shaders/sprite_bindless.frag.spv" : "shaders/sprite.frag.spv", ShaderType::FRAGMENT};
+
+    // texture array size (bindless shader only)
+    VkSpecializationMapEntry specializationEntry{0, 0, sizeof(uint32_t)};
+    VkSpecializationInfo specialization{};
+    specialization.mapEntryCount = 1;
+    specialization.pMapEntries = &specializationEntry;
+    specialization.dataSize = sizeof(uint32_t);
+    specialization.pData = &textureSlots;
+
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = vertexShader.bits;
+    stages[0].module = vertexShader.shadermodule;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = fragmentShader.bits;
+    stages[1].module = fragmentShader.shadermodule;
+    stages[1].pName = "main";
+    stages[1].pSpecializationInfo = &specialization;
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(SpriteView);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(_render->device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create sprite pipeline layout");
+    }
+
+    // Per instance attributes, quad corners come from gl_VertexIndex
+    VkVertexInputBindingDescription binding{0, sizeof(SpriteInstance), VK_VERTEX_INPUT_RATE_INSTANCE};
+    VkVertexInputAttributeDescription attributes[6]{
+        {0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteInstance, position)},
+        {1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteInstance, size)},
+        {2, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(SpriteInstance, uv)},
+        {3, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(SpriteInstance, color)},
+        {4, 0, VK_FORMAT_R16_SNORM, offsetof(SpriteInstance, rotation)},
+        {5, 0, VK_FORMAT_R16_UINT, offsetof(SpriteInstance, texture)},
+    };
+
+    VkPipelineVertexInputStateCreateInfo vertexInputState{};
+    vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputState.vertexBindingDescriptionCount = 1;
+    vertexInputState.pVertexBindingDescriptions = &binding;
+    vertexInputState.vertexAttributeDescriptionCount = 6;
+    vertexInputState.pVertexAttributeDescriptions = attributes;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState{};
+    inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkDynamicState dynamicStateList[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStateList;
+
+    // mirrored sprites (negative size) flip winding, so nothing is culled
+    VkPipelineRasterizationStateCreateInfo rasterizationState{};
+    rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizationState.cullMode = VK_CULL_MODE_NONE;
+    rasterizationState.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterizationState.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampleState{};
+    multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState blendAttachments[size_t(SpriteBlend::COUNT)]{};
+    VkPipelineColorBlendStateCreateInfo blendStates[size_t(SpriteBlend::COUNT)]{};
+    VkGraphicsPipelineCreateInfo createInfos[size_t(SpriteBlend::COUNT)]{};
+    for (uint32_t i = 0; i < uint32_t(SpriteBlend::COUNT); i++){
+        VkPipelineColorBlendAttachmentState& attachment = blendAttachments[i];
+        attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        attachment.blendEnable = SpriteBlend(i) == SpriteBlend::SOLID ? VK_FALSE : VK_TRUE;
+        attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        attachment.dstColorBlendFactor = SpriteBlend(i) == SpriteBlend::ADDITIVE ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        attachment.colorBlendOp = VK_BLEND_OP_ADD;
+        attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+        blendStates[i].sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        blendStates[i].attachmentCount = 1;
+        blendStates[i].pAttachments = &blendAttachments[i];
+
+        VkGraphicsPipelineCreateInfo& createInfo = createInfos[i];
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.stageCount = 2;
+        createInfo.pStages = stages;
+        createInfo.pVertexInputState = &vertexInputState;
+        createInfo.pInputAssemblyState = &inputAssemblyState;
+        createInfo.pViewportState = &viewportState;
+        createInfo.pRasterizationState = &rasterizationState;
+        createInfo.pMultisampleState = &multisampleState;
+        createInfo.pColorBlendState = &blendStates[i];
+        createInfo.pDynamicState = &dynamicState;
+        createInfo.layout = pipelineLayout;
+        createInfo.renderPass = _render->renderpass;
+        createInfo.subpass = 0;
+        createInfo.basePipelineIndex = -1;
+    }
+
+    VkResult result = vkCreateGraphicsPipelines(_render->device, VK_NULL_HANDLE, uint32_t(SpriteBlend::COUNT), createInfos, nullptr, pipelines);
+    vertexShader.cleanup();
+    fragmentShader.cleanup();
+    if (result != VK_SUCCESS){
+        throw std::runtime_error("Failed to create sprite pipelines");
+    }
+}
+
+void SpriteRenderer::createWhiteTexture(){
+    VkDevice device = _render->device;
+
+    VkImageCreateInfo imageCreateInfo{};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageCreateInfo.extent = {1, 1, 1};
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (vkCreateImage(device, &imageCreateInfo, nullptr, &whiteImage) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create sprite white texture");
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(device, whiteImage, &memoryRequirements);
+
+    VkMemoryAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.allocationSize = memoryRequirements.size;
+    allocateInfo.memoryTypeIndex = _render->findMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (vkAllocateMemory(device, &allocateInfo, nullptr, &whiteMemory) != VK_SUCCESS){
+        throw std::runtime_error("Failed to allocate sprite white texture memory");
+    }
+    vkBindImageMemory(device, whiteImage, whiteMemory, 0);
+
+    VkImageViewCreateInfo viewCreateInfo{};
+    viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewCreateInfo.image = whiteImage;
+    viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewCreateInfo.subresourceRange.levelCount = 1;
+    viewCreateInfo.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(device, &viewCreateInfo, nullptr, &whiteView) != VK_SUCCESS){
+        throw std::runtime_error("Failed to create sprite white texture view");
+    }
+
+    VkCommandBuffer commandBuffer = _render->beginSingleTimeCommands();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = whiteImage;
+    barrier.subresourceRange = viewCreateInfo.subresourceRange;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                   0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkClearColorValue white = {{1.0f, 1.0f, 1.0f, 1.0f}};
+    vkCmdClearColorImage(commandBuffer, whiteImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &white, 1, &barrier.subresourceRange);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    _render->stats.pipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                   0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    _render->endSingleTimeCommands(commandBuffer);
+}
+
+SpriteRenderer::~SpriteRenderer(){
+    VkDevice device = _render->device;
+
+    _render->commandHandlers.erase(SPRITE_RENDER_COMMAND);
+
+    for (uint32_t i = 0; i < instanceBuffers.size(); i++){
+        vkUnmapMemory(device, instanceMemories[i]);
+        vkDestroyBuffer(device, instanceBuffers[i], nullptr);
+        vkFreeMemory(device, instanceMemories[i], nullptr);
+    }
+
+    vkDestroyImageView(device, whiteView, nullptr);
+    vkDestroyImage(device, whiteImage, nullptr);
+    vkFreeMemory(device, whiteMemory, nullptr);
+    vkDestroySampler(device, sampler, nullptr);
+
+    for (VkPipeline pipeline : pipelines){
+        vkDestroyPipeline(device, pipeline, nullptr);
+    }
+    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+}
+
+void SpriteRenderer::setTexture(uint16_t slot, VkImageView view){
+    if (slot >= textureSlots){
+        throw std::runtime_error("Sprite texture slot out of range");
+    }
+    std::lock_guard<std::mutex> lock{mutex};
+    textures[slot] = view != VK_NULL_HANDLE ? view : whiteView;
+    textureChanged[slot] = ++textureChanges;
+}
+
+uint32_t SpriteRenderer::acquire(){
+    std::unique_lock<std::mutex> lock{mutex};
+    uint32_t buffer = FREE;
+    released.wait(lock, [&]{
+        auto found = std::find(bufferOwners.begin(), bufferOwners.end(), FREE);
+        buffer = static_cast<uint32_t>(found - bufferOwners.begin());
+        return found != bufferOwners.end();
+    });
+    bufferOwners[buffer] = WRITING;
+    return buffer;
+}
+
+// Set of frame slot is not in use (its fence was waited on), so it is updated in place
+void SpriteRenderer::updateDescriptors(uint32_t frame){
+    if (setUpdated[frame] == textureChanges){
+        return;
+    }
+
+    std::vector<VkDescriptorImageInfo> imageInfos{};
+    std::vector<VkWriteDescriptorSet> writes{};
+    imageInfos.reserve(textureSlots);
+    for (uint32_t slot = 0; slot < textureSlots; slot++){
+        if (textureChanged[slot] <= setUpdated[frame]){
+            continue;
+        }
+        imageInfos.push_back({sampler, textures[slot], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet(frame, slot);
+        write.dstBinding = 0;
+        write.dstArrayElement = bindless ? slot : 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfos.back();
+        writes.push_back(write);
+    }
+    vkUpdateDescriptorSets(_render->device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    setUpdated[frame] = textureChanges;
+}
+
+void SpriteRenderer::draw(VkCommandBuffer commandBuffer, const SpriteDrawCommand& command){
+    uint32_t frame = _render->currentFrame;
+    {
+        // buffer this slot drew from last time is retired now, hand it back to game thread
+        std::lock_guard<std::mutex> lock{mutex};
+        if (slotBuffers[frame] != FREE){
+            bufferOwners[slotBuffers[frame]] = FREE;
+        }
+        bufferOwners[command.buffer] = frame;
+        slotBuffers[frame] = command.buffer;
+        updateDescriptors(frame);
+    }
+    released.notify_all();
+
+    const std::vector<SpriteBatch>& batches = bufferBatches[command.buffer];
+    if (batches.empty()){
+        return;
+    }
+
+    // world y up, clip space y down; scale from full extent keeps sprites still under dynamic resolution
+    SpriteView view{};
+    view.offset[0] = -command.camera[0];
+    view.offset[1] = -command.camera[1];
+    view.scale[0] = 2.0f * command.zoom / static_cast<float>(_render->extent.width);
+    view.scale[1] = -2.0f * command.zoom / static_cast<float>(_render->extent.height);
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &instanceBuffers[command.buffer], &offset);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(view), &view);
+
+    SpriteBlend bound = SpriteBlend::COUNT;
+    uint32_t boundTexture = UINT32_MAX;
+    for (const SpriteBatch& batch : batches){
+        if (batch.blend != bound){
+            _render->stats.bindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[size_t(batch.blend)]);
+            bound = batch.blend;
+        }
+        // bindless: one set for every batch; else set of batch texture (out of range slots use slot 0)
+        uint32_t texture = bindless ? 0 : (batch.texture < textureSlots ? batch.texture : 0);
+        if (texture != boundTexture){
+            VkDescriptorSet set = descriptorSet(frame, texture);
+            _render->stats.bindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &set, 0, nullptr);
+            boundTexture = texture;
+        }
+        _render->stats.draw(commandBuffer, 4, batch.instanceCount, 0, batch.firstInstance);
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "spritebatch.hpp"
+
+// Render command type of SpriteDrawCommand
+#define SPRITE_RENDER_COMMAND 0x0100
+#define SPRITE_MAX_INSTANCES (1u << 20)
+// Texture slots, lowered to device limit
+#define SPRITE_MAX_TEXTURES 1024u
+
+// forward declaration
+class Render;
+
+// Game thread -> render thread: draw batches packed into instance buffer
+struct SpriteDrawCommand {
+    uint32_t buffer;
+    float camera[2];    // world position at screen center
+    float zoom;         // screen pixels per world unit
+};
+
+// Draws packed sprites with one instanced draw per batch.
+// Instance buffers are persistently mapped and written directly by game thread, there is one
+// more than frames in flight: a buffer returns to game thread when its frame slot is reused,
+// which happens only after that slot's fence was waited on.
+// With descriptor indexing textures are slots of one descriptor array and the index is non uniform,
+// so batches do not split by texture. Without it every slot has its own set (per frame slot)
+// and each batch binds the set of its texture.
+class SpriteRenderer {
+private:
+    static constexpr uint32_t FREE = UINT32_MAX;
+    static constexpr uint32_t WRITING = UINT32_MAX - 1;
+
+    Render* _render;
+    uint32_t capacity;
+    uint32_t textureSlots;
+    bool bindless;
+
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets{};  // per frame slot, times texture slots without bindless
+    uint32_t setsPerFrame = 1;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipelines[size_t(SpriteBlend::COUNT)]{};
+    VkSampler sampler = VK_NULL_HANDLE;
+
+    // slot 0 and unset slots
+    VkImage whiteImage = VK_NULL_HANDLE;
+    VkDeviceMemory whiteMemory = VK_NULL_HANDLE;
+    VkImageView whiteView = VK_NULL_HANDLE;
+
+    std::vector<VkBuffer> instanceBuffers{};
+    std::vector<VkDeviceMemory> instanceMemories{};
+    std::vector<SpriteInstance*> instanceMapped{};
+    std::vector<std::vector<SpriteBatch>> bufferBatches{};
+
+    // ownership, guarded by mutex: FREE, WRITING or frame slot drawing from buffer
+    std::mutex mutex;
+    std::condition_variable released;
+    std::vector<uint32_t> bufferOwners{};
+    std::vector<uint32_t> slotBuffers{};
+
+    // descriptor updates, slot i of a set is rewritten when textureChanged[i] is newer than set
+    std::vector<VkImageView> textures{};
+    std::vector<uint64_t> textureChanged{};
+    std::vector<uint64_t> setUpdated{};
+    uint64_t textureChanges = 0;
+
+    void createDescriptors();
+    void createPipelines();
+    void createWhiteTexture();
+    VkDescriptorSet descriptorSet(uint32_t frame, uint32_t slot) const { return descriptorSets[frame * setsPerFrame + (bindless ? 0 : slot)]; }
+    void updateDescriptors(uint32_t frame);
+    void draw(VkCommandBuffer commandBuffer, const SpriteDrawCommand& command);
+
+public:
+    SpriteRenderer(Render* render, uint32_t maxSprites = SPRITE_MAX_INSTANCES);
+    ~SpriteRenderer();
+
+    uint32_t maxSprites() const { return capacity; }
+    uint32_t maxTextures() const { return textureSlots; }
+    // batches may mix textures (descriptor indexing), else batcher must split them
+    bool isBindless() const { return bindless; }
+
+    // View must stay valid while sprites use slot; VK_NULL_HANDLE resets slot to white
+    void setTexture(uint16_t slot, VkImageView view);
+
+    // Game thread: waits for free instance buffer
+    uint32_t acquire();
+    SpriteInstance* instances(uint32_t buffer) { return instanceMapped[buffer]; }
+    std::vector<SpriteBatch>& batches(uint32_t buffer) { return bufferBatches[buffer]; }
+};
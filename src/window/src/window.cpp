@@ -4,7 +4,7 @@ Window::Window(const char* window_name, uint32_t width, uint32_t height, RenderC
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 
-    glfwCreateWindow(width, height, window_name, NULL, NULL);
+    window = glfwCreateWindow(width, height, window_name, NULL, NULL);
 
     renderCallback = callback;
 }
@@ -19,4 +19,6 @@ public:
     Window(const char* window_name, uint32_t width, uint32_t height, RenderCallback callback);
     Surface getSurface(GraphicsAPI api, SurfaceCreate surfaceCreate);
     void update();
+
+    GLFWwindow* getWindow() const { return window; }
 };
\ No newline at end of file
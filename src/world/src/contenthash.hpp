@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <fstream>
+#include <vector>
+
+// 64-bit FNV-1a. Resources are identified by what is in the file, not by path,
+// so two paths with same content share one GPU object.
+inline uint64_t contentHash(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ull){
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++){
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// 0 when file can not be read
+inline uint64_t contentHashFile(const std::string& path){
+    std::ifstream file{path, std::ios::ate | std::ios::binary};
+    if (!file){
+        return 0;
+    }
+    std::vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    return contentHash(data.data(), data.size());
+}
@@ -0,0 +1,255 @@
+#include "snapshot.hpp"
+#include "contenthash.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define SNAPSHOT_MMAP
+#endif
+
+#define SNAPSHOT_ALIGNMENT 16
+
+static size_t alignUp(size_t value){
+    return (value + SNAPSHOT_ALIGNMENT - 1) & ~size_t(SNAPSHOT_ALIGNMENT - 1);
+}
+
+size_t SnapshotWriter::append(const void* data, size_t size){
+    size_t offset = alignUp(payload.size());
+    payload.resize(offset + size);
+    if (size > 0){
+        memcpy(payload.data() + offset, data, size);
+    }
+    return offset;
+}
+
+void SnapshotWriter::resource(const void* object, SnapshotResourceType type, const std::string& path){
+    uint64_t hash = contentHashFile(path);
+    if (hash == 0){
+        throw std::runtime_error("Snapshot resource not found: " + path);
+    }
+
+    // same content under another path or object -> same entry
+    auto it = resourceByHash.find(hash ^ static_cast<uint64_t>(type));
+    if (it != resourceByHash.end()){
+        resourceByObject[object] = it->second;
+        return;
+    }
+
+    uint64_t index = resources.size();
+    PendingResource pending{};
+    pending.resource.hash = hash;
+    pending.resource.type = type;
+    pending.resource.pathLength = static_cast<uint32_t>(path.size());
+    pending.path = path;
+    resources.push_back(pending);
+
+    resourceByHash[hash ^ static_cast<uint64_t>(type)] = index;
+    resourceByObject[object] = index;
+}
+
+void SnapshotWriter::creatures(const CreatureRegistry<>& registry){
+    header.creatureSlots = registry.slotCount();
+    header.creatureFreeHead = registry.freeListHead();
+    header.creatureAlive = registry.size();
+    generations = append(registry.generationData(), sizeof(uint32_t) * registry.slotCount());
+    freeLinks = append(registry.freeLinkData(), sizeof(uint32_t) * registry.slotCount());
+}
+
+void SnapshotWriter::write(const std::string& path){
+    // fixed size tables first, payload last so its offsets only need one shift
+    size_t offset = alignUp(sizeof(SnapshotHeader));
+    header.blockCount = static_cast<uint32_t>(blocks.size());
+    header.blocksOffset = offset;
+    offset = alignUp(offset + sizeof(SnapshotBlock) * blocks.size());
+    header.resourceCount = static_cast<uint32_t>(resources.size());
+    header.resourcesOffset = offset;
+    offset = alignUp(offset + sizeof(SnapshotResource) * resources.size());
+    header.relocationCount = relocations.size();
+    header.relocationsOffset = offset;
+    offset = alignUp(offset + sizeof(uint64_t) * relocations.size());
+
+    for (auto& pending : resources){
+        pending.resource.pathOffset = offset;
+        offset += pending.path.size();
+    }
+    size_t payloadOffset = alignUp(offset);
+
+    header.generationsOffset = payloadOffset + generations;
+    header.freeLinksOffset = payloadOffset + freeLinks;
+    header.fileSize = payloadOffset + payload.size();
+
+    std::vector<uint8_t> file(header.fileSize, 0);
+    memcpy(file.data(), &header, sizeof(header));
+    for (size_t i = 0; i < blocks.size(); i++){
+        SnapshotBlock block = blocks[i].block;
+        block.ownersOffset = payloadOffset + blocks[i].owners;
+        block.dataOffset = payloadOffset + blocks[i].data;
+        memcpy(file.data() + header.blocksOffset + i * sizeof(SnapshotBlock), &block, sizeof(block));
+    }
+    for (size_t i = 0; i < resources.size(); i++){
+        memcpy(file.data() + header.resourcesOffset + i * sizeof(SnapshotResource), &resources[i].resource, sizeof(SnapshotResource));
+        memcpy(file.data() + resources[i].resource.pathOffset, resources[i].path.data(), resources[i].path.size());
+    }
+    for (size_t i = 0; i < relocations.size(); i++){
+        uint64_t relocation = payloadOffset + relocations[i];
+        memcpy(file.data() + header.relocationsOffset + i * sizeof(uint64_t), &relocation, sizeof(relocation));
+    }
+    if (!payload.empty()){
+        memcpy(file.data() + payloadOffset, payload.data(), payload.size());
+    }
+
+    std::ofstream output{path, std::ios::binary};
+    if (!output){
+        throw std::runtime_error("Failed to open " + path);
+    }
+    output.write(reinterpret_cast<const char*>(file.data()), file.size());
+
+    std::cout << "World snapshot written: " << blocks.size() << " blocks, " << resources.size()
+              << " resources, " << header.fileSize / 1024 << " KB" << std::endl;
+}
+
+WorldSnapshot::WorldSnapshot(const std::string& path){
+#ifdef SNAPSHOT_MMAP
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0){
+        throw std::runtime_error("Failed to open " + path);
+    }
+    struct stat status;
+    if (fstat(file, &status) == 0 && status.st_size > 0){
+        size = static_cast<size_t>(status.st_size);
+        // private mapping: relocation writes only touch copied pages
+        void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if (memory != MAP_FAILED){
+            base = static_cast<uint8_t*>(memory);
+            mapped = true;
+        }
+    }
+    close(file);
+#endif
+
+    if (!mapped){
+        std::ifstream file{path, std::ios::ate | std::ios::binary};
+        if (!file){
+            throw std::runtime_error("Failed to open " + path);
+        }
+        fallback.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(fallback.data()), fallback.size());
+        base = fallback.data();
+        size = fallback.size();
+    }
+
+    if (size < sizeof(SnapshotHeader) || header().magic != SNAPSHOT_MAGIC){
+        throw std::runtime_error("Not a world snapshot: " + path);
+    }
+    if (header().version != SNAPSHOT_VERSION){
+        throw std::runtime_error("Unsupported world snapshot version");
+    }
+    if (header().fileSize != size){
+        throw std::runtime_error("World snapshot is truncated");
+    }
+    validate(header().blocksOffset, sizeof(SnapshotBlock) * uint64_t(header().blockCount));
+    validate(header().resourcesOffset, sizeof(SnapshotResource) * uint64_t(header().resourceCount));
+    validate(header().relocationsOffset, sizeof(uint64_t) * header().relocationCount);
+    validate(header().generationsOffset, sizeof(uint32_t) * uint64_t(header().creatureSlots));
+    validate(header().freeLinksOffset, sizeof(uint32_t) * uint64_t(header().creatureSlots));
+}
+
+WorldSnapshot::~WorldSnapshot(){
+#ifdef SNAPSHOT_MMAP
+    if (mapped){
+        munmap(base, size);
+    }
+#endif
+}
+
+void WorldSnapshot::validate(uint64_t offset, uint64_t bytes) const {
+    if (offset > size || bytes > size - offset){
+        throw std::runtime_error("World snapshot is corrupted");
+    }
+}
+
+void WorldSnapshot::resolve(const SnapshotResolver& resolver){
+    if (resolved){
+        return;
+    }
+
+    const auto* resources = reinterpret_cast<const SnapshotResource*>(base + header().resourcesOffset);
+    std::vector<void*> objects(header().resourceCount);
+    for (uint32_t i = 0; i < header().resourceCount; i++){
+        validate(resources[i].pathOffset, resources[i].pathLength);
+        std::string path{reinterpret_cast<const char*>(base + resources[i].pathOffset), resources[i].pathLength};
+        objects[i] = resolver(resources[i].type, path, resources[i].hash);
+    }
+
+    // Part data ranges, relocations may only patch fields inside them
+    std::vector<std::pair<uint64_t, uint64_t>> partRanges{};
+    for (uint32_t i = 0; i < header().blockCount; i++){
+        const SnapshotBlock& block = reinterpret_cast<const SnapshotBlock*>(base + header().blocksOffset)[i];
+        validate(block.ownersOffset, sizeof(Creature) * block.count);
+        validate(block.dataOffset, uint64_t(block.elementSize) * block.count);
+        partRanges.push_back({block.dataOffset, block.dataOffset + uint64_t(block.elementSize) * block.count});
+    }
+    std::sort(partRanges.begin(), partRanges.end());
+
+    // single fixup pass: index -> pointer
+    const auto* relocations = reinterpret_cast<const uint64_t*>(base + header().relocationsOffset);
+    for (uint64_t i = 0; i < header().relocationCount; i++){
+        validate(relocations[i], sizeof(uint64_t));
+        auto range = std::upper_bound(partRanges.begin(), partRanges.end(), std::pair<uint64_t, uint64_t>{relocations[i], std::numeric_limits<uint64_t>::max()});
+        if (range == partRanges.begin() || relocations[i] + sizeof(uint64_t) > std::prev(range)->second){
+            throw std::runtime_error("World snapshot relocation outside Part data");
+        }
+        uint8_t* field = base + relocations[i];
+        uint64_t index;
+        memcpy(&index, field, sizeof(index));
+        void* object = index < objects.size() ? objects[index] : nullptr;
+        memcpy(field, &object, sizeof(object));
+    }
+
+    resolved = true;
+}
+
+void WorldSnapshot::creatures(CreatureRegistry<>& registry) const {
+    // registry trusts its arrays: free list must stay inside slots and end, generations must fit handles
+    constexpr uint32_t END = std::numeric_limits<uint32_t>::max();
+    uint32_t slots = header().creatureSlots;
+    if (slots == 0 || slots - 1 > Creature::maxIndex || header().creatureAlive > slots){
+        throw std::runtime_error("World snapshot has invalid creature slots");
+    }
+    const auto* generations = reinterpret_cast<const uint32_t*>(base + header().generationsOffset);
+    const auto* freeLinks = reinterpret_cast<const uint32_t*>(base + header().freeLinksOffset);
+    for (uint32_t i = 0; i < slots; i++){
+        if (generations[i] > Creature::generationMask || (freeLinks[i] != END && freeLinks[i] >= slots)){
+            throw std::runtime_error("World snapshot has invalid creature slots");
+        }
+    }
+    uint32_t steps = 0;
+    for (uint32_t index = header().creatureFreeHead; index != END; index = freeLinks[index]){
+        if (index >= slots || ++steps > slots){
+            throw std::runtime_error("World snapshot has invalid creature free list");
+        }
+    }
+
+    registry.restore(reinterpret_cast<const uint32_t*>(base + header().generationsOffset),
+                     reinterpret_cast<const uint32_t*>(base + header().freeLinksOffset),
+                     header().creatureSlots, header().creatureFreeHead, header().creatureAlive);
+}
+
+const SnapshotBlock* WorldSnapshot::findBlock(uint32_t type) const {
+    const auto* blocks = reinterpret_cast<const SnapshotBlock*>(base + header().blocksOffset);
+    for (uint32_t i = 0; i < header().blockCount; i++){
+        if (blocks[i].type == type){
+            validate(blocks[i].ownersOffset, sizeof(Creature) * blocks[i].count);
+            validate(blocks[i].dataOffset, uint64_t(blocks[i].elementSize) * blocks[i].count);
+            return &blocks[i];
+        }
+    }
+    return nullptr;
+}
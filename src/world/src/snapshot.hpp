@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <cstring>
+#include <stdexcept>
+#include <Creature.hpp>
+#include <SparseSet.hpp>
+
+// World snapshot file (.bworld):
+//   SnapshotHeader
+//   SnapshotBlock[blockCount]          one per Part type
+//   SnapshotResource[resourceCount]    content hashed assets referenced by Parts
+//   uint64_t relocations[count]        file offsets of 8 byte resource fields
+//   strings                            resource paths
+//   payload                            creature slots, then per block: owners[], parts[]
+// Part data is stored exactly as in memory. Pointer fields to shared assets are written
+// as resource table indices and patched to pointers in one pass over relocations on load.
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x444C5742; // "BWLD"
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint64_t SNAPSHOT_NULL_RESOURCE = ~0ull;
+
+static_assert(sizeof(void*) == 8, "Snapshot relocations patch 64-bit pointers");
+
+enum class SnapshotResourceType : uint32_t {
+    SHADER_VERTEX,
+    SHADER_FRAGMENT,
+    SHADER_COMPUTE,
+    MESH,
+    CUSTOM
+};
+
+struct SnapshotHeader {
+    uint32_t magic = SNAPSHOT_MAGIC;
+    uint32_t version = SNAPSHOT_VERSION;
+    uint32_t blockCount = 0;
+    uint32_t resourceCount = 0;
+    uint64_t relocationCount = 0;
+    uint64_t blocksOffset = 0;
+    uint64_t resourcesOffset = 0;
+    uint64_t relocationsOffset = 0;
+    uint64_t fileSize = 0;
+
+    // creature registry
+    uint32_t creatureSlots = 0;
+    uint32_t creatureFreeHead = 0;
+    uint32_t creatureAlive = 0;
+    uint32_t reserved = 0;
+    uint64_t generationsOffset = 0;   // uint32_t[creatureSlots]
+    uint64_t freeLinksOffset = 0;     // uint32_t[creatureSlots]
+};
+
+struct SnapshotBlock {
+    uint32_t type = 0;                // user chosen Part type id
+    uint32_t elementSize = 0;         // sizeof(Part), checked on load
+    uint64_t count = 0;
+    uint64_t ownersOffset = 0;        // Creature[count]
+    uint64_t dataOffset = 0;          // Part[count]
+};
+
+struct SnapshotResource {
+    uint64_t hash = 0;                // content hash of file
+    SnapshotResourceType type = SnapshotResourceType::CUSTOM;
+    uint32_t pathLength = 0;
+    uint64_t pathOffset = 0;
+};
+
+static_assert(std::is_trivially_copyable<Creature>::value, "Creature must be stored raw");
+
+class SnapshotWriter {
+private:
+    struct PendingBlock {
+        SnapshotBlock block;
+        size_t owners;                // offsets in payload
+        size_t data;
+    };
+
+    struct PendingResource {
+        SnapshotResource resource;
+        std::string path;
+    };
+
+    std::vector<uint8_t> payload{};
+    std::vector<PendingBlock> blocks{};
+    std::vector<PendingResource> resources{};
+    std::vector<uint64_t> relocations{};  // payload offsets
+    std::unordered_map<const void*, uint64_t> resourceByObject{};
+    std::unordered_map<uint64_t, uint64_t> resourceByHash{};
+    SnapshotHeader header{};
+    size_t generations = 0;
+    size_t freeLinks = 0;
+
+    size_t append(const void* data, size_t size);
+
+public:
+    // Asset object that Parts point to. Identified by content hash of file at path.
+    void resource(const void* object, SnapshotResourceType type, const std::string& path);
+
+    void creatures(const CreatureRegistry<>& registry);
+
+    // resourceFields: offsetof() of pointer fields that point to registered resources
+    template<typename T>
+    void parts(uint32_t type, const SparseSet<T>& set, std::initializer_list<size_t> resourceFields = {}){
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot Parts are stored as raw memory");
+
+        PendingBlock pending{};
+        pending.block.type = type;
+        pending.block.elementSize = sizeof(T);
+        pending.block.count = set.size();
+        pending.owners = append(set.owners(), sizeof(Creature) * set.size());
+        pending.data = append(set.begin() == set.end() ? nullptr : &*set.begin(), sizeof(T) * set.size());
+
+        for (size_t i = 0; i < set.size(); i++){
+            for (size_t field : resourceFields){
+                size_t offset = pending.data + i * sizeof(T) + field;
+                const void* object;
+                memcpy(&object, payload.data() + offset, sizeof(object));
+
+                uint64_t index = SNAPSHOT_NULL_RESOURCE;
+                if (object != nullptr){
+                    auto it = resourceByObject.find(object);
+                    if (it == resourceByObject.end()){
+                        throw std::runtime_error("Snapshot Part points to unregistered resource");
+                    }
+                    index = it->second;
+                }
+                memcpy(payload.data() + offset, &index, sizeof(index));
+                relocations.push_back(offset);
+            }
+        }
+        blocks.push_back(pending);
+    }
+
+    void write(const std::string& path);
+};
+
+// Creates (or finds) object for resource, called once per resource entry
+using SnapshotResolver = std::function<void*(SnapshotResourceType type, const std::string& path, uint64_t hash)>;
+
+// Memory mapped snapshot. resolve() patches resource fields, then Parts are copied
+// out in bulk with creatures() / parts().
+class WorldSnapshot {
+private:
+    uint8_t* base = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<uint8_t> fallback{};  // platforms without mmap
+    bool resolved = false;
+
+    const SnapshotHeader& header() const { return *reinterpret_cast<const SnapshotHeader*>(base); }
+    const SnapshotBlock* findBlock(uint32_t type) const;
+    void validate(uint64_t offset, uint64_t bytes) const;
+
+public:
+    explicit WorldSnapshot(const std::string& path);
+    ~WorldSnapshot();
+    WorldSnapshot(const WorldSnapshot&) = delete;
+    WorldSnapshot& operator=(const WorldSnapshot&) = delete;
+
+    // Resolves resource table, then one pass over relocations
+    void resolve(const SnapshotResolver& resolver);
+
+    void creatures(CreatureRegistry<>& registry) const;
+
+    template<typename T>
+    bool parts(uint32_t type, SparseSet<T>& set) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot Parts are stored as raw memory");
+        const SnapshotBlock* block = findBlock(type);
+        if (block == nullptr){
+            return false;
+        }
+        if (block->elementSize != sizeof(T)){
+            throw std::runtime_error("Snapshot Part size does not match");
+        }
+        if (!resolved && header().relocationCount > 0){
+            throw std::runtime_error("Snapshot resources are not resolved");
+        }
+        set.assign(reinterpret_cast<const Creature*>(base + block->ownersOffset),
+                   reinterpret_cast<const T*>(base + block->dataOffset), block->count);
+        return true;
+    }
+
+    uint32_t resourceCount() const { return header().resourceCount; }
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+
+// Minimal test harness for bottle_tests (run by ctest). A failed CHECK throws, the runner
+// reports it and continues with the next test.
+
+using TestFunction = std::function<void()>;
+
+struct TestCase {
+    std::string name;
+    TestFunction function;
+};
+
+std::vector<TestCase>& testRegistry();
+
+struct TestRegistration {
+    TestRegistration(const char* name, TestFunction function){
+        testRegistry().push_back({name, function});
+    }
+};
+
+#define BOTTLE_TEST(name) \
+    static void test_##name(); \
+    static TestRegistration registration_##name{#name, test_##name}; \
+    static void test_##name()
+
+#define BOTTLE_STRINGIFY_DETAIL(x) #x
+#define BOTTLE_STRINGIFY(x) BOTTLE_STRINGIFY_DETAIL(x)
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)){ \
+            throw std::runtime_error(__FILE__ ":" BOTTLE_STRINGIFY(__LINE__) ": CHECK(" #condition ") failed"); \
+        } \
+    } while (false)
@@ -0,0 +1,64 @@
+#include "test.hpp"
+#include "../src/ecs/SparseSet.hpp"
+
+struct TestPart {
+    float value;
+};
+
+// Creatures destroyed without removing their Part, handles recycled and added again:
+// new generation must take over old slot instead of leaving an orphan behind
+BOTTLE_TEST(sparse_set_recycled_creature_reuses_slot){
+    CreatureRegistry<> creatures{};
+    SparseSet<TestPart> parts{};
+    std::vector<Creature> handles{};
+    for (int i = 0; i < 100; i++){
+        handles.push_back(creatures.create());
+        parts.add(handles.back(), TestPart{static_cast<float>(i)});
+    }
+
+    for (int round = 0; round < 3; round++){
+        for (Creature& creature : handles){
+            creatures.destroy(creature);
+            creature = creatures.create();
+            parts.add(creature, TestPart{1.0f});
+        }
+        CHECK(parts.size() == handles.size());
+    }
+
+    for (Creature creature : handles){
+        CHECK(parts.contains(creature));
+        parts.remove(creature);
+    }
+    CHECK(parts.empty());
+}
+
+// Part owning a resource: creature destroyed and slot handed out again before Part is removed
+BOTTLE_TEST(sparse_set_displaced_part_released_on_recreate){
+    CreatureRegistry<> creatures{};
+    SparseSet<TestPart> parts{};
+    uint32_t released = 0;
+
+    Creature first = creatures.create();
+    parts.add(first, TestPart{1.0f});
+    creatures.destroy(first);
+    Creature second = creatures.create();
+    CHECK(second.index() == first.index());
+    CHECK(parts.get(second) == nullptr);
+
+    TestPart* old = parts.displaced(second);
+    CHECK(old != nullptr && old->value == 1.0f);
+    released++;
+    parts.add(second, TestPart{2.0f});
+    CHECK(parts.size() == 1);
+    CHECK(parts.get(second)->value == 2.0f);
+    CHECK(!parts.contains(first));
+
+    // sweep releases Parts of creatures destroyed since
+    creatures.destroy(second);
+    Creature third = creatures.create();
+    CHECK(third.index() == first.index());
+    uint32_t removed = parts.removeDead(creatures, [&](TestPart&){ released++; });
+    CHECK(removed == 1 && released == 2);
+    CHECK(parts.empty());
+    CHECK(parts.displaced(third) == nullptr);
+}
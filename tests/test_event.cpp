@@ -0,0 +1,29 @@
+#include "test.hpp"
+#include "../src/event/eventBehavior.hpp"
+
+// Subscribers enqueue follow-up events into same and other bands; all of them wait for next dispatch
+BOTTLE_TEST(event_enqueue_during_dispatch_is_deferred){
+    EventBehaviour events{};
+    events.register_event("input", EventCoalesce::NONE, EventPriority::HIGH);
+    events.register_event("follow_up", EventCoalesce::NONE, EventPriority::LOW);
+    events.register_event("echo", EventCoalesce::NONE, EventPriority::HIGH);
+
+    const EventTrigger input = "input";
+    const EventTrigger followUp = "follow_up";
+    const EventTrigger echo = "echo";
+    uint32_t followUps = 0;
+    uint32_t echoes = 0;
+    events.subscribe(input, [&events, &followUp, &echo]{
+        events.enqueue(followUp);
+        events.enqueue(echo);
+    });
+    events.subscribe(followUp, [&followUps]{ followUps++; });
+    events.subscribe(echo, [&echoes]{ echoes++; });
+
+    events.enqueue(input);
+    events.dispatch();
+    CHECK(followUps == 0 && echoes == 0);
+
+    events.dispatch();
+    CHECK(followUps == 1 && echoes == 1);
+}
@@ -0,0 +1,43 @@
+#include "test.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+std::vector<TestCase>& testRegistry(){
+    static std::vector<TestCase> registry{};
+    return registry;
+}
+
+int main(int argc, char** argv){
+    std::string filter{};
+    for (int i = 1; i < argc; i++){
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc){
+            filter = argv[++i];
+        } else {
+            std::cout << "usage: bottle_tests [--filter text]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<TestCase> cases = testRegistry();
+    std::sort(cases.begin(), cases.end(), [](const TestCase& a, const TestCase& b){ return a.name < b.name; });
+
+    uint32_t run = 0;
+    uint32_t failed = 0;
+    for (const TestCase& test : cases){
+        if (!filter.empty() && test.name.find(filter) == std::string::npos){
+            continue;
+        }
+        run++;
+        try {
+            test.function();
+            std::cout << test.name << ": ok" << std::endl;
+        } catch (std::exception& e) {
+            failed++;
+            std::cout << test.name << ": FAILED (" << e.what() << ")" << std::endl;
+        }
+    }
+
+    std::cout << run - failed << " of " << run << " tests passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include "test.hpp"
+#include "../src/world/src/snapshot.hpp"
+#include <cstdio>
+#include <cstddef>
+#include <fstream>
+
+struct TestAsset {
+    uint32_t id;
+};
+
+struct TestMeshPart {
+    float position[3];
+    const TestAsset* mesh;
+};
+
+static const char* testAssetPath = "test_snapshot_asset.bin";
+static const char* testWorldPath = "test_snapshot.bworld";
+
+static void writeTestWorld(){
+    {
+        std::ofstream asset{testAssetPath, std::ios::binary};
+        asset << "mesh data";
+    }
+    static TestAsset asset{1};
+    CreatureRegistry<> creatures{};
+    SparseSet<TestMeshPart> parts{};
+    for (uint32_t i = 0; i < 16; i++){
+        parts.add(creatures.create(), TestMeshPart{{float(i), 0.0f, 0.0f}, &asset});
+    }
+    creatures.destroy(parts.owners()[3]);
+
+    SnapshotWriter writer{};
+    writer.resource(&asset, SnapshotResourceType::CUSTOM, testAssetPath);
+    writer.creatures(creatures);
+    writer.parts(1, parts, {offsetof(TestMeshPart, mesh)});
+    writer.write(testWorldPath);
+}
+
+static SnapshotHeader readTestHeader(){
+    SnapshotHeader header{};
+    std::ifstream file{testWorldPath, std::ios::binary};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return header;
+}
+
+// overwrites bytes of written world file in place
+static void patchTestWorld(uint64_t offset, const void* data, size_t size){
+    std::fstream file{testWorldPath, std::ios::binary | std::ios::in | std::ios::out};
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+static void removeTestWorld(){
+    std::remove(testWorldPath);
+    std::remove(testAssetPath);
+}
+
+static bool throwsOnLoad(){
+    TestAsset loaded{0};
+    try {
+        WorldSnapshot snapshot{testWorldPath};
+        snapshot.resolve([&](SnapshotResourceType, const std::string&, uint64_t){ return static_cast<void*>(&loaded); });
+        CreatureRegistry<> creatures{};
+        snapshot.creatures(creatures);
+    } catch (std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+BOTTLE_TEST(world_snapshot_loads_valid_file){
+    writeTestWorld();
+    bool threw = throwsOnLoad();
+    removeTestWorld();
+    CHECK(!threw);
+}
+
+BOTTLE_TEST(world_snapshot_rejects_free_head_out_of_range){
+    writeTestWorld();
+    uint32_t head = readTestHeader().creatureSlots + 100;
+    patchTestWorld(offsetof(SnapshotHeader, creatureFreeHead), &head, sizeof(head));
+    bool threw = throwsOnLoad();
+    removeTestWorld();
+    CHECK(threw);
+}
+
+BOTTLE_TEST(world_snapshot_rejects_free_list_cycle){
+    writeTestWorld();
+    SnapshotHeader header = readTestHeader();
+    // destroyed slot links to itself
+    uint32_t head = header.creatureFreeHead;
+    patchTestWorld(header.freeLinksOffset + sizeof(uint32_t) * head, &head, sizeof(head));
+    bool threw = throwsOnLoad();
+    removeTestWorld();
+    CHECK(threw);
+}
+
+BOTTLE_TEST(world_snapshot_rejects_relocation_outside_parts){
+    writeTestWorld();
+    SnapshotHeader header = readTestHeader();
+    SnapshotBlock block{};
+    {
+        std::ifstream file{testWorldPath, std::ios::binary};
+        file.seekg(static_cast<std::streamoff>(header.blocksOffset));
+        file.read(reinterpret_cast<char*>(&block), sizeof(block));
+    }
+    // point first relocation at creature handles of block instead of a Part field
+    uint64_t offset = block.ownersOffset;
+    patchTestWorld(header.relocationsOffset, &offset, sizeof(offset));
+    bool threw = throwsOnLoad();
+    removeTestWorld();
+    CHECK(threw);
+}
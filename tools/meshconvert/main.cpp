@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <tuple>
+#include <stdexcept>
+#include "../../src/graphics/src/mesh/meshconvert.hpp"
+#include "../../src/graphics/src/mesh/meshoptimizer.hpp"
+
+// Offline converter: OBJ -> .bmesh
+// usage: meshconvert input.obj output.bmesh [--lods count] [--lod-error fraction]
+
+using ObjVertex = std::tuple<int, int, int>; // position, uv, normal (0 = absent)
+
+// OBJ indices are 1-based, negative ones count back from last element read so far.
+// 0 is only allowed for optional uv / normal, meaning absent.
+static int resolveIndex(int index, size_t count, bool required){
+    if (index == 0 && !required){
+        return 0;
+    }
+    int resolved = index < 0 ? static_cast<int>(count) + index + 1 : index;
+    if (resolved < 1 || static_cast<size_t>(resolved) > count){
+        throw std::runtime_error("Face index out of range: " + std::to_string(index));
+    }
+    return resolved;
+}
+
+static MeshSource loadObj(const std::string& path){
+    std::ifstream file{path};
+    if (!file){
+        throw std::runtime_error("File not found: " + path);
+    }
+
+    std::vector<float> positions, uvs, normals;
+    std::map<ObjVertex, uint32_t> vertices;
+    MeshSource source{};
+
+    std::string line;
+    while (std::getline(file, line)){
+        std::istringstream stream{line};
+        std::string type;
+        stream >> type;
+
+        if (type == "v"){
+            float x, y, z;
+            stream >> x >> y >> z;
+            positions.insert(positions.end(), {x, y, z});
+        } else if (type == "vt"){
+            float u, v;
+            stream >> u >> v;
+            uvs.insert(uvs.end(), {u, 1.0f - v}); // Vulkan has origin at top left
+        } else if (type == "vn"){
+            float x, y, z;
+            stream >> x >> y >> z;
+            normals.insert(normals.end(), {x, y, z});
+        } else if (type == "f"){
+            std::vector<uint32_t> face;
+            std::string token;
+            while (stream >> token){
+                int p = 0, t = 0, n = 0;
+                if (sscanf(token.c_str(), "%d/%d/%d", &p, &t, &n) != 3 &&
+                    sscanf(token.c_str(), "%d//%d", &p, &n) != 2 &&
+                    sscanf(token.c_str(), "%d/%d", &p, &t) != 2){
+                    sscanf(token.c_str(), "%d", &p);
+                }
+                ObjVertex key{resolveIndex(p, positions.size() / 3, true), resolveIndex(t, uvs.size() / 2, false), resolveIndex(n, normals.size() / 3, false)};
+
+                auto it = vertices.find(key);
+                if (it == vertices.end()){
+                    uint32_t index = static_cast<uint32_t>(source.positions.size() / 3);
+                    auto [pi, ti, ni] = key;
+                    source.positions.insert(source.positions.end(), &positions[(pi - 1) * 3], &positions[(pi - 1) * 3] + 3);
+                    if (ti > 0){
+                        source.uvs.insert(source.uvs.end(), &uvs[(ti - 1) * 2], &uvs[(ti - 1) * 2] + 2);
+                    } else {
+                        source.uvs.insert(source.uvs.end(), {0.0f, 0.0f});
+                    }
+                    if (ni > 0){
+                        source.normals.insert(source.normals.end(), &normals[(ni - 1) * 3], &normals[(ni - 1) * 3] + 3);
+                    } else {
+                        source.normals.insert(source.normals.end(), {0.0f, 0.0f, 1.0f});
+                    }
+                    it = vertices.emplace(key, index).first;
+                }
+                face.push_back(it->second);
+            }
+
+            // triangle fan for polygons
+            for (size_t i = 2; i < face.size(); i++){
+                source.indices.insert(source.indices.end(), {face[0], face[i - 1], face[i]});
+            }
+        }
+    }
+
+    return source;
+}
+
+static void printUsage(){
+    std::cerr << "usage: meshconvert input.obj output.bmesh [--lods count] [--lod-error fraction]" << std::endl;
+}
+
+// Whole argument must be a number, stoul / stof would accept trailing garbage and throw on bad input
+template<typename T>
+static bool parseNumber(const char* text, T& value){
+    const char* end = text + std::strlen(text);
+    auto [ptr, error] = std::from_chars(text, end, value);
+    return error == std::errc{} && ptr == end;
+}
+
+int main(int argc, char** argv){
+    if (argc < 3){
+        printUsage();
+        return 1;
+    }
+
+    MeshLodOptions options{};
+    for (int i = 3; i < argc; i += 2){
+        std::string option = argv[i];
+        if (i + 1 >= argc){
+            std::cerr << "Missing value for " << option << std::endl;
+            printUsage();
+            return 1;
+        }
+        if (option == "--lods"){
+            if (!parseNumber(argv[i + 1], options.levels) || options.levels == 0 || options.levels > MESH_MAX_LODS){
+                std::cerr << "--lods must be between 1 and " << MESH_MAX_LODS << std::endl;
+                printUsage();
+                return 1;
+            }
+        } else if (option == "--lod-error"){
+            if (!parseNumber(argv[i + 1], options.maxError) || !(options.maxError >= 0.0f)){
+                std::cerr << "--lod-error must be a non-negative number" << std::endl;
+                printUsage();
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    try {
+        MeshSource source = loadObj(argv[1]);
+        size_t vertexCount = source.positions.size() / 3;
+        float acmrBefore = analyzeVertexCache(source.indices, vertexCount);
+
+        MeshData mesh = convertMesh(source, options);
+        writeMeshFile(argv[2], mesh);
+
+        std::cout << "Converted " << argv[1] << " -> " << argv[2] << std::endl;
+        std::cout << "\tVertices: " << mesh.header.vertexCount << std::endl;
+        std::cout << "\tTriangles: " << (mesh.lods.empty() ? mesh.header.indexCount : mesh.lods[0].indexCount) / 3 << std::endl;
+        std::cout << "\tIndex size: " << mesh.header.indexSize << " bytes" << std::endl;
+        std::cout << "\tVertex data: " << mesh.vertices.size() * sizeof(PackedVertex) << " bytes (float layout: " << vertexCount * 32 << " bytes)" << std::endl;
+        std::cout << "\tACMR: " << acmrBefore << " -> " << analyzeVertexCache(mesh.indices, vertexCount) << std::endl;
+        for (size_t level = 0; level < mesh.lods.size(); level++){
+            std::cout << "\tLOD " << level << ": " << mesh.lods[level].indexCount / 3 << " triangles, error " << mesh.lods[level].error << std::endl;
+        }
+    } catch (std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}